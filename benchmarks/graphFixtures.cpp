@@ -0,0 +1,217 @@
+/*****************************************************************//**
+ * @file   graphFixtures.cpp
+ * @brief  The synthetic graph function definitions used by the i2Benchmark suite
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "graphFixtures.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+namespace I2Benchmark
+{
+	namespace
+	{
+		constexpr std::size_t linksPerNode = 4; // Each link touches two nodes, so the average degree is 8
+		constexpr unsigned int maxWeight = 10;
+		constexpr std::uint64_t seed = 0x12C0FFEE; // Fixed, so results are comparable between runs and machines
+
+		/**
+		 * @brief Generates links between nodes chosen uniformly at random, discarding self-links and repeated links.
+		 */
+		EdgeList generateUniform(std::size_t linkCount, std::mt19937_64 &random)
+		{
+			EdgeList edgeList;
+
+			edgeList.nodeCount = std::max<std::size_t>(linkCount / linksPerNode, 2);
+
+			std::uniform_int_distribution<I2::NodeId> node(0, static_cast<I2::NodeId>(edgeList.nodeCount - 1));
+			std::uniform_int_distribution<unsigned int> weight(1, maxWeight);
+
+			// Draw in rounds: sort and de-duplicate, then top up whatever was discarded (far cheaper than a hash set at 10^7 links)
+			while(edgeList.link.size() < linkCount)
+			{
+				for(std::size_t i=edgeList.link.size();i<linkCount;++i)
+				{
+					const I2::NodeId source = node(random), target = node(random);
+
+					if(source != target)
+						edgeList.link.push_back(EdgeList::Link{std::min(source, target), std::max(source, target), weight(random)});
+				}
+
+				std::sort(edgeList.link.begin(), edgeList.link.end(), [](const EdgeList::Link &a, const EdgeList::Link &b) { return std::pair(a.source, a.target) < std::pair(b.source, b.target); });
+				edgeList.link.erase(std::unique(edgeList.link.begin(), edgeList.link.end(), [](const EdgeList::Link &a, const EdgeList::Link &b) { return a.source == b.source && a.target == b.target; }), edgeList.link.end());
+			}
+
+			std::shuffle(edgeList.link.begin(), edgeList.link.end(), random); // Input order should not favour the loaders
+
+			return edgeList;
+		}
+
+		/**
+		 * @brief Generates links by preferential attachment: each new node links to linksPerNode distinct existing nodes, chosen in proportion to their degree.
+		 */
+		EdgeList generateScaleFree(std::size_t linkCount, std::mt19937_64 &random)
+		{
+			std::uniform_int_distribution<unsigned int> weight(1, maxWeight);
+			std::vector<I2::NodeId> endpoint; // Every link end so far: picking uniformly from it picks a node in proportion to its degree
+			std::vector<I2::NodeId> chosen;
+			EdgeList edgeList;
+
+			edgeList.link.reserve(linkCount);
+			endpoint.reserve(linkCount * 2);
+
+			// Start from a small clique, so the first new node has enough distinct nodes to link to
+			for(I2::NodeId source=0;source<=linksPerNode && edgeList.link.size()<linkCount;++source)
+			{
+				for(I2::NodeId target=source + 1;target<=linksPerNode && edgeList.link.size()<linkCount;++target)
+				{
+					edgeList.link.push_back(EdgeList::Link{source, target, weight(random)});
+					endpoint.push_back(source);
+					endpoint.push_back(target);
+				}
+			}
+
+			edgeList.nodeCount = linksPerNode + 1;
+
+			while(edgeList.link.size() < linkCount)
+			{
+				const I2::NodeId source = static_cast<I2::NodeId>(edgeList.nodeCount++);
+				const std::size_t existingEndpoints = endpoint.size();
+
+				chosen.clear();
+
+				while(chosen.size() < linksPerNode && edgeList.link.size() + chosen.size() < linkCount)
+				{
+					const I2::NodeId target = endpoint[std::uniform_int_distribution<std::size_t>(0, existingEndpoints - 1)(random)];
+
+					if(std::find(chosen.cbegin(), chosen.cend(), target) == chosen.cend())
+						chosen.push_back(target);
+				}
+
+				for(const I2::NodeId target : chosen)
+				{
+					edgeList.link.push_back(EdgeList::Link{source, target, weight(random)});
+					endpoint.push_back(source);
+					endpoint.push_back(target);
+				}
+			}
+
+			std::shuffle(edgeList.link.begin(), edgeList.link.end(), random);
+
+			return edgeList;
+		}
+	}
+
+	const EdgeList &getEdgeList(Distribution distribution, std::size_t linkCount)
+	{
+		static std::map<std::pair<Distribution, std::size_t>, EdgeList> cache; // Benchmarks run one at a time, so no locking is needed
+
+		auto itCache = cache.find(std::pair(distribution, linkCount));
+
+		if(itCache == cache.end())
+		{
+			std::mt19937_64 random(seed ^ linkCount);
+
+			itCache = cache.emplace(std::pair(distribution, linkCount), distribution == Distribution::Uniform ? generateUniform(linkCount, random) : generateScaleFree(linkCount, random)).first;
+		}
+
+		return itCache->second;
+	}
+
+	Json::Value toJSON(const EdgeList &edgeList)
+	{
+		Json::Value data(Json::objectValue), &nodes = data["nodes"] = Json::Value(Json::arrayValue), &links = data["links"] = Json::Value(Json::arrayValue);
+
+		for(std::size_t i=0;i<edgeList.nodeCount;++i)
+		{
+			Json::Value node(Json::objectValue);
+
+			node["name"] = "Node" + std::to_string(i);
+			nodes.append(std::move(node));
+		}
+
+		for(const EdgeList::Link &l : edgeList.link)
+		{
+			Json::Value link(Json::objectValue);
+
+			link["source"] = l.source;
+			link["target"] = l.target;
+			link["value"] = l.weight;
+			links.append(std::move(link));
+		}
+
+		return data;
+	}
+
+	std::string toJSONText(const EdgeList &edgeList)
+	{
+		std::string text = "{\"nodes\":[";
+
+		text.reserve(edgeList.nodeCount * 24 + edgeList.link.size() * 48);
+
+		for(std::size_t i=0;i<edgeList.nodeCount;++i)
+			text += (i ? ",{\"name\":\"Node" : "{\"name\":\"Node") + std::to_string(i) + "\"}";
+
+		text += "],\"links\":[";
+
+		for(std::size_t i=0,linkCount=edgeList.link.size();i<linkCount;++i)
+		{
+			text += (i ? ",{\"source\":" : "{\"source\":") + std::to_string(edgeList.link[i].source) + ",\"target\":" + std::to_string(edgeList.link[i].target)
+				+ ",\"value\":" + std::to_string(edgeList.link[i].weight) + "}";
+		}
+
+		text += "]}";
+
+		return text;
+	}
+
+	I2::Graph toGraph(const EdgeList &edgeList)
+	{
+		I2::GraphBuilder builder;
+
+		builder.reserve(edgeList.nodeCount, edgeList.link.size());
+
+		for(std::size_t i=0;i<edgeList.nodeCount;++i)
+			builder.addNode("Node" + std::to_string(i));
+
+		for(const EdgeList::Link &link : edgeList.link)
+			builder.addLink(link.source, link.target, link.weight);
+
+		return builder.build();
+	}
+
+	std::vector<std::shared_ptr<I2::Node>> toNodes(const EdgeList &edgeList)
+	{
+		std::vector<std::shared_ptr<I2::Node>> nodeList;
+
+		nodeList.reserve(edgeList.nodeCount);
+
+		for(std::size_t i=0;i<edgeList.nodeCount;++i)
+			nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+		for(const EdgeList::Link &link : edgeList.link)
+		{
+			nodeList[link.source]->addLink(nodeList[link.target], link.weight);
+			nodeList[link.target]->addLink(nodeList[link.source], link.weight);
+		}
+
+		return nodeList;
+	}
+
+	void releaseNodes(const std::vector<std::shared_ptr<I2::Node>> &nodeList)
+	{
+		for(const std::shared_ptr<I2::Node> &node : nodeList)
+		{
+			const std::unordered_map<std::shared_ptr<I2::Node>, unsigned int> link = node->getLinks();
+
+			for(std::unordered_map<std::shared_ptr<I2::Node>,unsigned int>::const_iterator itL=link.cbegin(),endL=link.cend();itL!=endL;++itL)
+				node->removeLink(itL->first);
+		}
+	}
+}
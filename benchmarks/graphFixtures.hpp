@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * @file   graphFixtures.hpp
+ * @brief  Declarations of the synthetic graphs shared by the i2Benchmark suite
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_BENCHMARK_GRAPH_FIXTURES_HPP
+#define I2_BENCHMARK_GRAPH_FIXTURES_HPP
+
+#include <i2/graph.hpp>
+#include <json/json.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace I2Benchmark
+{
+	/**
+	 * @brief The degree distribution of a generated graph.
+	 */
+	enum class Distribution
+	{
+		Uniform, // Erdős–Rényi style: every link joins two nodes chosen uniformly at random
+		ScaleFree // Barabási–Albert style: new nodes prefer to link to well connected nodes, so a few hubs hold many links
+	};
+
+	/**
+	 * @brief A generated, undirected graph: every link is unique and no node links to itself, so it loads without warnings or errors.
+	 */
+	struct EdgeList
+	{
+		/**
+		 * @brief A link between two nodes, by index.
+		 */
+		struct Link
+		{
+			I2::NodeId source;
+			I2::NodeId target;
+			unsigned int weight;
+		};
+
+		std::size_t nodeCount = 0;
+		std::vector<Link> link;
+	};
+
+	/**
+	 * @brief Generates (on first use) a deterministic graph with an average degree of 8, so the node count is a quarter of the link count.
+	 * @param[in] distribution The degree distribution to generate
+	 * @param[in] linkCount The number of links to generate
+	 * @return The generated graph: cached, so every benchmark of the same size runs on the same data
+	 */
+	[[nodiscard]] const EdgeList &getEdgeList(Distribution distribution, std::size_t linkCount);
+
+	/**
+	 * @return The graph in the node/link JSON format read by I2::NodeLoader (see resources/data.json)
+	 */
+	[[nodiscard]] Json::Value toJSON(const EdgeList &edgeList);
+
+	/**
+	 * @return The graph as JSON text, for the streaming loader
+	 */
+	[[nodiscard]] std::string toJSONText(const EdgeList &edgeList);
+
+	/**
+	 * @return The graph built with I2::GraphBuilder
+	 */
+	[[nodiscard]] I2::Graph toGraph(const EdgeList &edgeList);
+
+	/**
+	 * @return The graph as linked Node instances: pass to releaseNodes once finished with, as linked nodes reference each other
+	 */
+	[[nodiscard]] std::vector<std::shared_ptr<I2::Node>> toNodes(const EdgeList &edgeList);
+
+	/**
+	 * @brief Removes every link of the nodes, breaking the shared_ptr cycles between linked nodes so they can be freed.
+	 * @param[in] nodeList The nodes to release
+	 */
+	void releaseNodes(const std::vector<std::shared_ptr<I2::Node>> &nodeList);
+}
+
+#endif
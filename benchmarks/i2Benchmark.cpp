@@ -0,0 +1,346 @@
+/*****************************************************************//**
+ * @file   i2Benchmark.cpp
+ * @brief  Micro and macro benchmarks of the i2 library over generated uniform and scale-free graphs
+ *
+ * Every benchmark reports its throughput (edges/s, or nodes/s for sorting) and the peak resident set size of the process so far
+ * (peakRSS, in MiB): peak RSS only grows, so run one benchmark at a time (--benchmark_filter) to attribute it to that benchmark.
+ * Graph-based benchmarks run from 10^3 to 10^7 links. Benchmarks of the Node API and of Json::Value stop at 10^6 links, as both
+ * representations need several hundred bytes per link.
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "graphFixtures.hpp"
+#include <i2/compressedGraph.hpp>
+#include <i2/graphDelta.hpp>
+#include <i2/nodeLoader.hpp>
+#include <i2/pageRank.hpp>
+#include <i2/stats.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory_resource>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+	constexpr std::int64_t minLinkCount = 1'000, maxNodeLinkCount = 1'000'000, maxGraphLinkCount = 10'000'000;
+
+	/**
+	 * @brief Reports the throughput and peak memory of a finished benchmark.
+	 * @param[in,out] state The benchmark state
+	 * @param[in] itemCount The number of items processed per iteration
+	 * @param[in] itemName The name of the throughput counter
+	 */
+	void reportCounters(benchmark::State &state, std::size_t itemCount, const char *itemName = "edges/s")
+	{
+		state.counters[itemName] = benchmark::Counter(static_cast<double>(itemCount), benchmark::Counter::kIsIterationInvariantRate);
+		state.counters["peakRSS"] = benchmark::Counter(static_cast<double>(I2::Stats::getPeakRSS()) / (1024.0 * 1024.0));
+	}
+
+	void constructNodesFromJSON(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+		const Json::Value data = I2Benchmark::toJSON(edgeList);
+
+		for(auto _ : state)
+		{
+			std::vector<std::shared_ptr<I2::Node>> nodeList = I2::NodeLoader::constructNodesFromJSON(data);
+
+			state.PauseTiming();
+			I2Benchmark::releaseNodes(nodeList);
+			nodeList.clear();
+			state.ResumeTiming();
+		}
+
+		reportCounters(state, edgeList.link.size());
+	}
+
+	/**
+	 * @brief Materialises and then tears down the Node API view of a graph with every allocation on the heap: the links must be removed
+	 * (see I2Benchmark::releaseNodes) to free the nodes, which is timed as it is part of every caller's teardown.
+	 */
+	void graphToNodes(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2::Graph graph = I2Benchmark::toGraph(I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0))));
+
+		for(auto _ : state)
+		{
+			std::vector<std::shared_ptr<I2::Node>> nodeList = graph.toNodes();
+
+			I2Benchmark::releaseNodes(nodeList);
+		}
+
+		reportCounters(state, graph.getEntryCount() / 2);
+	}
+
+	/**
+	 * @brief Materialises and then tears down the Node API view of a graph within a monotonic arena: teardown releases the arena's blocks in one go.
+	 */
+	void graphToNodesArena(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2::Graph graph = I2Benchmark::toGraph(I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0))));
+
+		for(auto _ : state)
+		{
+			std::pmr::monotonic_buffer_resource arena;
+
+			benchmark::DoNotOptimize(graph.toNodes(&arena)); // The nodes are dropped straight away: the arena frees them as it goes out of scope
+		}
+
+		reportCounters(state, graph.getEntryCount() / 2);
+	}
+
+	void constructGraphFromStream(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+		const std::string text = I2Benchmark::toJSONText(edgeList);
+
+		for(auto _ : state)
+		{
+			std::istringstream input(text);
+
+			benchmark::DoNotOptimize(I2::NodeLoader::constructGraphFromStream(input));
+		}
+
+		reportCounters(state, edgeList.link.size());
+	}
+
+	void buildGraph(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+
+		for(auto _ : state)
+			benchmark::DoNotOptimize(I2Benchmark::toGraph(edgeList));
+
+		reportCounters(state, edgeList.link.size());
+	}
+
+	void addLink(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+
+		std::vector<std::shared_ptr<I2::Node>> nodeList;
+
+		for(auto _ : state)
+		{
+			state.PauseTiming();
+			nodeList.clear();
+
+			for(std::size_t i=0;i<edgeList.nodeCount;++i)
+				nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+			state.ResumeTiming();
+
+			// Both directions, as NodeLoader links nodes
+			for(const I2Benchmark::EdgeList::Link &link : edgeList.link)
+			{
+				nodeList[link.source]->addLink(nodeList[link.target], link.weight);
+				nodeList[link.target]->addLink(nodeList[link.source], link.weight);
+			}
+
+			state.PauseTiming();
+			I2Benchmark::releaseNodes(nodeList);
+			state.ResumeTiming();
+		}
+
+		reportCounters(state, edgeList.link.size());
+	}
+
+	void addLinks(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+
+		std::vector<std::shared_ptr<I2::Node>> nodeList;
+		std::vector<std::unordered_map<std::shared_ptr<I2::Node>, unsigned int>> link;
+
+		for(auto _ : state)
+		{
+			state.PauseTiming();
+			nodeList.clear();
+			link.assign(edgeList.nodeCount, {});
+
+			for(std::size_t i=0;i<edgeList.nodeCount;++i)
+				nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+			for(const I2Benchmark::EdgeList::Link &l : edgeList.link)
+			{
+				link[l.source].emplace(nodeList[l.target], l.weight);
+				link[l.target].emplace(nodeList[l.source], l.weight);
+			}
+
+			state.ResumeTiming();
+
+			for(std::size_t i=0;i<edgeList.nodeCount;++i)
+				nodeList[i]->addLinks(std::move(link[i]));
+
+			state.PauseTiming();
+			I2Benchmark::releaseNodes(nodeList);
+			state.ResumeTiming();
+		}
+
+		reportCounters(state, edgeList.link.size());
+	}
+
+	/**
+	 * @brief Links the nodes from range(1) ingestion threads, each applying its share of the links as GraphDelta batches of deltaBatchSize links.
+	 */
+	void applyGraphDelta(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		constexpr std::size_t deltaBatchSize = 1024;
+
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+		const std::size_t threadCount = static_cast<std::size_t>(state.range(1));
+
+		std::vector<std::shared_ptr<I2::Node>> nodeList;
+		std::vector<std::thread> thread;
+
+		for(auto _ : state)
+		{
+			state.PauseTiming();
+			nodeList.clear();
+
+			for(std::size_t i=0;i<edgeList.nodeCount;++i)
+				nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+			state.ResumeTiming();
+
+			for(std::size_t t=0;t<threadCount;++t)
+			{
+				thread.emplace_back([&edgeList, &nodeList, t, threadCount]()
+				{
+					const std::size_t first = edgeList.link.size() * t / threadCount, last = edgeList.link.size() * (t + 1) / threadCount;
+
+					I2::GraphDelta delta;
+
+					delta.reserve(deltaBatchSize);
+
+					for(std::size_t l=first;l<last;++l)
+					{
+						delta.addLink(nodeList[edgeList.link[l].source], nodeList[edgeList.link[l].target], edgeList.link[l].weight);
+
+						if(delta.size() == deltaBatchSize || l + 1 == last)
+							delta.apply();
+					}
+				});
+			}
+
+			for(std::thread &t : thread)
+				t.join();
+
+			state.PauseTiming();
+			thread.clear();
+			I2Benchmark::releaseNodes(nodeList);
+			state.ResumeTiming();
+		}
+
+		reportCounters(state, edgeList.link.size());
+	}
+
+	void recalculateWeightedDegree(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+		const std::vector<std::shared_ptr<I2::Node>> nodeList = I2Benchmark::toNodes(edgeList);
+
+		for(auto _ : state)
+		{
+			for(const std::shared_ptr<I2::Node> &node : nodeList)
+				benchmark::DoNotOptimize(node->recalculateWeightedDegree());
+		}
+
+		reportCounters(state, edgeList.link.size());
+		I2Benchmark::releaseNodes(nodeList);
+	}
+
+	void sortNodes(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+		const std::vector<std::shared_ptr<I2::Node>> nodeList = I2Benchmark::toNodes(edgeList);
+
+		std::vector<std::shared_ptr<I2::Node>> sorted;
+
+		for(auto _ : state)
+		{
+			state.PauseTiming();
+			sorted = nodeList; // Sort the original (generation) order every iteration
+			state.ResumeTiming();
+
+			std::sort(sorted.begin(), sorted.end(), I2::nodeCompareGT);
+		}
+
+		reportCounters(state, nodeList.size(), "nodes/s");
+		sorted.clear();
+		I2Benchmark::releaseNodes(nodeList);
+	}
+
+	void computePageRankNodes(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2Benchmark::EdgeList &edgeList = I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)));
+		const std::vector<std::shared_ptr<I2::Node>> nodeList = I2Benchmark::toNodes(edgeList);
+
+		for(auto _ : state)
+			benchmark::DoNotOptimize(I2::NodeLoader::computePageRank(nodeList));
+
+		reportCounters(state, edgeList.link.size());
+		I2Benchmark::releaseNodes(nodeList);
+	}
+
+	void computePageRankGraph(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2::Graph graph = I2Benchmark::toGraph(I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0))));
+
+		for(auto _ : state)
+			benchmark::DoNotOptimize(I2::NodeLoader::computePageRank(graph, I2::PageRankOptions{.threadCount = static_cast<std::size_t>(state.range(1))}));
+
+		reportCounters(state, graph.getEntryCount() / 2);
+		state.counters["adjacencyMiB"] = benchmark::Counter(static_cast<double>(I2::CompressedGraph::getAdjacencyBytes(graph)) / (1024.0 * 1024.0));
+	}
+
+	/**
+	 * @brief As computePageRankGraph, but ranking the delta and varint encoded rows, for comparing the two layouts' footprint and throughput.
+	 */
+	void computePageRankCompressed(benchmark::State &state, I2Benchmark::Distribution distribution)
+	{
+		const I2::CompressedGraph graph(I2Benchmark::toGraph(I2Benchmark::getEdgeList(distribution, static_cast<std::size_t>(state.range(0)))));
+
+		for(auto _ : state)
+		{
+			I2::PageRankEngine engine(graph);
+
+			benchmark::DoNotOptimize(engine.run(I2::PageRankOptions{.threadCount = static_cast<std::size_t>(state.range(1))}));
+		}
+
+		reportCounters(state, graph.getEntryCount() / 2);
+		state.counters["adjacencyMiB"] = benchmark::Counter(static_cast<double>(graph.getAdjacencyBytes()) / (1024.0 * 1024.0));
+	}
+}
+
+// Benchmarks registered per distribution, over the link counts each representation can hold
+#define I2_BENCHMARK_NODES(function) \
+	BENCHMARK_CAPTURE(function, uniform, I2Benchmark::Distribution::Uniform)->RangeMultiplier(10)->Range(minLinkCount, maxNodeLinkCount)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_CAPTURE(function, scaleFree, I2Benchmark::Distribution::ScaleFree)->RangeMultiplier(10)->Range(minLinkCount, maxNodeLinkCount)->Unit(benchmark::kMillisecond)
+
+#define I2_BENCHMARK_GRAPH(function) \
+	BENCHMARK_CAPTURE(function, uniform, I2Benchmark::Distribution::Uniform)->RangeMultiplier(10)->Range(minLinkCount, maxGraphLinkCount)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_CAPTURE(function, scaleFree, I2Benchmark::Distribution::ScaleFree)->RangeMultiplier(10)->Range(minLinkCount, maxGraphLinkCount)->Unit(benchmark::kMillisecond)
+
+I2_BENCHMARK_NODES(constructNodesFromJSON);
+I2_BENCHMARK_NODES(addLink);
+I2_BENCHMARK_NODES(addLinks);
+I2_BENCHMARK_NODES(recalculateWeightedDegree);
+I2_BENCHMARK_NODES(sortNodes);
+I2_BENCHMARK_NODES(computePageRankNodes);
+I2_BENCHMARK_NODES(graphToNodes);
+I2_BENCHMARK_NODES(graphToNodesArena);
+I2_BENCHMARK_GRAPH(constructGraphFromStream);
+I2_BENCHMARK_GRAPH(buildGraph);
+
+BENCHMARK_CAPTURE(applyGraphDelta, uniform, I2Benchmark::Distribution::Uniform)->ArgsProduct({benchmark::CreateRange(minLinkCount, maxNodeLinkCount, 10), {1, 2, 4, 8}})->ArgNames({"links", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(applyGraphDelta, scaleFree, I2Benchmark::Distribution::ScaleFree)->ArgsProduct({benchmark::CreateRange(minLinkCount, maxNodeLinkCount, 10), {1, 2, 4, 8}})->ArgNames({"links", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(computePageRankGraph, uniform, I2Benchmark::Distribution::Uniform)->ArgsProduct({benchmark::CreateRange(minLinkCount, maxGraphLinkCount, 10), {1, 0}})->ArgNames({"links", "threads"})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(computePageRankGraph, scaleFree, I2Benchmark::Distribution::ScaleFree)->ArgsProduct({benchmark::CreateRange(minLinkCount, maxGraphLinkCount, 10), {1, 0}})->ArgNames({"links", "threads"})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(computePageRankCompressed, uniform, I2Benchmark::Distribution::Uniform)->ArgsProduct({benchmark::CreateRange(minLinkCount, maxGraphLinkCount, 10), {1, 0}})->ArgNames({"links", "threads"})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(computePageRankCompressed, scaleFree, I2Benchmark::Distribution::ScaleFree)->ArgsProduct({benchmark::CreateRange(minLinkCount, maxGraphLinkCount, 10), {1, 0}})->ArgNames({"links", "threads"})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,240 @@
+/*****************************************************************//**
+ * @file   compressedGraph.hpp
+ * @brief  Declarations of a read-only graph with delta and varint encoded adjacency rows
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_COMPRESSED_GRAPH_HPP
+#define I2_COMPRESSED_GRAPH_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	// The rows are read and written a word at a time, keeping the low bytes of each integer (see decodeVarint, decodeGroupValue and
+	// decodeWeight): this relies on the lowest byte coming first. The layout is never written out, so supporting a big-endian host only needs
+	// those loads and stores to swap their bytes.
+	static_assert(std::endian::native == std::endian::little, "CompressedGraph rows assume a little-endian host");
+
+	/**
+	 * @class CompressedGraph
+	 * @brief Read-only graph whose adjacency rows are delta and varint encoded, so ranking reads a fraction of the bytes a Graph holds
+	 *
+	 * Each row is a byte string: the link count, then the first link's target as a zigzag encoded varint difference from the node itself, then
+	 * the difference of every other target from the one before it. These are stored as group varints: four to a group, led by a byte holding
+	 * the length (1 to 4 bytes) of each, so a decoder knows where every value starts without testing each byte. Differences are taken modulo
+	 * 2^32, so unsorted rows round-trip too, but rows built by GraphBuilder are sorted and most of their differences take one or two bytes. Each
+	 * weight follows its target in the narrowest width that holds every weight of the graph (1, 2 or 4 bytes), and is not stored when every
+	 * weight is 1. Rows are decoded while they are iterated (see forEachLink), in their original order, so sums over a row match those over the
+	 * Graph the compressed graph was built from exactly.
+	 *
+	 * Names and weighted degrees are kept as they are within Graph. A CompressedGraph is immutable, so it can be read from many threads without
+	 * locking, and copies share the same arrays.
+	 */
+	class I2LIB_API CompressedGraph
+	{
+	private:
+		/**
+		 * @brief The arrays shared between copies.
+		 */
+		struct Storage
+		{
+			std::vector<std::uint64_t> rowOffset; // nodeCount + 1 entries: the start of each row within row
+			std::vector<std::uint8_t> row; // Every encoded row, back to back, then padding so a decoder can read whole words
+			std::vector<std::uint32_t> weightedDegree;
+			std::vector<std::uint64_t> nameOffset;
+			std::vector<char> nameData;
+			std::uint64_t entryCount = 0;
+			unsigned int weightWidth = 0; // The bytes stored per weight: 0 when every weight is 1
+		};
+
+		std::shared_ptr<const Storage> _storage;
+
+		/**
+		 * @brief Decodes a varint of up to five bytes (every link count and first difference fits), advancing data past it.
+		 * @details Eight bytes are read at once and the 7-bit groups are gathered without branching, as the lengths vary too much from row to
+		 * row to predict: the rows are padded so the read never leaves them.
+		 */
+		[[nodiscard]] static std::uint64_t decodeVarint(const std::uint8_t *&data) noexcept
+		{
+			std::uint64_t word;
+
+			std::memcpy(&word, data, sizeof(word)); // Little-endian (see the static_assert above): the first byte holds the lowest group
+
+			const std::uint64_t stop = ~word & 0x8080808080808080; // The high bit of every byte that ends a varint
+
+			word &= stop ^ (stop - 1); // Keep the bytes up to the first that ends one
+			data += (std::countr_zero(stop) >> 3) + 1;
+
+			return (word & 0x7F) | ((word >> 1) & 0x3F80) | ((word >> 2) & 0x1FC000) | ((word >> 3) & 0xFE00000) | ((word >> 4) & 0x7F0000000);
+		}
+
+		/**
+		 * @brief Decodes a group varint value of 1 to 4 bytes, advancing data past it.
+		 */
+		[[nodiscard]] static std::uint32_t decodeGroupValue(const std::uint8_t *&data, unsigned int length) noexcept
+		{
+			std::uint32_t value;
+
+			std::memcpy(&value, data, sizeof(value)); // Little-endian: the value's bytes are the lowest, followed by the bytes after it
+			data += length;
+
+			return value & (0xFFFFFFFFu >> (32 - 8 * length));
+		}
+
+		template<unsigned int WeightWidth>
+		[[nodiscard]] static std::uint32_t decodeWeight(const std::uint8_t *&data) noexcept
+		{
+			std::uint32_t weight = 1;
+
+			if constexpr(WeightWidth > 0)
+			{
+				weight = 0;
+				std::memcpy(&weight, data, WeightWidth); // The low bytes, on a little-endian host
+				data += WeightWidth;
+			}
+
+			return weight;
+		}
+
+		template<unsigned int WeightWidth, typename Function>
+		static void decodeRow(const std::uint8_t *data, NodeId id, Function &&function)
+		{
+			std::uint64_t remaining = decodeVarint(data);
+
+			if(!remaining)
+				return;
+
+			const std::uint64_t first = decodeVarint(data);
+
+			NodeId target = id + static_cast<NodeId>((first >> 1) ^ (0 - (first & 1))); // Undo the zigzag encoding, modulo 2^32
+
+			function(target, decodeWeight<WeightWidth>(data));
+
+			// The remaining differences come in groups of four, led by a byte holding the length of each
+			for(--remaining;remaining;)
+			{
+				const unsigned int control = *data++, groupSize = remaining < 4 ? static_cast<unsigned int>(remaining) : 4;
+
+				if(groupSize == 4)
+				{
+					for(unsigned int k=0;k<4;++k) // Unrolled, with every length known from the control byte
+					{
+						target += decodeGroupValue(data, ((control >> (2 * k)) & 3) + 1);
+						function(target, decodeWeight<WeightWidth>(data));
+					}
+				}
+				else
+				{
+					for(unsigned int k=0;k<groupSize;++k)
+					{
+						target += decodeGroupValue(data, ((control >> (2 * k)) & 3) + 1);
+						function(target, decodeWeight<WeightWidth>(data));
+					}
+				}
+
+				remaining -= groupSize;
+			}
+		}
+
+	public:
+		/**
+		 * @brief Constructs an empty graph.
+		 */
+		CompressedGraph(void);
+
+		/**
+		 * @brief Encodes the rows of a graph, in parallel.
+		 * @param[in] graph The graph to compress: it can be released afterwards
+		 * @param[in] threadCount The number of threads to encode on: 0 uses one thread per hardware thread. The result does not depend on it
+		 */
+		explicit CompressedGraph(const Graph &graph, std::size_t threadCount = 1);
+
+		/**
+		 * @return The total number of nodes
+		 */
+		[[nodiscard]] std::size_t getNodeCount(void) const noexcept;
+
+		/**
+		 * @return The total number of adjacency entries (each undirected link is counted once per direction)
+		 */
+		[[nodiscard]] std::uint64_t getEntryCount(void) const noexcept;
+
+		/**
+		 * @return The bytes stored per link weight: 0 when every weight is 1
+		 */
+		[[nodiscard]] unsigned int getWeightWidth(void) const noexcept;
+
+		/**
+		 * @return The bytes held by the encoded rows and their offsets, comparable to getAdjacencyBytes of the uncompressed graph
+		 */
+		[[nodiscard]] std::size_t getAdjacencyBytes(void) const noexcept;
+
+		/**
+		 * @param[in] graph The uncompressed graph to measure
+		 * @return The bytes held by the graph's offset, target and weight arrays
+		 */
+		[[nodiscard]] static std::size_t getAdjacencyBytes(const Graph &graph) noexcept;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The node's name, valid for the lifetime of the graph
+		 */
+		[[nodiscard]] std::string_view getName(NodeId id) const;
+
+		/**
+		 * @return The accumulation of each node's link weights, indexed by NodeId (as Graph::getWeightedDegree)
+		 */
+		[[nodiscard]] std::span<const std::uint32_t> getWeightedDegrees(void) const noexcept;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The total number of linked nodes
+		 */
+		[[nodiscard]] unsigned int getLinkCount(NodeId id) const;
+
+		/**
+		 * @brief Decodes a node's row, calling function(target, weight) for each link in the order of Graph::getNeighbours.
+		 * @param[in] id The node to query: must be a node of the graph
+		 * @param[in] function Called for each link
+		 */
+		template<typename Function>
+		void forEachLink(NodeId id, Function &&function) const
+		{
+			const std::uint8_t *data = this->_storage->row.data() + this->_storage->rowOffset[id];
+
+			switch(this->_storage->weightWidth) // The same for every row, so the branch is always predicted
+			{
+			case 0:
+				decodeRow<0>(data, id, function);
+				break;
+
+			case 1:
+				decodeRow<1>(data, id, function);
+				break;
+
+			case 2:
+				decodeRow<2>(data, id, function);
+				break;
+
+			default:
+				decodeRow<4>(data, id, function);
+				break;
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*****************************************************************//**
+ * @file   edgeList.hpp
+ * @brief  Declarations of the delimited text and fixed-width binary edge list loaders
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_EDGE_LIST_HPP
+#define I2_EDGE_LIST_HPP
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	namespace EdgeList
+	{
+		/**
+		 * @brief Parameters controlling how an edge list is loaded.
+		 */
+		struct Options
+		{
+			char delimiter = '\0'; // The text field separator: '\0' detects ',' or '\t' from the first link, falling back to runs of spaces
+			std::string namesPath = ""; // Optional sidecar file holding one node name per line (line i names node i). Without it, nodes are named by ID and the node count is the highest ID + 1
+			bool nodesCanLinkToSelf = false; // When true links are valid if source and target match
+			DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst; // How links listed more than once are resolved
+			std::size_t threadCount = 1; // The number of threads to parse on: 0 uses one thread per hardware thread. The graph does not depend on it
+		};
+
+		/**
+		 * @brief The edge list formats that can be loaded.
+		 */
+		enum class Format
+		{
+			None, // Not an edge list
+			Text, // Delimited text (see loadText)
+			Binary // Fixed-width binary records (see loadBinary)
+		};
+
+		/**
+		 * @brief A link within a binary edge list: three little-endian 32-bit unsigned integers, without padding or a file header.
+		 */
+		struct Record
+		{
+			std::uint32_t source;
+			std::uint32_t target;
+			std::uint32_t weight;
+		};
+
+		/**
+		 * @brief The size of a Record within a binary edge list, in bytes.
+		 */
+		constexpr std::size_t recordSize = 12;
+
+		/**
+		 * @brief Loads a delimited text edge list: one "source,target[,weight]" link per line, with a weight of 1 when it is omitted.
+		 * @details Blank lines and lines starting with '#' or '%' are skipped, as is a header line (a first line that does not start with a
+		 * digit). The mapped file is split into chunks at newline boundaries, and the chunks are parsed on options.threadCount threads into
+		 * separate link buffers that are then merged in file order, so repeated links are resolved in file order whatever the thread count.
+		 * @param[in] path The path to the edge list
+		 * @param[in] options The delimiter, names sidecar, self-link rule, duplicate policy and thread count
+		 * @return The constructed graph
+		 * @throw std::runtime_error "Invalid link at index 'N'." for the first malformed or invalid link, with the same rules as NodeLoader::constructNodesFromJSON
+		 */
+		[[nodiscard]] Graph I2LIB_API loadText(const std::string &path, const Options &options = Options());
+
+		/**
+		 * @brief Loads a binary edge list (see Record), decoding it in parallel chunks.
+		 * @param[in] path The path to the edge list
+		 * @param[in] options The names sidecar, self-link rule, duplicate policy and thread count (the delimiter is not used)
+		 * @return The constructed graph
+		 * @throw std::runtime_error if the file is not a whole number of records, or "Invalid link at index 'N'." for the first invalid link
+		 */
+		[[nodiscard]] Graph I2LIB_API loadBinary(const std::string &path, const Options &options = Options());
+
+		/**
+		 * @brief Streams the links of a text or binary edge list (told apart as detectFormat does) in file order, without building a graph.
+		 * @details The file is read through a fixed-size buffer, so memory use does not depend on its size (see ShardedGraph). Text is parsed
+		 * with the same rules as loadText. Links are not validated, as the node count may only be known once every link has been read.
+		 * @param[in] path The path to the edge list
+		 * @param[in] options The delimiter (the other options are not used)
+		 * @param[in] consumer Called with each batch of links, and the index of the batch's first link within the file
+		 * @throw std::runtime_error if the file is not an edge list, cannot be read or is truncated, or "Invalid link at index 'N'." for the
+		 * first malformed line (once the links before it have been passed to the consumer)
+		 */
+		void I2LIB_API scan(const std::string &path, const Options &options, const std::function<void(std::span<const Record>, std::size_t)> &consumer);
+
+		/**
+		 * @brief Appends records to a binary edge list, in little-endian byte order whatever the host.
+		 * @param[out] output The stream to write to
+		 * @param[in] record The links to write
+		 */
+		void I2LIB_API writeBinary(std::ostream &output, std::span<const Record> record);
+
+		/**
+		 * @brief Detects an edge list from its file extension: '.csv', '.tsv', '.txt' and '.edges' are text, and '.bin' is binary.
+		 * @param[in] path The path to the file
+		 * @return The format of the file, or Format::None if it is not an edge list
+		 */
+		[[nodiscard]] Format I2LIB_API detectFormat(const std::string &path);
+	}
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*****************************************************************//**
+ * @file   generator.hpp
+ * @brief  Declarations of the synthetic graph generators used for load testing (see i2GraphGen)
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_GENERATOR_HPP
+#define I2_GENERATOR_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	namespace Generator
+	{
+		/**
+		 * @brief The random graph model to generate links with.
+		 */
+		enum class Model
+		{
+			ErdosRenyi, // Both ends of every link are chosen uniformly at random
+			BarabasiAlbert, // Preferential attachment: node i links to nodes chosen in proportion to their degree, giving a scale-free degree distribution
+			RMAT // Recursive matrix: links fall into quadrants of the adjacency matrix with probabilities a, b, c and d, giving skewed, community-like structure
+		};
+
+		/**
+		 * @brief The distribution link weights are drawn from.
+		 */
+		enum class WeightDistribution
+		{
+			Uniform, // Every weight within [minWeight, maxWeight] is equally likely
+			PowerLaw // Low weights are common and high weights rare: P(w) is proportional to w^-weightExponent within [minWeight, maxWeight]
+		};
+
+		/**
+		 * @brief Parameters controlling a generated graph.
+		 */
+		struct Options
+		{
+			Model model = Model::ErdosRenyi;
+			std::uint64_t nodeCount = 1000;
+			std::uint64_t linkCount = 4000;
+			WeightDistribution weightDistribution = WeightDistribution::Uniform;
+			unsigned int minWeight = 1;
+			unsigned int maxWeight = 10;
+			double weightExponent = 2.0; // Only used by WeightDistribution::PowerLaw
+			double selfLinkRatio = 0.0; // The probability of a link being a link to self: graphs with self-links must be loaded with nodesCanLinkToSelf
+			std::uint64_t seed = 1; // Equal options (bar threadCount) always generate an identical graph
+			double rmatA = 0.57, rmatB = 0.19, rmatC = 0.19; // Quadrant probabilities of Model::RMAT: d is the remainder
+			std::size_t threadCount = 1; // The number of threads to generate on: 0 uses one thread per hardware thread. The output does not depend on it
+		};
+
+		/**
+		 * @brief A generated link.
+		 */
+		struct Link
+		{
+			NodeId source;
+			NodeId target;
+			std::uint32_t weight;
+		};
+
+		/**
+		 * @brief The number of links per block: blocks are the unit of parallel generation and of streamed output.
+		 */
+		constexpr std::uint64_t blockSize = 1 << 16;
+
+		/**
+		 * @brief Checks that the options describe a graph that can be generated.
+		 * @param[in] options The options to check
+		 * @throw std::runtime_error describing the first invalid option
+		 */
+		void I2LIB_API validate(const Options &options);
+
+		/**
+		 * @param[in] options The graph to generate
+		 * @return The number of blocks the links are generated in
+		 */
+		[[nodiscard]] std::uint64_t I2LIB_API getBlockCount(const Options &options) noexcept;
+
+		/**
+		 * @brief Generates one block of links.
+		 * @details Every link is a pure function of the options and its index, so blocks can be generated on any thread, in any order. Links
+		 * are not de-duplicated (the loaders keep the first weight of a repeated link), so very dense graphs load with fewer links than generated.
+		 * @param[in] options The graph to generate
+		 * @param[in] block The index of the block to generate
+		 * @param[out] link Replaced with the links of the block, in link index order
+		 */
+		void I2LIB_API generateBlock(const Options &options, std::uint64_t block, std::vector<Link> &link);
+
+		/**
+		 * @brief Generates the whole graph in memory: node i is named "Node<i>".
+		 * @param[in] options The graph to generate
+		 * @return The generated graph
+		 * @throw std::runtime_error if the options are invalid
+		 */
+		[[nodiscard]] Graph I2LIB_API generateGraph(const Options &options);
+
+		/**
+		 * @brief Streams the graph as JSON in the node/link format of resources/data.json, generating and formatting blocks on options.threadCount threads.
+		 * @details Memory use is bounded by a few blocks per thread, whatever the size of the graph.
+		 * @param[in] options The graph to generate
+		 * @param[out] output The stream to write to
+		 * @throw std::runtime_error if the options are invalid or the stream fails
+		 */
+		void I2LIB_API writeJSON(const Options &options, std::ostream &output);
+
+		/**
+		 * @brief Streams the links as a binary edge list (see EdgeList::loadBinary), generating blocks on options.threadCount threads.
+		 * @param[in] options The graph to generate
+		 * @param[out] output The stream to write to
+		 * @throw std::runtime_error if the options are invalid or the stream fails
+		 */
+		void I2LIB_API writeBinary(const Options &options, std::ostream &output);
+
+		/**
+		 * @brief Streams the node names as an edge list names sidecar: one name per line.
+		 * @param[in] options The graph to generate
+		 * @param[out] output The stream to write to
+		 * @throw std::runtime_error if the options are invalid or the stream fails
+		 */
+		void I2LIB_API writeNames(const Options &options, std::ostream &output);
+	}
+}
+
+#endif
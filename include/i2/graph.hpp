@@ -0,0 +1,270 @@
+/*****************************************************************//**
+ * @file   graph.hpp
+ * @brief  Declarations of a read-optimised, compressed sparse row (CSR) graph representation
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_GRAPH_HPP
+#define I2_GRAPH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "i2/namePool.hpp"
+#include "i2/node.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @class Graph
+	 * @brief Read-optimised graph with dense integer node IDs and compressed sparse row (CSR) adjacency
+	 *
+	 * The neighbours of node i are stored contiguously in target[offset[i]..offset[i+1]), with the matching link weights in weight.
+	 * Undirected links are stored in both directions, exactly as Node::addLink is called for both the source and the target node.
+	 * A Graph is immutable once built (see GraphBuilder), so it can be read from many threads without locking, and copies share the same arrays.
+	 */
+	class I2LIB_API Graph
+	{
+	public:
+		/**
+		 * @brief Views of the arrays that make up a graph: the same layout is used in memory and within a binary snapshot (see Snapshot).
+		 */
+		struct Layout
+		{
+			std::span<const std::uint64_t> offset; // nodeCount + 1 entries: the start of each node's adjacency row within target/weight
+			std::span<const NodeId> target; // The linked node of each adjacency entry
+			std::span<const std::uint32_t> weight; // The weight of each adjacency entry
+			std::span<const std::uint32_t> weightedDegree; // The accumulation of each node's link weights
+			std::span<const std::uint64_t> nameOffset; // nodeCount + 1 entries: the start of each node's name within nameData
+			std::span<const char> nameData; // All node names, back to back without terminators
+		};
+
+	private:
+		struct NameLookup; // The name to ID index, built on first use for graphs that were not built from a NamePool
+
+		std::shared_ptr<const void> _storage; // Keeps the memory behind _layout alive: either arrays owned by the graph or a mapped snapshot file
+		Layout _layout;
+		std::shared_ptr<NameLookup> _nameLookup; // Shared between copies, as the storage is
+
+	public:
+		/**
+		 * @brief Constructs an empty graph.
+		 */
+		Graph(void);
+
+		/**
+		 * @brief Constructs a graph from pre-built CSR arrays (see GraphBuilder::build), taking ownership of them and of the pooled names.
+		 * @param[in] name The name of each node, indexed by NodeId
+		 * @param[in] offset The start of each node's adjacency row: must contain name.size() + 1 entries
+		 * @param[in] target The linked node of each adjacency entry
+		 * @param[in] weight The weight of each adjacency entry
+		 */
+		Graph(NamePool name, std::vector<std::uint64_t> offset, std::vector<NodeId> target, std::vector<std::uint32_t> weight);
+
+		/**
+		 * @brief Constructs a graph over arrays that live elsewhere, such as a mapped file, without copying them.
+		 * @details Only the array sizes are checked, so construction is O(1): the arrays must be well formed (as written by Snapshot::saveToFile).
+		 * @param[in] storage Keeps the memory referenced by layout alive for the lifetime of the graph (and any copies of it)
+		 * @param[in] layout Views of the graph arrays
+		 */
+		Graph(std::shared_ptr<const void> storage, const Layout &layout);
+
+		/**
+		 * @return Views of the arrays that make up the graph
+		 */
+		[[nodiscard]] const Layout &getLayout(void) const noexcept;
+
+		/**
+		 * @return The total number of nodes
+		 */
+		[[nodiscard]] std::size_t getNodeCount(void) const noexcept;
+
+		/**
+		 * @return The total number of adjacency entries (each undirected link is counted once per direction)
+		 */
+		[[nodiscard]] std::size_t getEntryCount(void) const noexcept;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The node's name, valid for the lifetime of the graph
+		 */
+		[[nodiscard]] std::string_view getName(NodeId id) const;
+
+		/**
+		 * @brief Looks a node up by name through a hash index: a mapped snapshot builds the index on the first call (from any thread).
+		 * @param[in] name The name to look up
+		 * @return The lowest ID with the name, if any
+		 */
+		[[nodiscard]] std::optional<NodeId> findNode(std::string_view name) const;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The accumulation of all link weights of the node
+		 */
+		[[nodiscard]] unsigned int getWeightedDegree(NodeId id) const;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The total number of linked nodes
+		 */
+		[[nodiscard]] unsigned int getLinkCount(NodeId id) const;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The IDs of all linked nodes, without copying
+		 */
+		[[nodiscard]] std::span<const NodeId> getNeighbours(NodeId id) const;
+
+		/**
+		 * @param[in] id The node to query
+		 * @return The weights of all links, in the same order as getNeighbours
+		 */
+		[[nodiscard]] std::span<const std::uint32_t> getWeights(NodeId id) const;
+
+		/**
+		 * @brief Materialises the graph as linked Node instances, for callers of the original Node API.
+		 * @details Every node, control block, name and link table is allocated from resource. Given an arena (such as a std::pmr::monotonic_buffer_resource)
+		 * the nodes are allocated in large blocks and released together when the arena is destroyed, rather than one free (and one refcount
+		 * decrement) at a time: as linked nodes reference each other, releasing the arena is also what frees them. No node may be used after that.
+		 * @param[in] resource The memory resource to allocate from: must outlive the nodes
+		 * @return List of constructed node instances, indexed by NodeId
+		 */
+		[[nodiscard]] std::vector<std::shared_ptr<Node>> toNodes(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+
+		/**
+		 * @brief Takes a snapshot of linked Node instances as a graph, so the dense algorithms can serve callers of the original Node API.
+		 * @details Each node's links become its adjacency row as-is (links are not mirrored). Links to nodes outside of nodeList are ignored.
+		 * @param[in] nodeList The nodes to convert: node i of the list becomes NodeId i
+		 * @return The constructed graph
+		 */
+		[[nodiscard]] static Graph fromNodes(const std::vector<std::shared_ptr<Node>> &nodeList);
+	};
+
+	/**
+	 * @brief How GraphBuilder resolves a link that is received more than once (in either direction).
+	 */
+	enum class DuplicatePolicy
+	{
+		Reject, // Fail the build, reporting the index of the first repeated link
+		KeepFirst, // Keep the weight the link was first received with, as Node::addLink does
+		SumWeights, // Accumulate the weights (saturating at the largest weight a link can hold)
+		MaxWeight // Keep the largest weight
+	};
+
+	/**
+	 * @class GraphBuilder
+	 * @brief Collects nodes and links and then lays them out as a Graph in bulk
+	 *
+	 * Links are validated with the same rules as NodeLoader::constructNodesFromJSON: both ends must reference a known node, and a node
+	 * may only link to itself when nodesCanLinkToSelf is set. Repeated links are resolved by the duplicate policy.
+	 *
+	 * Building takes two passes over the links, each split across a WorkStealingPool: the first counts the entries of every row with atomic
+	 * increments, and the second places each link straight into its pre-sized rows through atomic row cursors, so no lock is ever taken. Each
+	 * row is then sorted by target and input order and merged, so the graph is identical whatever the thread count or scheduling.
+	 */
+	class I2LIB_API GraphBuilder
+	{
+	private:
+		/**
+		 * @brief A link as it was received, before being laid out in both directions.
+		 */
+		struct Link
+		{
+			NodeId source;
+			NodeId target;
+			unsigned int weight;
+		};
+
+		NamePool _name;
+		std::vector<Link> _link;
+		bool _nodesCanLinkToSelf;
+		DuplicatePolicy _duplicatePolicy;
+
+	public:
+		/**
+		 * @brief Constructs an empty builder.
+		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 * @param[in] duplicatePolicy How links received more than once are resolved
+		 */
+		explicit GraphBuilder(bool nodesCanLinkToSelf = false, DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst);
+
+		/**
+		 * @brief Pre-allocates storage when the node and link counts are known up front.
+		 * @param[in] nodeCount The expected number of nodes
+		 * @param[in] linkCount The expected number of links
+		 */
+		void reserve(std::size_t nodeCount, std::size_t linkCount);
+
+		/**
+		 * @brief Appends a node, interning its name: IDs are handed out in insertion order.
+		 * @param[in] name The unique name of the node
+		 * @return The ID of the new node
+		 */
+		NodeId addNode(std::string_view name);
+
+		/**
+		 * @brief Appends an undirected link: validation is deferred to build, as links may be received before the nodes they reference.
+		 * @param[in] source The ID of the source node
+		 * @param[in] target The ID of the target node
+		 * @param[in] weight The weight associated to the link
+		 */
+		void addLink(NodeId source, NodeId target, unsigned int weight);
+
+		/**
+		 * @param[in] source The ID of the source node
+		 * @param[in] target The ID of the target node
+		 * @return true if the link references nodes that have been added, and only links to itself if that is allowed
+		 */
+		[[nodiscard]] bool isValidLink(NodeId source, NodeId target) const noexcept;
+
+		/**
+		 * @return The index of the first link that fails validation (see isValidLink), if any
+		 */
+		[[nodiscard]] std::optional<std::size_t> findInvalidLink(void) const noexcept;
+
+		/**
+		 * @return The number of nodes added so far
+		 */
+		[[nodiscard]] std::size_t getNodeCount(void) const noexcept;
+
+		/**
+		 * @return The number of links added so far
+		 */
+		[[nodiscard]] std::size_t getLinkCount(void) const noexcept;
+
+		/**
+		 * @brief Validates all links and lays them out as a Graph: the builder is left empty afterwards.
+		 * @param[in] threadCount The number of threads to build on: 0 uses one thread per hardware thread. The graph does not depend on it
+		 * @return The constructed graph
+		 * @throw std::runtime_error "Invalid link at index 'N'." for the first link that fails validation, or "Duplicate link at index 'N'."
+		 * for the first repeated link under DuplicatePolicy::Reject
+		 */
+		[[nodiscard]] Graph build(std::size_t threadCount = 1);
+
+		/**
+		 * @brief Builds the error reported for an invalid link, so every loader reports failures identically.
+		 * @param[in] index The index of the link within the input
+		 * @return The error message
+		 */
+		[[nodiscard]] static std::string invalidLinkError(std::size_t index);
+
+		/**
+		 * @brief Builds the error reported for a repeated link under DuplicatePolicy::Reject.
+		 * @param[in] index The index of the repeated link within the input
+		 * @return The error message
+		 */
+		[[nodiscard]] static std::string duplicateLinkError(std::size_t index);
+	};
+}
+
+#endif
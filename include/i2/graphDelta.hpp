@@ -0,0 +1,110 @@
+/*****************************************************************//**
+ * @file   graphDelta.hpp
+ * @brief  Declarations of a batch of link changes applied to linked Node instances atomically
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_GRAPH_DELTA_HPP
+#define I2_GRAPH_DELTA_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "i2/node.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @class GraphDelta
+	 * @brief A batch of undirected link inserts, removals and weight updates, applied to linked Node instances as one atomic change
+	 *
+	 * Changes are staged without locking, then apply groups them by node and takes every affected node's lock once, in a canonical
+	 * (address) order, so concurrent batches over overlapping nodes cannot deadlock. Both directions of every link change while all the
+	 * locks are held, so no reader can observe half of an undirected link, and each node's weighted degree is written once per batch.
+	 *
+	 * A GraphDelta is not itself thread safe: each ingestion thread builds and applies its own, and any number may be applied at once.
+	 * Observers (see LinkObserver) are notified after every lock is released: a weight update is reported as a removal followed by an addition.
+	 */
+	class I2LIB_API GraphDelta
+	{
+	private:
+		/**
+		 * @brief The kinds of change a batch can hold.
+		 */
+		enum class Kind
+		{
+			Insert, // As Node::addLink: an existing link keeps its weight
+			Remove, // As Node::removeLink: a missing link is ignored
+			Update // Changes the weight of an existing link: a missing link is ignored
+		};
+
+		/**
+		 * @brief A staged change to an undirected link.
+		 */
+		struct Change
+		{
+			std::shared_ptr<Node> source;
+			std::shared_ptr<Node> target;
+			std::uint32_t weight;
+			Kind kind;
+		};
+
+		std::vector<Change> _change;
+
+		/**
+		 * @brief Stages a change, validating both ends.
+		 */
+		void stage(std::shared_ptr<Node> source, std::shared_ptr<Node> target, std::uint32_t weight, Kind kind);
+
+	public:
+		/**
+		 * @brief Pre-allocates storage when the number of changes is known up front.
+		 * @param[in] changeCount The expected number of changes
+		 */
+		void reserve(std::size_t changeCount);
+
+		/**
+		 * @brief Stages an undirected link, added to both nodes: ignored for a node that already links to the other.
+		 * @param[in] source One end of the link
+		 * @param[in] target The other end of the link
+		 * @param[in] weight The weight associated to the link
+		 * @throw std::runtime_error "Error: Invalid node." if either node is null
+		 */
+		void addLink(std::shared_ptr<Node> source, std::shared_ptr<Node> target, unsigned int weight);
+
+		/**
+		 * @brief Stages the removal of an undirected link from both nodes.
+		 * @param[in] source One end of the link
+		 * @param[in] target The other end of the link
+		 * @throw std::runtime_error "Error: Invalid node." if either node is null
+		 */
+		void removeLink(std::shared_ptr<Node> source, std::shared_ptr<Node> target);
+
+		/**
+		 * @brief Stages a new weight for an existing undirected link, in both directions.
+		 * @param[in] source One end of the link
+		 * @param[in] target The other end of the link
+		 * @param[in] weight The new weight of the link
+		 * @throw std::runtime_error "Error: Invalid node." if either node is null
+		 */
+		void updateLink(std::shared_ptr<Node> source, std::shared_ptr<Node> target, unsigned int weight);
+
+		/**
+		 * @return The number of staged changes
+		 */
+		[[nodiscard]] std::size_t size(void) const noexcept;
+
+		/**
+		 * @brief Applies every staged change in the order staged, atomically with respect to every affected node, and empties the batch.
+		 * @return The number of adjacency entries that changed (an undirected link counts once per direction)
+		 */
+		std::size_t apply(void);
+	};
+}
+
+#endif
@@ -12,6 +12,9 @@
 #define I2_IO_HPP
 
 #include <json/json.h>
+#include <istream>
+#include <string>
+#include <string_view>
 #include "i2/directives.hpp"
 
 namespace I2
@@ -25,6 +28,121 @@ namespace I2
 		 * @return true if valid JSON was successfully loaded into result, false if valid JSON was not loaded into result
 		 */
 		bool I2LIB_API loadJSONFromFile(std::string path, Json::Value &result);
+
+		/**
+		 * @class JsonHandler
+		 * @brief Receives SAX-style events while JSON is parsed incrementally, so no Json::Value document is ever built
+		 *
+		 * String views are only valid for the duration of the call. Handlers may throw to abort parsing: the exception propagates to the caller.
+		 */
+		class I2LIB_API JsonHandler
+		{
+		public:
+			virtual ~JsonHandler(void) = default;
+
+			/**
+			 * @brief Called when an object is opened ('{').
+			 */
+			virtual void onStartObject(void) = 0;
+
+			/**
+			 * @brief Called when an object is closed ('}').
+			 */
+			virtual void onEndObject(void) = 0;
+
+			/**
+			 * @brief Called when an array is opened ('[').
+			 */
+			virtual void onStartArray(void) = 0;
+
+			/**
+			 * @brief Called when an array is closed (']').
+			 */
+			virtual void onEndArray(void) = 0;
+
+			/**
+			 * @param[in] key The decoded name of the object member whose value follows
+			 */
+			virtual void onKey(std::string_view key) = 0;
+
+			/**
+			 * @param[in] value The decoded string value
+			 */
+			virtual void onString(std::string_view value) = 0;
+
+			/**
+			 * @param[in] text The number exactly as it appears in the input, so the handler can choose how to convert it
+			 */
+			virtual void onNumber(std::string_view text) = 0;
+
+			/**
+			 * @param[in] value The boolean value
+			 */
+			virtual void onBool(bool value) = 0;
+
+			/**
+			 * @brief Called for a null value.
+			 */
+			virtual void onNull(void) = 0;
+		};
+
+		/**
+		 * @brief Parses JSON from a stream in fixed-size chunks, reporting each token to handler as soon as it is read.
+		 * @param[in] input The stream containing the JSON
+		 * @param[in] handler Receives the parse events
+		 * @param[out] errors Describes the syntax error, if parsing failed
+		 * @return true if the stream contained valid JSON, false if a syntax error was found
+		 */
+		bool I2LIB_API parseJSONFromStream(std::istream &input, JsonHandler &handler, std::string &errors);
+
+		/**
+		 * @brief Takes the contents of a file and streams it through handler, with memory use bounded by the read buffer rather than the file size.
+		 * @param[in] path The path to the JSON file
+		 * @param[in] handler Receives the parse events
+		 * @return true if the file was opened and contained valid JSON, false otherwise
+		 */
+		bool I2LIB_API streamJSONFromFile(std::string path, JsonHandler &handler);
+
+		/**
+		 * @class MappedFile
+		 * @brief A read-only memory mapping of a whole file: pages are loaded lazily by the OS, so opening is O(1) regardless of the file size
+		 */
+		class I2LIB_API MappedFile
+		{
+		private:
+			const char *_data = nullptr;
+			std::size_t _size = 0;
+#ifdef _WIN32
+			void *_file = nullptr; // HANDLE to the file
+			void *_mapping = nullptr; // HANDLE to the file mapping
+#endif
+
+		public:
+			/**
+			 * @brief Maps the file at path into memory.
+			 * @param[in] path The path to the file
+			 * @throw std::runtime_error if the file could not be opened or mapped
+			 */
+			explicit MappedFile(const std::string &path);
+
+			MappedFile(const MappedFile &) = delete;
+			MappedFile &operator=(const MappedFile &) = delete;
+
+			/**
+			 * @brief Unmaps the file: any views of the data become invalid.
+			 */
+			~MappedFile(void);
+
+			/**
+			 * @return The start of the mapped file contents
+			 */
+			[[nodiscard]] const char *data(void) const noexcept;
+
+			/**
+			 * @return The size of the mapped file, in bytes
+			 */
+			[[nodiscard]] std::size_t size(void) const noexcept;
+		};
 	}
 }
 
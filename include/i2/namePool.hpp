@@ -0,0 +1,141 @@
+/*****************************************************************//**
+ * @file   namePool.hpp
+ * @brief  Declarations of the contiguous node name pool and its name to ID index
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_NAME_POOL_HPP
+#define I2_NAME_POOL_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @brief Dense node identifier: the index of a node within a Graph (matches the index of the node within the input 'nodes' array).
+	 */
+	using NodeId = std::uint32_t;
+
+	/**
+	 * @class NameIndex
+	 * @brief Open-addressing hash index from a node name to its NodeId, over names stored elsewhere
+	 *
+	 * Only the IDs are stored: names are compared in place, so the index costs one NodeId per slot whatever the name lengths.
+	 * The names are passed to every call in the Graph::Layout form (nameOffset/nameData), so the same index serves a NamePool and a mapped snapshot.
+	 */
+	class I2LIB_API NameIndex
+	{
+	private:
+		std::vector<NodeId> _slot; // A power of two in size, with empty slots holding emptySlot
+		std::size_t _count;
+
+		/**
+		 * @return The slot holding id, or the empty slot its probe sequence ends at
+		 */
+		[[nodiscard]] std::size_t probe(std::string_view name, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData) const noexcept;
+
+	public:
+		static constexpr NodeId emptySlot = ~NodeId(0);
+
+		/**
+		 * @brief Constructs an empty index.
+		 */
+		NameIndex(void);
+
+		/**
+		 * @brief Indexes every name in the arrays: where a name repeats, the lowest ID is kept.
+		 * @param[in] nameOffset nodeCount + 1 entries: the start of each node's name within nameData
+		 * @param[in] nameData All node names, back to back without terminators
+		 */
+		NameIndex(std::span<const std::uint64_t> nameOffset, std::span<const char> nameData);
+
+		/**
+		 * @brief Indexes node id, unless its name is already indexed.
+		 * @param[in] id The node to index: its name must already be within the arrays
+		 * @param[in] nameOffset The start of each node's name within nameData
+		 * @param[in] nameData All node names, back to back without terminators
+		 * @return true if the name was not already indexed
+		 */
+		bool insert(NodeId id, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData);
+
+		/**
+		 * @param[in] name The name to look up
+		 * @param[in] nameOffset The start of each node's name within nameData
+		 * @param[in] nameData All node names, back to back without terminators
+		 * @return The lowest ID with the name, if any
+		 */
+		[[nodiscard]] std::optional<NodeId> find(std::string_view name, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData) const noexcept;
+	};
+
+	/**
+	 * @class NamePool
+	 * @brief Interns node names back to back in one contiguous buffer, in the layout a Graph stores them in
+	 *
+	 * Adding a name costs no allocation beyond amortised buffer growth, and a Graph built from the pool adopts the buffers (and the index) without copying.
+	 * IDs are handed out in insertion order, so a repeated name still receives a new ID: find reports the first.
+	 * Only Graph (and the loaders building one) intern names: a Node keeps its own copy of its name, allocated from its memory resource.
+	 */
+	class I2LIB_API NamePool
+	{
+	private:
+		std::vector<std::uint64_t> _offset; // size() + 1 entries: the start of each name within _data
+		std::vector<char> _data;
+		NameIndex _index;
+
+	public:
+		/**
+		 * @brief Constructs an empty pool.
+		 */
+		NamePool(void);
+
+		/**
+		 * @brief Pre-allocates storage when the name count and total length are known up front.
+		 * @param[in] nameCount The expected number of names
+		 * @param[in] byteCount The expected total length of the names
+		 */
+		void reserve(std::size_t nameCount, std::size_t byteCount);
+
+		/**
+		 * @brief Copies a name into the pool.
+		 * @param[in] name The name to add
+		 * @return The ID of the name
+		 */
+		NodeId add(std::string_view name);
+
+		/**
+		 * @param[in] id The name to query
+		 * @return A view of the name: valid until the next call to add
+		 */
+		[[nodiscard]] std::string_view get(NodeId id) const;
+
+		/**
+		 * @param[in] name The name to look up
+		 * @return The lowest ID with the name, if any
+		 */
+		[[nodiscard]] std::optional<NodeId> find(std::string_view name) const noexcept;
+
+		/**
+		 * @return The number of names added so far
+		 */
+		[[nodiscard]] std::size_t size(void) const noexcept;
+
+		/**
+		 * @brief Hands the pool's buffers over (see Graph): the pool is left empty afterwards.
+		 * @param[out] offset Receives the start of each name within data (size() + 1 entries)
+		 * @param[out] data Receives the names, back to back
+		 * @param[out] index Receives the name to ID index
+		 */
+		void release(std::vector<std::uint64_t> &offset, std::vector<char> &data, NameIndex &index);
+	};
+}
+
+#endif
@@ -12,34 +12,101 @@
 #define I2_NODE_HPP
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
+#include <span>
+#include <atomic>
 #include <shared_mutex>
+#include <mutex>
+#include <vector>
 #include "i2/directives.hpp"
 
 namespace I2
 {
+	class Node;
+
+	/**
+	 * @class LinkObserver
+	 * @brief Receives a notification whenever a link is added to or removed from a Node it is subscribed to (see Node::subscribe)
+	 *
+	 * Notifications are delivered on the mutating thread after the node's lock has been released, so observers may read the node. They are
+	 * delivered under the node's observer lock, which Node::unsubscribe also takes, so once unsubscribe returns no notification is in flight
+	 * and the observer can safely be destroyed. An observer must therefore not subscribe to, unsubscribe from or modify the notifying node
+	 * from within a notification, and must not hold a lock that its notifications wait on while it subscribes or unsubscribes.
+	 */
+	class I2LIB_API LinkObserver
+	{
+	public:
+		virtual ~LinkObserver(void) = default;
+
+		/**
+		 * @param[in] node The node the link was added to
+		 * @param[in] link The linked node
+		 * @param[in] weight The weight associated to the link
+		 */
+		virtual void onLinkAdded(Node &node, const std::shared_ptr<Node> &link, unsigned int weight) = 0;
+
+		/**
+		 * @param[in] node The node the link was removed from
+		 * @param[in] link The previously linked node
+		 * @param[in] weight The weight that was associated to the link
+		 */
+		virtual void onLinkRemoved(Node &node, const std::shared_ptr<Node> &link, unsigned int weight) = 0;
+	};
+
 	/**
 	 * @class Node
 	 * @brief Declarations representing a node in a graph
 	 * 
 	 * This class is used to store information about a node, including links to other nodes and associated weight.
 	 * Nodes can be linked to other nodes to form a graph-like structure
+	 *
+	 * The name and the link table are allocated from the memory resource the node is constructed with (the default heap unless one is given),
+	 * so the nodes of one graph can share an arena (see Graph::toNodes). Each node holds its own copy of its name: names are only interned (see
+	 * NamePool) within a Graph, so prefer Graph for large graphs. The resource must outlive the node, and must be safe to allocate from
+	 * on every thread that modifies the node (such as std::pmr::synchronized_pool_resource) unless the nodes are only modified from one thread.
 	 */
 	class I2LIB_API Node
 	{
+		friend class GraphDelta; // Applies a whole batch of changes to a node under one lock, updating _weightedDegree once
+
 	private:
-		std::unordered_map<std::shared_ptr<Node>, unsigned int> _link; // Using a heap Node pointer, controlled with shared_ptr might be slower than stack memory but it is safer when it comes to referencing
+		std::pmr::unordered_map<std::shared_ptr<Node>, unsigned int> _link; // Using a heap Node pointer, controlled with shared_ptr might be slower than stack memory but it is safer when it comes to referencing
 		mutable std::shared_mutex _lock; // To ensure thread safety
-		std::string _name;
+		std::pmr::string _name;
 		unsigned int _weightedDegree; // Modified upon appending/removing a given link. More efficient to store/modify the result than to calculate each time it is needed
+		std::vector<LinkObserver*> _observer; // Not owned: observers unsubscribe themselves before they are destroyed
+		mutable std::shared_mutex _observerLock; // Guards _observer: held while notifying, so unsubscribe waits for any notification in flight
+		std::atomic<bool> _isObserved = false; // Whether _observer is non-empty: readable under the node's lock without taking the observer lock
+
+		/**
+		 * @brief Calls notify(observer) for every observer while holding the observer lock (but not the node's lock), so no observer can be
+		 * unsubscribed, and then destroyed, part way through a notification.
+		 */
+		template<typename Notify>
+		void notifyObservers(Notify &&notify) const
+		{
+			std::shared_lock<std::shared_mutex> locker(this->_observerLock); // Lock for reading: notifications on other threads proceed together
+
+			for(LinkObserver *observer : this->_observer)
+				notify(*observer);
+		}
+
+		/**
+		 * @brief Shared by both addLinks overloads: inserts a range of Node/weight pairs.
+		 */
+		template<typename Links>
+		void insertLinks(const Links &link);
 
 	public:
 		/**
 		 * @brief Constructs a new Node object with the given name.
 		 * @param[in] name The unique name of the node
+		 * @param[in] resource The memory resource the name and links are allocated from: must outlive the node
 		 */
-		explicit Node(std::string name);
+		explicit Node(std::string_view name, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
 		/**
 		 * @brief Constructs a new Node object by copying an existing Node instance.
@@ -54,14 +121,31 @@ namespace I2
 		Node(Node &&other) noexcept;
 
 		/**
-		 * @return The node's name
+		 * @return A view of the node's name, valid for the lifetime of the node (without copying it)
 		 */
-		[[nodiscard]] std::string getName(void) const noexcept;
+		[[nodiscard]] std::string_view getName(void) const noexcept;
 
 		/**
+		 * @brief Copies the links under the shared lock: prefer forEachLink, which visits them without copying.
 		 * @return All linked nodes with associated weights
 		 */
-		[[nodiscard]] std::unordered_map<std::shared_ptr<Node>, unsigned int> getLinks(void) const noexcept;
+		[[nodiscard]] std::unordered_map<std::shared_ptr<Node>, unsigned int> getLinks(void) const;
+
+		/**
+		 * @brief Visits every link without copying, holding the node's shared lock for the whole visit.
+		 * @details The visit sees one consistent set of links: writers to this node wait until it ends, while other readers proceed. So the
+		 * callback must not add or remove links on this node (that would deadlock) and should be brief. It may read or modify other nodes, unless
+		 * GraphDelta batches are applied concurrently: a batch holds several node locks at once, so waiting on another node could then deadlock.
+		 * @param[in] callback Invoked as callback(const std::shared_ptr<Node> &link, unsigned int weight) for each link, in no particular order
+		 */
+		template<typename Callback>
+		void forEachLink(Callback &&callback) const
+		{
+			std::shared_lock<std::shared_mutex> locker(this->_lock); // Lock for reading (allow simultaneous reads, but prevent writes)
+
+			for(std::pmr::unordered_map<std::shared_ptr<Node>,unsigned int>::const_iterator itL=this->_link.cbegin(),endL=this->_link.cend();itL!=endL;++itL)
+				callback(itL->first, itL->second);
+		}
 
 		/**
 		* @brief Retrieves the pre-stored weighted degree
@@ -95,11 +179,30 @@ namespace I2
 		**/
 		void addLinks(std::unordered_map<std::shared_ptr<Node>, unsigned int> link);
 
+		/**
+		* @brief Attempts to insert many Node/weight link pairs, without first collecting them into a map
+		* @details As with the map overload, inserts are more optimal if links do not pre-exist. Where a node repeats within link, the first weight is kept
+		* @param[in] link The links to add to Node::_link, with associated weights
+		**/
+		void addLinks(std::span<const std::pair<std::shared_ptr<Node>, unsigned int>> link);
+
 		/**
 		* @brief Removes the node/weight for n and updates Node::_weightedDegree, if the pair is present in Node::_link
 		**/
 		void removeLink(std::shared_ptr<Node> n);
 
+		/**
+		 * @brief Registers observer to be notified of every link added to or removed from this node: copied or moved-to nodes are not subscribed.
+		 * @param[in] observer The observer to notify: must unsubscribe before it is destroyed
+		 */
+		void subscribe(LinkObserver *observer);
+
+		/**
+		 * @brief Stops notifying observer, if it is subscribed: waits for any notification in flight, so the observer can be destroyed once this returns.
+		 * @param[in] observer The observer to stop notifying
+		 */
+		void unsubscribe(LinkObserver *observer);
+
 		/**
 		 * @brief Spaceship operator to handle comparisons based on weighted degree.
 		 * @param[in] other The instance to be compared with.
@@ -109,13 +212,14 @@ namespace I2
 
 		/**
 		 * @brief String operator to output the class name together with the weighted degree.
-		 * @return The result of the anme and weighted degree concatenation
+		 * @details Builds a new string on every call: write nodes with operator<< instead, which streams the same text without one.
+		 * @return The result of the name and weighted degree concatenation
 		 */
 		[[nodiscard]] operator std::string(void) const noexcept;
 	};
 
 	/**
-	 * @brief Makes use of the Node string operator to make Node streamable.
+	 * @brief Makes Node streamable, writing the same text as the Node string operator (and a newline, without flushing) without building the string.
 	 * @param[out] os The output stream to output the node to.
 	 * @param[in] The node to output
 	 * @return The output stream containing the streamed node
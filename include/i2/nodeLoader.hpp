@@ -12,19 +12,41 @@
 #define I2_NODE_LOADER_HPP
 
 #include "i2/node.hpp"
+#include "i2/graph.hpp"
+#include "i2/pageRank.hpp"
 #include <json/json.h>
+#include <istream>
 
 namespace I2
 {
 	namespace NodeLoader
 	{
+		/**
+		 * @brief Builds a read-optimised graph from JSON, with node IDs matching the node indexes within the JSON.
+		 * @param[in] data The JSON object containing a list of nodes with names, as well as a list of links to other nodes and associated weights
+		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 * @return The constructed graph
+		 */
+		Graph I2LIB_API constructGraphFromJSON(const Json::Value &data, bool nodesCanLinkToSelf = false);
+
+		/**
+		 * @brief Builds a read-optimised graph by streaming JSON from input: the 'nodes' and 'links' arrays are fed to a GraphBuilder as they are parsed, so no Json::Value document is built.
+		 * @param[in] input The stream containing the JSON object, with the same layout and validation rules as constructGraphFromJSON
+		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 * @param[in] duplicatePolicy How links listed more than once are resolved
+		 * @return The constructed graph
+		 * @throw std::runtime_error if the stream does not contain valid JSON, or the nodes/links are invalid
+		 */
+		Graph I2LIB_API constructGraphFromStream(std::istream &input, bool nodesCanLinkToSelf = false, DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst);
+
 		/**
 		 * @brief Builds nodes and adds the relevant links (node and associated weight) from JSON.
 		 * @param[in] data The JSON object containing a list of nodes with names, as well as a list of links to other nodes and associated weights
 		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 * @param[in] resource The memory resource the nodes are allocated from (see Graph::toNodes): must outlive the nodes
 		 * @return List of constructed node instances
 		 */
-		std::vector<std::shared_ptr<Node>> I2LIB_API constructNodesFromJSON(const Json::Value &data, bool nodesCanLinkToSelf = false);
+		std::vector<std::shared_ptr<Node>> I2LIB_API constructNodesFromJSON(const Json::Value &data, bool nodesCanLinkToSelf = false, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
 		/**
 		 * @brief Applies Google's PageRank formula to a list of nodes.
@@ -36,12 +58,82 @@ namespace I2
 		std::vector<std::pair<std::shared_ptr<Node>,double>> I2LIB_API computePageRank(const std::vector<std::shared_ptr<Node>> &nodeList, double dampeningFactor = 0.85, double tolerance = 1e-1);
 
 		/**
-		 * @brief Takes a path to a file containing JSON data of nodes, links to other nodes and the weight associated with the given link, converts it to a Json::Value instance, and produces a list of accurate nodes by calling constructNodes.
-		 * @param[in] path The path to a file containing the JSON data
+		 * @brief Applies Google's PageRank formula to a graph, without touching any Node instances.
+		 * @param[in] graph The graph on which to apply the PageRank formula.
+		 * @param[in] dampeningFactor Ensures that nodes with fewer links are not penalised too much. The damping factor is a constant used to control the redistribution of ranks.
+		 * @param[in] tolerance Used to determine if the ranking adjustments are too miniscule to continue recursive ranking.
+		 * @return The rank of each node, indexed by NodeId.
+		 */
+		std::vector<double> I2LIB_API computePageRank(const Graph &graph, double dampeningFactor = 0.85, double tolerance = 1e-1);
+
+		/**
+		 * @brief Applies Google's PageRank formula to a graph, spreading each iteration across options.threadCount threads.
+		 * @param[in] graph The graph on which to apply the PageRank formula.
+		 * @param[in] options The dampening factor, tolerance, rank limit and thread count: the ranks are bit-identical for any thread count.
+		 * @return The rank of each node, indexed by NodeId.
+		 */
+		std::vector<double> I2LIB_API computePageRank(const Graph &graph, const PageRankOptions &options);
+
+		/**
+		 * @brief Finds the nodes most related to one or more seed nodes with personalized PageRank (see PersonalizedPageRank).
+		 * @param[in] graph The graph to query.
+		 * @param[in] seeds The nodes to personalize on.
+		 * @param[in] options The dampening factor, push tolerance and the number of nodes to return: the cost depends on these, not on the size of the graph.
+		 * @return The top-k related nodes with their scores, highest first.
+		 */
+		std::vector<std::pair<NodeId,double>> I2LIB_API computePersonalizedPageRank(const Graph &graph, const std::vector<NodeId> &seeds, const PersonalizedPageRankOptions &options = PersonalizedPageRankOptions());
+
+		/**
+		 * @brief Finds the nodes most related to one or more seed nodes with personalized PageRank, for callers of the Node API.
+		 * @param[in] nodeList The nodes to query: converted with Graph::fromNodes, so the conversion (not the query) scales with the list.
+		 * @param[in] seeds The nodes to personalize on: each must be within nodeList.
+		 * @param[in] options The dampening factor, push tolerance and the number of nodes to return.
+		 * @return The top-k related nodes with their scores, highest first.
+		 */
+		std::vector<std::pair<std::shared_ptr<Node>,double>> I2LIB_API computePersonalizedPageRank(const std::vector<std::shared_ptr<Node>> &nodeList, const std::vector<std::shared_ptr<Node>> &seeds, const PersonalizedPageRankOptions &options = PersonalizedPageRankOptions());
+
+		/**
+		 * @brief Takes a path to a file containing JSON data of nodes, links to other nodes and the weight associated with the given link, and streams it into a read-optimised graph (see constructGraphFromStream).
+		 * @details Binary snapshots (see Snapshot::saveToFile) are detected automatically and memory mapped instead, and edge lists are detected by
+		 * their extension (see EdgeList::detectFormat) and loaded with nodes named by ID: use EdgeList::loadText/loadBinary directly for a names sidecar.
+		 * @param[in] path The path to a file containing the JSON data, a binary snapshot or an edge list
+		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 * @param[in] duplicatePolicy How links listed more than once are resolved (snapshots hold no duplicates)
+		 * @param[in] threadCount The number of threads to parse edge lists and lay the graph out on: 0 uses one thread per hardware thread. The
+		 * graph does not depend on it
+		 * @return The constructed graph: empty if the file could not be loaded
+		 */
+		Graph I2LIB_API loadGraphFromFile(std::string path, bool nodesCanLinkToSelf = false, DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst, std::size_t threadCount = 1);
+
+		/**
+		 * @brief Takes a path to a file containing JSON data of nodes, links to other nodes and the weight associated with the given link, and produces a list of accurate nodes by calling loadGraphFromFile.
+		 * @param[in] path The path to a file containing the JSON data, or a binary snapshot
 		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 * @param[in] resource The memory resource the nodes are allocated from (see Graph::toNodes): must outlive the nodes
 		 * @return List of constructed node instances
 		 */
-		std::vector<std::shared_ptr<Node>> I2LIB_API loadNodesFromFile(std::string path, bool nodesCanLinkToSelf = false);
+		std::vector<std::shared_ptr<Node>> I2LIB_API loadNodesFromFile(std::string path, bool nodesCanLinkToSelf = false, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+		/**
+		 * @brief Saves ranks so a later run can warm start from them (see loadRanksFromFile): one "name<TAB>rank" line per node, in NodeId order.
+		 * @details Ranks are written with the shortest digits that read back exactly, so a warm start resumes from precisely the saved ranks.
+		 * @param[in] graph The ranked graph: names each rank
+		 * @param[in] pageRank The rank of each node, indexed by NodeId (as returned by computePageRank)
+		 * @param[in] path The path to write to
+		 * @throw std::runtime_error if the ranks do not match the graph, or the file could not be written
+		 */
+		void I2LIB_API saveRanksToFile(const Graph &graph, const std::vector<double> &pageRank, std::string path);
+
+		/**
+		 * @brief Loads ranks saved by saveRanksToFile as the starting point of a run on the given graph (see PageRankEngine::run), matching nodes by name.
+		 * @details The graph may have changed since the ranks were saved: ranks of nodes it no longer holds are ignored, and nodes without a saved
+		 * rank start from the mean of the saved ranks (or 1 / nodeCount if none match, as with a cold start).
+		 * @param[in] graph The graph to be ranked
+		 * @param[in] path The path to a file written by saveRanksToFile
+		 * @return The rank of each node to start from, indexed by NodeId
+		 * @throw std::runtime_error if the file could not be opened, or a line is not a name followed by a tab and a finite, non-negative rank
+		 */
+		std::vector<double> I2LIB_API loadRanksFromFile(const Graph &graph, std::string path);
 
 		/**
 		 * @brief Comparator used for sorting a PageRank list in descending order.
@@ -50,6 +142,46 @@ namespace I2
 		 * @return true if the left-hand parameter is greater than the right-hand parameter.
 		 */
 		bool I2LIB_API pageRankComparatorGT(const std::pair<std::shared_ptr<Node>,double> &a, const std::pair<std::shared_ptr<Node>,double> &b);
+
+		/**
+		 * @brief Selects the nodes with the highest weighted degree, using partial selection rather than sorting every node.
+		 * @param[in] graph The graph to select from.
+		 * @param[in] count The number of nodes to return: 0 returns every node.
+		 * @return The selected node IDs, highest weighted degree first: ties are ordered by NodeId, so the result is the first count of the full order.
+		 */
+		std::vector<NodeId> I2LIB_API topNodesByWeightedDegree(const Graph &graph, std::size_t count);
+
+		/**
+		 * @brief Selects the nodes with the highest weighted degree from a weighted degree array (e.g. ShardedGraph::getWeightedDegrees).
+		 * @param[in] weightedDegree The weighted degree of each node, indexed by NodeId.
+		 * @param[in] count The number of nodes to return: 0 returns every node.
+		 * @return The selected node IDs, highest weighted degree first: ties are ordered by NodeId, so the result is the first count of the full order.
+		 */
+		std::vector<NodeId> I2LIB_API topNodesByWeightedDegree(std::span<const std::uint32_t> weightedDegree, std::size_t count);
+
+		/**
+		 * @brief Selects the nodes with the highest PageRank, using partial selection rather than sorting every rank.
+		 * @param[in] pageRank The rank of each node, indexed by NodeId (as returned by computePageRank).
+		 * @param[in] count The number of nodes to return: 0 returns every node.
+		 * @return The selected node IDs, highest rank first: ties are ordered by NodeId, so the result is the first count of the full order.
+		 */
+		std::vector<NodeId> I2LIB_API topNodesByRank(const std::vector<double> &pageRank, std::size_t count);
+
+		/**
+		 * @brief Selects the nodes with the highest weighted degree (as ordered by nodeCompareGT), using partial selection.
+		 * @param[in] nodeList The nodes to select from.
+		 * @param[in] count The number of nodes to return: 0 returns every node.
+		 * @return The selected nodes, highest weighted degree first: ties keep their node list order, as with std::stable_sort.
+		 */
+		std::vector<std::shared_ptr<Node>> I2LIB_API topNodes(const std::vector<std::shared_ptr<Node>> &nodeList, std::size_t count);
+
+		/**
+		 * @brief Selects the highest ranks (as ordered by pageRankComparatorGT), using partial selection.
+		 * @param[in] pageRank A list of ranked nodes (as returned by computePageRank).
+		 * @param[in] count The number of ranks to return: 0 returns every rank.
+		 * @return The selected ranks, highest first: ties keep their list order, as with std::stable_sort.
+		 */
+		std::vector<std::pair<std::shared_ptr<Node>,double>> I2LIB_API topPageRanks(const std::vector<std::pair<std::shared_ptr<Node>,double>> &pageRank, std::size_t count);
 	}
 }
 
@@ -0,0 +1,409 @@
+/*****************************************************************//**
+ * @file   pageRank.hpp
+ * @brief  Declarations of the dense-array PageRank engine, its out-of-core, incremental and personalized counterparts
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_PAGE_RANK_HPP
+#define I2_PAGE_RANK_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "i2/graph.hpp"
+#include "i2/rankKernels.hpp"
+#include "i2/compressedGraph.hpp"
+#include "i2/shardedGraph.hpp"
+#include "i2/threadPool.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @brief How a PageRank run decides that the ranks have converged.
+	 */
+	enum class StoppingRule
+	{
+		MaxNorm, // No node's rank changed by more than the tolerance in the last iteration
+		L1 // The rank changes of the last iteration sum to no more than the tolerance: stricter, as it bounds the total error
+	};
+
+	/**
+	 * @brief How a PageRank run speeds up convergence.
+	 */
+	enum class Acceleration
+	{
+		None, // Plain power iteration
+		Extrapolation, // Once the residuals shrink geometrically, jump ahead along the last rank change to where that series converges
+		GaussSeidel // Within each chunk of nodes, gather from the ranks already updated by the same iteration
+	};
+
+	/**
+	 * @brief Parameters controlling a PageRank run.
+	 */
+	struct PageRankOptions
+	{
+		double dampeningFactor = 0.85; // Ensures that nodes with fewer links are not penalised too much: controls the redistribution of ranks
+		double tolerance = 1e-1; // Ranking stops once the residual measured by stoppingRule is no more than this
+		double maxRankValue = 1e3; // Limit rank to 3-4 figures (e.g., max of 1000)
+		std::size_t threadCount = 1; // The number of threads to rank on: 0 uses one thread per hardware thread. Results do not depend on it
+		bool recordResiduals = false; // When true, the residual of every iteration is kept (see PageRankEngine::getResidualHistory)
+		StoppingRule stoppingRule = StoppingRule::MaxNorm;
+		std::size_t maxIterations = 0; // Ranking stops after this many iterations even if not converged (see PageRankEngine::hasConverged): 0 for no limit
+		Acceleration acceleration = Acceleration::None;
+	};
+
+	/**
+	 * @brief Parameters controlling a personalized PageRank query.
+	 */
+	struct PersonalizedPageRankOptions
+	{
+		double dampeningFactor = 0.85; // The probability of following a link rather than restarting from a seed
+		double tolerance = 1e-4; // Pushing stops once every node's residual is within tolerance * weightedDegree: smaller is more accurate but reaches further
+		std::size_t topK = 10; // The number of related nodes to return: 0 returns every node reached
+	};
+
+	/**
+	 * @class PageRankEngine
+	 * @brief Runs PageRank over a Graph using contiguous rank buffers indexed by NodeId
+	 *
+	 * Each node contributes rank * weight / linkCount to every linked node. The reciprocal of each node's link count is computed once, and each
+	 * iteration scales every rank by it before the neighbour sums are gathered, so the inner loop is one multiply-add per adjacency entry.
+	 * All buffers are allocated on construction and the current/next rank buffers are swapped between iterations, so iterating never allocates.
+	 *
+	 * The nodes are split into chunks of roughly equal adjacency size, fixed by the graph alone, and each iteration runs the chunks on a
+	 * WorkStealingPool. Every node's rank is accumulated in the same order by whichever thread runs it, and the per-chunk residuals are reduced
+	 * in chunk order, so the ranks are bit-identical for any thread count. The dense per-node step that follows each gather (dampening, clamping
+	 * and the residual) runs on the vectorised Kernels::dampen, which picks the widest instruction set the host supports at runtime.
+	 *
+	 * With Acceleration::Extrapolation each rank change is projected onto the one before it, giving the rate r at which the changes shrink. Once r
+	 * holds steady the remaining error is dominated by a single geometric series, so the ranks are moved on by r / (1 - r) times the last change:
+	 * the sum of that series. Convergence is still only declared by a plain iteration, so extrapolating changes how many iterations a run takes,
+	 * never the rule it stops by.
+	 *
+	 * With Acceleration::GaussSeidel each chunk is swept node by node, gathering from the new rank of any earlier node of the same chunk and the
+	 * previous rank of every other node, so results still do not depend on the thread count. It helps most when links fall within chunks (small
+	 * or locality-ordered graphs). On an unweighted graph ranked from an equal distribution, plain iteration keeps the total rank exact and is
+	 * usually faster, so the acceleration is worth measuring per graph (see PageRankOptions::recordResiduals).
+	 *
+	 * A CompressedGraph can be ranked in place of a Graph. Its rows are decoded as they are gathered, in the same order, so the ranks are
+	 * bit-identical to those of the uncompressed graph while each iteration reads far fewer bytes.
+	 */
+	class I2LIB_API PageRankEngine
+	{
+	private:
+		Graph _graph; // Copies of a Graph share its arrays, so holding one is cheap
+		CompressedGraph _compressedGraph; // Ranked in place of _graph when _isCompressed is set
+		bool _isCompressed = false;
+		std::vector<double> _normaliser; // 1 / linkCount for each node (1 for nodes without links)
+		std::vector<double> _rank, _nextRank; // Double buffer: swapped at the end of every iteration
+		std::vector<double> _contribution, _nextContribution; // rank * normaliser for each node: double buffered alongside the ranks
+		std::vector<double> _previousRank; // The ranks from two iterations back: only used by Acceleration::Extrapolation
+		std::vector<std::pair<double,double>> _chunkProduct; // The rate measurement's dot products within each chunk (see measureRate)
+		std::vector<NodeId> _chunkBegin; // chunkCount + 1 entries: the first node of each chunk
+		std::vector<Kernels::Residual> _chunkResidual; // How far the ranks within each chunk moved, for the iteration in progress
+		Kernels::Residual _residual; // How far the ranks moved in the last iteration
+		std::vector<Kernels::Residual> _residualHistory; // How far the ranks moved in each iteration of the last run, when recorded
+		std::unique_ptr<WorkStealingPool> _pool; // Created on the first run, and kept while the requested thread count is unchanged
+		std::size_t _poolThreadCount = 0; // The thread count _pool was requested with
+		std::size_t _iterationCount = 0;
+		std::size_t _extrapolationCount = 0;
+		bool _hasConverged = false;
+
+		void allocate(void);
+		void rankChunk(std::size_t chunk, double teleport, const PageRankOptions &options) noexcept;
+		void sweepChunk(std::size_t chunk, double teleport, const PageRankOptions &options) noexcept;
+		[[nodiscard]] double measureRate(void);
+		void extrapolate(double factor, const PageRankOptions &options);
+		const std::vector<double> &iterate(const PageRankOptions &options);
+
+	public:
+		/**
+		 * @brief Allocates the rank buffers and precomputes the per-node normalisers.
+		 * @param[in] graph The graph to rank
+		 */
+		explicit PageRankEngine(Graph graph);
+
+		/**
+		 * @brief Allocates the rank buffers and precomputes the per-node normalisers, ranking the compressed rows directly.
+		 * @param[in] graph The graph to rank
+		 */
+		explicit PageRankEngine(CompressedGraph graph);
+
+		/**
+		 * @brief Iterates from an equal distribution of rank until the ranks converge.
+		 * @param[in] options The dampening factor, tolerance, rank limit and thread count
+		 * @return The rank of each node, indexed by NodeId: valid until the next call to run
+		 */
+		const std::vector<double> &run(const PageRankOptions &options = PageRankOptions());
+
+		/**
+		 * @brief Iterates from the given ranks until the ranks converge: a good estimate (such as the ranks before a small edit) converges in fewer iterations.
+		 * @param[in] options The dampening factor, tolerance, rank limit and thread count
+		 * @param[in] initialRank The rank of each node to start from, indexed by NodeId: must hold one entry per node
+		 * @return The rank of each node, indexed by NodeId: valid until the next call to run
+		 */
+		const std::vector<double> &run(const PageRankOptions &options, const std::vector<double> &initialRank);
+
+		/**
+		 * @return The rank of each node after the last run, indexed by NodeId
+		 */
+		[[nodiscard]] const std::vector<double> &getRanks(void) const noexcept;
+
+		/**
+		 * @return The l1 and l-infinity norms of the rank change made by the last iteration of the last run
+		 */
+		[[nodiscard]] Kernels::Residual getResidual(void) const noexcept;
+
+		/**
+		 * @return The residual of every iteration of the last run, in order: empty unless PageRankOptions::recordResiduals was set
+		 */
+		[[nodiscard]] const std::vector<Kernels::Residual> &getResidualHistory(void) const noexcept;
+
+		/**
+		 * @return The number of iterations the last run needed to converge
+		 */
+		[[nodiscard]] std::size_t getIterationCount(void) const noexcept;
+
+		/**
+		 * @return The number of times the last run extrapolated the ranks (see Acceleration::Extrapolation)
+		 */
+		[[nodiscard]] std::size_t getExtrapolationCount(void) const noexcept;
+
+		/**
+		 * @return true if the last run met its stopping rule, false if it stopped at PageRankOptions::maxIterations first
+		 */
+		[[nodiscard]] bool hasConverged(void) const noexcept;
+	};
+
+	/**
+	 * @class OutOfCorePageRank
+	 * @brief Runs PageRank over a ShardedGraph, streaming its blocks from disk in every iteration
+	 *
+	 * Only the rank and contribution of every node are held in memory: each iteration reads the blocks in order, gathering each block's rows
+	 * from the contributions of the iteration before. While one block is ranked, the next is read on a background thread (wrapping around to the
+	 * first block for the next iteration), so ranking and reading overlap. A graph of a single block is read once and kept.
+	 *
+	 * Every block holds whole PageRankEngine chunks, and each chunk is gathered, dampened and reduced exactly as PageRankEngine does it, so the
+	 * ranks, residuals and iteration count match the in-memory engine bit for bit, for any thread count. Acceleration is not supported, as both
+	 * methods would need further per-node arrays (Gauss-Seidel would also need the blocks in memory at once to match).
+	 */
+	class I2LIB_API OutOfCorePageRank
+	{
+	private:
+		static constexpr std::size_t noBlock = static_cast<std::size_t>(-1);
+
+		const ShardedGraph &_graph;
+		std::vector<double> _rank; // Updated block by block: a node's previous rank is only needed until its own block is ranked
+		std::vector<double> _contribution, _nextContribution; // rank * normaliser for each node: double buffered, as every block gathers from the previous iteration
+		ShardedGraph::Block _block, _nextBlock; // The block being ranked and the block being read ahead
+		std::size_t _blockIndex = noBlock, _nextBlockIndex = noBlock; // Which blocks _block and _nextBlock hold
+		std::vector<double> _blockRank, _blockNormaliser; // The gathered rank sums and 1 / linkCount of each node of the block being ranked
+		std::vector<NodeId> _chunkBegin; // The first node of each chunk of the block being ranked, relative to the block
+		std::vector<Kernels::Residual> _chunkResidual;
+		Kernels::Residual _residual;
+		std::vector<Kernels::Residual> _residualHistory;
+		std::unique_ptr<WorkStealingPool> _pool;
+		std::size_t _poolThreadCount = 0;
+		std::size_t _iterationCount = 0;
+		bool _hasConverged = false;
+		TaskPool _reader; // Reads the next block: declared last, so it finishes before the blocks are destroyed
+
+		void prepareBlock(void);
+		void rankChunk(std::size_t chunk, double teleport, const PageRankOptions &options) noexcept;
+		void forEachBlock(const std::function<void(void)> &function);
+		const std::vector<double> &iterate(const PageRankOptions &options);
+
+	public:
+		/**
+		 * @brief Allocates the rank and contribution arrays.
+		 * @param[in] graph The graph to rank: must outlive the engine
+		 */
+		explicit OutOfCorePageRank(const ShardedGraph &graph);
+
+		/**
+		 * @brief Iterates from an equal distribution of rank until the ranks converge.
+		 * @param[in] options The dampening factor, tolerance, rank limit, thread count, stopping rule and iteration limit
+		 * @return The rank of each node, indexed by NodeId: valid until the next call to run
+		 * @throw std::runtime_error if a block cannot be read, or options.acceleration is set
+		 */
+		const std::vector<double> &run(const PageRankOptions &options = PageRankOptions());
+
+		/**
+		 * @brief Iterates from the given ranks until the ranks converge (see PageRankEngine::run).
+		 * @param[in] options The dampening factor, tolerance, rank limit, thread count, stopping rule and iteration limit
+		 * @param[in] initialRank The rank of each node to start from, indexed by NodeId: must hold one entry per node
+		 * @return The rank of each node, indexed by NodeId: valid until the next call to run
+		 * @throw std::runtime_error if a block cannot be read, or options.acceleration is set
+		 */
+		const std::vector<double> &run(const PageRankOptions &options, const std::vector<double> &initialRank);
+
+		/**
+		 * @return The rank of each node after the last run, indexed by NodeId
+		 */
+		[[nodiscard]] const std::vector<double> &getRanks(void) const noexcept;
+
+		/**
+		 * @return The l1 and l-infinity norms of the rank change made by the last iteration of the last run
+		 */
+		[[nodiscard]] Kernels::Residual getResidual(void) const noexcept;
+
+		/**
+		 * @return The residual of every iteration of the last run, in order: empty unless PageRankOptions::recordResiduals was set
+		 */
+		[[nodiscard]] const std::vector<Kernels::Residual> &getResidualHistory(void) const noexcept;
+
+		/**
+		 * @return The number of iterations the last run needed to converge
+		 */
+		[[nodiscard]] std::size_t getIterationCount(void) const noexcept;
+
+		/**
+		 * @return true if the last run met its stopping rule, false if it stopped at PageRankOptions::maxIterations first
+		 */
+		[[nodiscard]] bool hasConverged(void) const noexcept;
+	};
+
+	/**
+	 * @class IncrementalPageRank
+	 * @brief Keeps the PageRank of a list of linked Node instances up to date as links are added and removed
+	 *
+	 * The ranking subscribes to every node in the list and mirrors their links as dense rows, so a link edit only marks the nodes whose
+	 * rank equation it changed: the node that gained or lost the link, and the nodes that gather rank from it (its normaliser changed).
+	 * update re-evaluates those nodes from the previous ranks and only passes a change on to the nodes that gather from a node while it
+	 * moved by more than the tolerance, so a small edit costs time proportional to the neighbourhood it affects rather than to the graph.
+	 * Re-evaluating nodes one at a time converges to the same ranks as a full run, to within the tolerance of each local step: refresh
+	 * runs full iterations from the current ranks until the same stopping rule as NodeLoader::computePageRank is met.
+	 *
+	 * Links to nodes outside of the list are ignored, as with Graph::fromNodes. All member functions are thread safe.
+	 */
+	class I2LIB_API IncrementalPageRank : public LinkObserver
+	{
+	private:
+		std::vector<std::shared_ptr<Node>> _nodeList; // Keeps the subscribed nodes alive, so they can all be unsubscribed on destruction
+		std::unordered_map<const Node*, NodeId> _index; // Position of each node within _nodeList
+		std::vector<std::vector<std::pair<NodeId,std::uint32_t>>> _row; // The linked nodes (and weights) each node gathers rank from
+		std::vector<std::vector<NodeId>> _gatheredBy; // The nodes whose row holds each node: they are affected when its rank or link count changes
+		std::vector<double> _rank;
+		std::deque<NodeId> _pending; // Nodes whose rank equation may no longer hold, in the order they were affected
+		std::vector<bool> _isPending; // Whether each node is within _pending, so a node is never queued twice
+		PageRankOptions _options;
+		mutable std::mutex _lock; // Guards all of the above: notifications can arrive from any thread mutating a node
+
+		void markPending(NodeId id);
+		void markLinkChanged(NodeId id);
+		[[nodiscard]] double evaluate(NodeId id) const noexcept;
+		std::size_t propagate(void);
+
+	public:
+		/**
+		 * @brief Ranks the nodes with a full run (see PageRankEngine) and subscribes to their link changes.
+		 * @param[in] nodeList The nodes to rank
+		 * @param[in] options The dampening factor, tolerance, rank limit and thread count used by every update and refresh
+		 */
+		explicit IncrementalPageRank(std::vector<std::shared_ptr<Node>> nodeList, const PageRankOptions &options = PageRankOptions());
+
+		/**
+		 * @brief Unsubscribes from every node in the list.
+		 */
+		~IncrementalPageRank(void) override;
+
+		IncrementalPageRank(const IncrementalPageRank &other) = delete;
+		IncrementalPageRank &operator=(const IncrementalPageRank &other) = delete;
+
+		/**
+		 * @brief Applies the link edits received since the last update, re-evaluating only the nodes they affect.
+		 * @return The number of node re-evaluations performed (0 when no links changed)
+		 */
+		std::size_t update(void);
+
+		/**
+		 * @brief Applies any pending edits, then runs full iterations from the current ranks until no node's rank changes by more than the tolerance.
+		 * @return The number of full iterations performed
+		 */
+		std::size_t refresh(void);
+
+		/**
+		 * @brief Applies any pending edits (see update) and reports the current ranks.
+		 * @return A list of nodes with their associated PageRank, in node list order (as NodeLoader::computePageRank)
+		 */
+		[[nodiscard]] std::vector<std::pair<std::shared_ptr<Node>,double>> getRanks(void);
+
+		/**
+		 * @brief Applies any pending edits (see update) and reports the current rank of a node.
+		 * @param[in] node The node to query
+		 * @return The node's PageRank
+		 * @throw std::out_of_range when the node is not within the ranked node list
+		 */
+		[[nodiscard]] double getRank(const std::shared_ptr<Node> &node);
+
+		/**
+		 * @return The number of nodes whose rank equation has changed since the last update
+		 */
+		[[nodiscard]] std::size_t getPendingCount(void) const;
+
+		void onLinkAdded(Node &node, const std::shared_ptr<Node> &link, unsigned int weight) override;
+		void onLinkRemoved(Node &node, const std::shared_ptr<Node> &link, unsigned int weight) override;
+	};
+
+	/**
+	 * @class PersonalizedPageRank
+	 * @brief Answers "what matters relative to these nodes" with the local forward-push approximation of personalized PageRank
+	 *
+	 * Each seed starts with an equal share of residual probability. Pushing a node moves (1 - dampeningFactor) of its residual into its
+	 * score and spreads the rest over its links in proportion to their weight, and only nodes whose residual exceeds tolerance times their
+	 * weighted degree are pushed. The total residual pushed out of any node is at least tolerance * weightedDegree, so the work done depends
+	 * on the tolerance and the part of the graph the walk reaches, never on the size of the graph: per-query state lives in hash maps
+	 * holding only the nodes reached. A node without links keeps all of its residual as score.
+	 */
+	class I2LIB_API PersonalizedPageRank
+	{
+	private:
+		/**
+		 * @brief The push state of a node reached by the query in progress.
+		 */
+		struct State
+		{
+			double score = 0.0; // Probability settled on the node
+			double residual = 0.0; // Probability received but not yet pushed on
+			bool isQueued = false;
+		};
+
+		Graph _graph; // Copies of a Graph share its arrays, so holding one is cheap
+		std::unordered_map<NodeId, State> _state; // Cleared between queries but keeps its buckets, so repeated queries rarely allocate
+		std::deque<NodeId> _queue; // Nodes whose residual exceeds the push threshold
+		std::size_t _pushCount = 0;
+
+	public:
+		/**
+		 * @param[in] graph The graph to query
+		 */
+		explicit PersonalizedPageRank(Graph graph);
+
+		/**
+		 * @brief Scores the nodes related to the seeds.
+		 * @param[in] seeds The nodes to personalize on: each receives an equal share of the restart probability
+		 * @param[in] options The dampening factor, tolerance and the number of nodes to return
+		 * @return The top options.topK nodes by score (highest first, ties broken by lowest NodeId), including the seeds themselves
+		 * @throw std::out_of_range when a seed is not a node of the graph
+		 * @throw std::runtime_error when no seeds are provided
+		 */
+		[[nodiscard]] std::vector<std::pair<NodeId,double>> run(std::span<const NodeId> seeds, const PersonalizedPageRankOptions &options = PersonalizedPageRankOptions());
+
+		/**
+		 * @return The number of pushes the last run performed: a measure of its cost
+		 */
+		[[nodiscard]] std::size_t getPushCount(void) const noexcept;
+	};
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*****************************************************************//**
+ * @file   rankKernels.hpp
+ * @brief  Vectorised kernels for the dense parts of a PageRank iteration, with the instruction set chosen at runtime
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_RANK_KERNELS_HPP
+#define I2_RANK_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	namespace Kernels
+	{
+		/**
+		 * @brief The instruction sets the kernels are implemented for.
+		 */
+		enum class InstructionSet
+		{
+			Scalar, // Portable fallback, used on every host
+			AVX2, // 4 doubles per instruction
+			AVX512 // 8 doubles per instruction
+		};
+
+		/**
+		 * @brief The target number of adjacency entries (plus nodes) per chunk of an iteration: large enough to amortise scheduling.
+		 * @details A chunk closes after the node that reaches it, or the last node. Every engine chunks the nodes this way and reduces the
+		 * per-chunk residuals in chunk order, so they all measure identical residuals (see PageRankEngine and OutOfCorePageRank).
+		 */
+		constexpr std::uint64_t chunkSize = 4096;
+
+		/**
+		 * @brief How far the ranks moved during one iteration.
+		 */
+		struct Residual
+		{
+			double l1 = 0.0; // Sum of the absolute rank changes
+			double lInf = 0.0; // Largest absolute rank change
+		};
+
+		/**
+		 * @return The best instruction set supported by both this build and the host CPU (detected once, on first use)
+		 */
+		[[nodiscard]] InstructionSet I2LIB_API getSupportedInstructionSet(void) noexcept;
+
+		/**
+		 * @return The instruction set the kernels currently dispatch to
+		 */
+		[[nodiscard]] InstructionSet I2LIB_API getInstructionSet(void) noexcept;
+
+		/**
+		 * @brief Overrides the dispatched instruction set, e.g. to compare implementations: requests beyond getSupportedInstructionSet are lowered to it.
+		 * @param[in] instructionSet The instruction set to dispatch to
+		 * @return The instruction set that will be dispatched to
+		 */
+		InstructionSet I2LIB_API setInstructionSet(InstructionSet instructionSet) noexcept;
+
+		/**
+		 * @param[in] instructionSet The instruction set to name
+		 * @return A short lower-case name, e.g. "avx2"
+		 */
+		[[nodiscard]] std::string_view I2LIB_API getInstructionSetName(InstructionSet instructionSet) noexcept;
+
+		/**
+		 * @brief Applies the teleport and dampening step to gathered rank sums, clamps them, prepares the next contributions and measures the residual.
+		 * @details For each i: nextRank[i] = min(teleport + dampeningFactor * nextRank[i], maxRankValue), nextContribution[i] = nextRank[i] * normaliser[i].
+		 * Ranks and contributions are bit-identical for every instruction set (no fused multiply-add is used), so only the l1 residual's rounding
+		 * can differ between instruction sets, as its partial sums are accumulated per vector lane.
+		 * @param[in] rank The ranks of the previous iteration
+		 * @param[in,out] nextRank The gathered rank sums on input, the new ranks on output
+		 * @param[out] nextContribution The new ranks multiplied by normaliser
+		 * @param[in] normaliser The reciprocal link count of each node
+		 * @param[in] count The number of nodes to process
+		 * @param[in] teleport The rank every node receives regardless of its links: (1 - dampeningFactor) / nodeCount
+		 * @param[in] dampeningFactor The share of rank passed on through links
+		 * @param[in] maxRankValue The limit ranks are clamped to
+		 * @return The l1 and l-infinity norms of nextRank - rank
+		 */
+		Residual I2LIB_API dampen(const double *rank, double *nextRank, double *nextContribution, const double *normaliser, std::size_t count, double teleport, double dampeningFactor, double maxRankValue) noexcept;
+	}
+}
+
+#endif
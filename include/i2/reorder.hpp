@@ -0,0 +1,124 @@
+/*****************************************************************//**
+ * @file   reorder.hpp
+ * @brief  Declarations of the node reorderings that lay a graph out so linked nodes sit close together in memory
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_REORDER_HPP
+#define I2_REORDER_HPP
+
+#include <ranges>
+#include <span>
+#include <vector>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @brief Relabels the nodes of a graph to improve the locality of neighbour accesses.
+	 *
+	 * Node IDs usually follow the input order, which places linked nodes far apart, so nearly every neighbour access of a PageRank iteration
+	 * misses the cache. A reordering is computed (see computeOrdering) and applied (see apply) once after loading: names move with their nodes,
+	 * and the Permutation maps results back to the original IDs.
+	 */
+	namespace Reorder
+	{
+		/**
+		 * @brief How the nodes are reordered.
+		 */
+		enum class Ordering
+		{
+			Degree, // By link count, most linked first: the hubs, whose ranks every iteration reads most, share cache lines
+			ReverseCuthillMcKee, // Breadth first from a low-degree node, visiting neighbours by ascending degree, then reversed: keeps each node's links close to it
+			Community // Rabbit-style: nodes are merged into the neighbouring community with the best modularity gain, and each community is numbered contiguously
+		};
+
+		/**
+		 * @class Permutation
+		 * @brief Maps between the original and reordered IDs of a graph's nodes: an empty permutation is the identity
+		 */
+		class I2LIB_API Permutation
+		{
+		private:
+			std::vector<NodeId> _originalId; // Indexed by reordered ID
+			std::vector<NodeId> _reorderedId; // Indexed by original ID
+
+		public:
+			/**
+			 * @brief Constructs the identity permutation.
+			 */
+			Permutation(void);
+
+			/**
+			 * @brief Constructs a permutation from the original ID of each reordered node.
+			 * @param[in] originalId The original ID of each node, indexed by its reordered ID: each ID from 0 to originalId.size() - 1 must appear once
+			 * @throw std::runtime_error if originalId is not a permutation
+			 */
+			explicit Permutation(std::vector<NodeId> originalId);
+
+			/**
+			 * @return true if the permutation is the identity (it was default constructed)
+			 */
+			[[nodiscard]] bool isIdentity(void) const noexcept;
+
+			/**
+			 * @return The number of nodes permuted: 0 for the identity
+			 */
+			[[nodiscard]] std::size_t size(void) const noexcept;
+
+			/**
+			 * @param[in] id A reordered ID
+			 * @return The node's original ID
+			 */
+			[[nodiscard]] NodeId toOriginal(NodeId id) const noexcept;
+
+			/**
+			 * @param[in] id An original ID
+			 * @return The node's reordered ID
+			 */
+			[[nodiscard]] NodeId toReordered(NodeId id) const noexcept;
+
+			/**
+			 * @brief Puts per-node values (such as ranks) computed over the reordered graph back into the original order.
+			 * @param[in] value The value of each node, indexed by reordered ID
+			 * @return The value of each node, indexed by original ID
+			 */
+			template<std::ranges::random_access_range Range>
+			[[nodiscard]] std::vector<std::ranges::range_value_t<Range>> restore(const Range &value) const
+			{
+				std::vector<std::ranges::range_value_t<Range>> result(std::ranges::begin(value), std::ranges::end(value));
+
+				for(std::size_t i=0;i<this->_originalId.size();++i)
+					result[this->_originalId[i]] = value[i];
+
+				return result;
+			}
+		};
+
+		/**
+		 * @brief Computes an ordering of a graph's nodes: single threaded, and linear in the size of the graph (bar sorting).
+		 * @param[in] graph The graph to order
+		 * @param[in] ordering The ordering to compute
+		 * @return The permutation from the graph's IDs to the ordered IDs
+		 */
+		[[nodiscard]] I2LIB_API Permutation computeOrdering(const Graph &graph, Ordering ordering);
+
+		/**
+		 * @brief Builds the graph relabelled by a permutation: node i of the result is node permutation.toOriginal(i) of the graph, keeping its
+		 * name, links and weights. Rows are sorted by target, as GraphBuilder sorts them.
+		 * @param[in] graph The graph to relabel
+		 * @param[in] permutation The permutation to apply: the identity returns the graph itself
+		 * @param[in] threadCount The number of threads to build the rows on: 0 uses one thread per hardware thread. The result does not depend on it
+		 * @return The relabelled graph
+		 * @throw std::runtime_error if the permutation does not match the graph's node count
+		 */
+		[[nodiscard]] I2LIB_API Graph apply(const Graph &graph, const Permutation &permutation, std::size_t threadCount = 1);
+	}
+}
+
+#endif
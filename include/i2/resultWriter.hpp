@@ -0,0 +1,107 @@
+/*****************************************************************//**
+ * @file   resultWriter.hpp
+ * @brief  Declarations of a buffered writer of per-node results (degrees, ranks and scores) in text, CSV, JSON Lines or packed binary
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_RESULT_WRITER_HPP
+#define I2_RESULT_WRITER_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @brief The layouts a ResultWriter can produce.
+	 */
+	enum class OutputFormat
+	{
+		Text, // "name: value" lines, with a blank line between sections: the layout i2GroupTechTest has always printed
+		CSV, // A "section,id,node,value" header, then one row per node: names are quoted when they hold a comma, quote or line break
+		JSONLines, // One {"section","id","node","value"} object per line
+		Binary // Per section: a uint64 row count, then packed {uint32 id; float64 value} records (12 bytes each), in native byte order
+	};
+
+	/**
+	 * @class ResultWriter
+	 * @brief Formats results into a large buffer with std::to_chars and writes it out in as few calls as possible
+	 *
+	 * Results are written as sections (e.g. the nodes by weighted degree, then by rank), each a run of rows naming a node and its value.
+	 * Nothing is flushed per row: the buffer is written out whenever it fills, on flush and on destruction. Text output prints each section's
+	 * values with a fixed number of decimals, as the tech test always has. CSV and JSON Lines print the shortest digits that read back exactly.
+	 */
+	class I2LIB_API ResultWriter
+	{
+	private:
+		std::ofstream _file; // Only open when writing to a path
+		std::ostream *_output;
+		OutputFormat _format;
+		std::string _buffer;
+		std::size_t _capacity; // The buffer is written out once it holds this many bytes
+		std::string _section; // The name of the current section
+		int _decimals = 0; // The decimals Text output prints in the current section
+		std::size_t _sectionCount = 0;
+
+		void flushIfFull(void);
+
+	public:
+		/**
+		 * @brief Writes to an existing stream (e.g. std::cout).
+		 * @param[out] output The stream to write to: must outlive the writer
+		 * @param[in] format The layout to write
+		 * @param[in] bufferSize The number of bytes buffered between writes
+		 */
+		ResultWriter(std::ostream &output, OutputFormat format = OutputFormat::Text, std::size_t bufferSize = 1 << 20);
+
+		/**
+		 * @brief Writes to a file, replacing any existing file.
+		 * @param[in] path The path to write to
+		 * @param[in] format The layout to write
+		 * @param[in] bufferSize The number of bytes buffered between writes
+		 * @throw std::runtime_error if the file could not be opened
+		 */
+		ResultWriter(const std::string &path, OutputFormat format = OutputFormat::Text, std::size_t bufferSize = 1 << 20);
+
+		/**
+		 * @brief Writes out anything still buffered: errors are ignored, so call flush to detect them.
+		 */
+		~ResultWriter(void);
+
+		ResultWriter(const ResultWriter &other) = delete;
+		ResultWriter &operator=(const ResultWriter &other) = delete;
+
+		/**
+		 * @brief Starts a section of rows.
+		 * @param[in] name The section name written by CSV and JSON Lines (e.g. "degree" or "rank")
+		 * @param[in] rowCount The number of rows that will be written to the section: recorded by Binary output
+		 * @param[in] decimals The number of decimals Text output prints each value with
+		 */
+		void beginSection(std::string_view name, std::size_t rowCount, int decimals = 0);
+
+		/**
+		 * @brief Writes a row of the current section.
+		 * @param[in] name The node's name
+		 * @param[in] id The node's ID
+		 * @param[in] value The node's result (weighted degrees are exact as doubles)
+		 */
+		void writeRow(std::string_view name, NodeId id, double value);
+
+		/**
+		 * @brief Writes out everything buffered and flushes the stream.
+		 * @throw std::runtime_error if the stream reports a write error
+		 */
+		void flush(void);
+	};
+}
+
+#endif
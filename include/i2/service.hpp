@@ -0,0 +1,137 @@
+/*****************************************************************//**
+ * @file   service.hpp
+ * @brief  Declarations of the resident scoring service: a loaded graph answering newline-delimited JSON requests
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_SERVICE_HPP
+#define I2_SERVICE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "i2/pageRank.hpp"
+#include "i2/versionedGraph.hpp"
+#include "i2/directives.hpp"
+
+namespace Json
+{
+	class Value;
+}
+
+namespace I2
+{
+	/**
+	 * @brief Parameters controlling a Service.
+	 */
+	struct ServiceOptions
+	{
+		PageRankOptions rank; // Used whenever the ranks are (re)computed: each computation warm starts from the previous ranks
+		std::size_t threadCount = 0; // The number of threads requests are answered on: 0 uses one thread per hardware thread
+		std::size_t cacheCapacity = 4096; // Cached responses are discarded once this many are held, as well as whenever the graph changes
+	};
+
+	/**
+	 * @class Service
+	 * @brief Keeps a graph in memory and answers newline-delimited JSON requests about it, from a stream or a Unix domain socket
+	 *
+	 * Each request is one JSON object on one line, with an "op" and its arguments. Nodes are named, as in the input file:
+	 * - {"op":"top","by":"degree"|"rank","k":10}: the k highest nodes by weighted degree or PageRank (k of 0 returns every node)
+	 * - {"op":"degree","node":"X"} and {"op":"rank","node":"X"}: one node's weighted degree or PageRank
+	 * - {"op":"addNode","node":"X"}, {"op":"addLink","source":"X","target":"Y","weight":1} and {"op":"removeLink","source":"X","target":"Y"}
+	 * - {"op":"recompute"}: brings the ranks up to date now, rather than on the next rank query
+	 * - {"op":"shutdown"}: stops serving once the requests already received have been answered
+	 *
+	 * Each response is one line: {"id":...,"ok":true,"epoch":N,"result":...} or {"id":...,"ok":false,"error":"..."}, where id echoes the
+	 * request's optional "id" and epoch is the graph version the answer was computed from (see VersionedGraph).
+	 *
+	 * Reads run concurrently on a TaskPool against a pinned graph version, so responses may arrive out of order: match them by id. A write waits
+	 * for its connection's earlier reads and finishes before its later ones are read, so every connection sees its own writes in order. Each
+	 * write publishes a new version, copying the graph's arrays once. Responses are cached per request until the graph changes, and the ranks
+	 * are computed at most once per version, when first asked for.
+	 */
+	class I2LIB_API Service
+	{
+	private:
+		/**
+		 * @brief The PageRank of one graph version.
+		 */
+		struct Ranking
+		{
+			std::uint64_t epoch;
+			std::vector<double> rank; // Indexed by NodeId
+			std::size_t iterationCount;
+		};
+
+		VersionedGraph _graph;
+		ServiceOptions _options;
+		std::mutex _writeLock; // Serialises writes, so each one looks nodes up and publishes against the latest version
+
+		std::mutex _rankLock; // Held while ranking, so concurrent rank queries share one computation
+		std::shared_ptr<const Ranking> _ranking; // The latest ranks computed: may be of an older version
+
+		std::shared_mutex _cacheLock; // Guards the cache below
+		std::unordered_map<std::string, std::string> _cache; // Serialised results, keyed by the request's op and arguments
+		std::uint64_t _cacheEpoch = 0; // The version every cached result was computed from
+
+		std::atomic<bool> _stopping = false;
+
+		class Session; // One stream or connection being served
+
+		/**
+		 * @return The ranks of the given version, computed now if they have not been already
+		 */
+		[[nodiscard]] std::shared_ptr<const Ranking> rank(const std::shared_ptr<const VersionedGraph::Version> &version);
+		[[nodiscard]] std::string read(const Json::Value &request, std::uint64_t &epoch);
+		[[nodiscard]] std::string write(const Json::Value &request, std::uint64_t &epoch);
+		[[nodiscard]] std::string answer(const Json::Value &request);
+		void receive(const std::shared_ptr<Session> &session, TaskPool &pool, std::string_view line);
+
+	public:
+		/**
+		 * @param[in] graph The graph to serve (e.g. as loaded by NodeLoader::loadGraphFromFile)
+		 * @param[in] options The rank options, thread count and cache capacity
+		 */
+		explicit Service(Graph graph, const ServiceOptions &options = ServiceOptions());
+
+		/**
+		 * @brief Answers a single request on the calling thread: thread safe.
+		 * @param[in] request One JSON request (see the class description)
+		 * @return The response line, without a trailing newline: errors are reported within the response rather than thrown
+		 */
+		[[nodiscard]] std::string handle(std::string_view request);
+
+		/**
+		 * @brief Answers requests read from input, one per line, until the input ends or a shutdown request is answered.
+		 * @param[in] input The stream to read requests from (e.g. std::cin)
+		 * @param[out] output The stream to write responses to: each is written (and flushed) as soon as it is ready
+		 */
+		void serve(std::istream &input, std::ostream &output);
+
+		/**
+		 * @brief Listens on a Unix domain socket, answering requests from any number of connections, until a shutdown request is answered.
+		 * @param[in] path The path to create the socket at: an existing socket at the path is replaced, and the socket is removed on return
+		 * @throw std::runtime_error if the socket could not be created, or Unix domain sockets are not supported on this platform
+		 */
+		void serveSocket(const std::string &path);
+
+		/**
+		 * @return The epoch of the latest graph version
+		 */
+		[[nodiscard]] std::uint64_t getEpoch(void) const;
+	};
+}
+
+#endif
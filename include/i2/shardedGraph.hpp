@@ -0,0 +1,158 @@
+/*****************************************************************//**
+ * @file   shardedGraph.hpp
+ * @brief  Declarations of an on-disk graph, split into blocks of adjacency rows that are streamed through memory
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_SHARDED_GRAPH_HPP
+#define I2_SHARDED_GRAPH_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+#include "i2/edgeList.hpp"
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @brief Parameters controlling how a ShardedGraph is laid out on disk.
+	 */
+	struct ShardOptions
+	{
+		std::size_t memoryBudget = std::size_t(1) << 30; // Bytes: the per-node arrays and the blocks held in memory (while building or ranking) stay within this
+		std::string directory = ""; // Where the blocks are written, within a new subdirectory: "" uses the system temporary directory
+	};
+
+	/**
+	 * @class ShardedGraph
+	 * @brief A graph too large to hold in memory, kept on disk as blocks of CSR adjacency rows
+	 *
+	 * The rows are the same as those of the Graph that EdgeList::loadText or EdgeList::loadBinary would build from the edge list: links are
+	 * stored in both directions, validated with the same rules and merged by the same duplicate policy. Only the weighted degree of each node
+	 * is kept in memory, and a block is read whenever it is needed (see readBlock).
+	 *
+	 * Building makes two passes over the edge list. The first validates the links and counts the entries of every row. The second routes each
+	 * entry to a shard file holding a range of rows sized to the memory budget. Each shard is then sorted and merged in memory and written out as
+	 * blocks. Blocks only end where PageRankEngine would end a chunk, so OutOfCorePageRank reproduces its ranks exactly. The per-node arrays
+	 * (see getResidentBytesPerNode) are set aside from the memory budget first, and the shards and blocks are sized to fit in what remains.
+	 *
+	 * The files are removed when the graph is destroyed.
+	 */
+	class I2LIB_API ShardedGraph
+	{
+	public:
+		/**
+		 * @brief A block of consecutive adjacency rows, read into memory.
+		 */
+		struct Block
+		{
+			NodeId begin = 0; // The first node of the block
+			NodeId end = 0; // One past the last node of the block
+			std::vector<std::uint64_t> offset; // end - begin + 1 entries: the start of each row within target/weight
+			std::vector<NodeId> target; // The linked node of each adjacency entry
+			std::vector<std::uint32_t> weight; // The weight of each adjacency entry
+		};
+
+	private:
+		/**
+		 * @brief Where a block lives on disk.
+		 */
+		struct BlockFile
+		{
+			NodeId begin;
+			NodeId end;
+			std::uint64_t entryCount;
+			std::filesystem::path path;
+		};
+
+		std::filesystem::path _directory; // Created by the graph, and removed with it
+		std::vector<BlockFile> _block;
+		std::vector<std::uint32_t> _weightedDegree;
+		std::string _namesPath;
+		std::uint64_t _entryCount = 0;
+		std::size_t _memoryBudget = 0;
+
+		ShardedGraph(void) = default;
+
+	public:
+		/**
+		 * @brief Shards an edge list onto disk, reading it twice through a fixed-size buffer.
+		 * @param[in] path The path to a text or binary edge list (see EdgeList::detectFormat)
+		 * @param[in] options The delimiter, names sidecar, self-link rule and duplicate policy, as for EdgeList::loadText
+		 * @param[in] shardOptions The memory budget and the directory to write the blocks to
+		 * @return The sharded graph
+		 * @throw std::runtime_error if the edge list cannot be read, the budget cannot hold the per-node arrays (or a single row), or with the
+		 * same errors as EdgeList::loadText for invalid and (under DuplicatePolicy::Reject) repeated links
+		 */
+		[[nodiscard]] static ShardedGraph fromEdgeList(const std::string &path, const EdgeList::Options &options = EdgeList::Options(), const ShardOptions &shardOptions = ShardOptions());
+
+		/**
+		 * @brief Removes the block files.
+		 */
+		~ShardedGraph(void);
+
+		ShardedGraph(ShardedGraph &&other) noexcept;
+		ShardedGraph &operator=(ShardedGraph &&other) noexcept;
+		ShardedGraph(const ShardedGraph &other) = delete;
+		ShardedGraph &operator=(const ShardedGraph &other) = delete;
+
+		/**
+		 * @return The total number of nodes
+		 */
+		[[nodiscard]] std::size_t getNodeCount(void) const noexcept;
+
+		/**
+		 * @return The total number of adjacency entries (each undirected link is counted once per direction)
+		 */
+		[[nodiscard]] std::uint64_t getEntryCount(void) const noexcept;
+
+		/**
+		 * @return The number of blocks the rows are split into
+		 */
+		[[nodiscard]] std::size_t getBlockCount(void) const noexcept;
+
+		/**
+		 * @return The memory budget the graph was sharded for
+		 */
+		[[nodiscard]] std::size_t getMemoryBudget(void) const noexcept;
+
+		/**
+		 * @return The accumulation of each node's link weights, indexed by NodeId (as Graph::getWeightedDegree)
+		 */
+		[[nodiscard]] std::span<const std::uint32_t> getWeightedDegrees(void) const noexcept;
+
+		/**
+		 * @brief Reads a block from disk: the block's arrays are reused, so reading into the same block again rarely allocates.
+		 * @param[in] index The block to read, from 0 to getBlockCount() - 1
+		 * @param[out] block Receives the block's rows
+		 * @throw std::runtime_error if the block file cannot be read
+		 */
+		void readBlock(std::size_t index, Block &block) const;
+
+		/**
+		 * @brief Looks up the names of some nodes, streaming the names sidecar rather than holding every name in memory.
+		 * @param[in] id The nodes to name
+		 * @return The name of each node, in the same order: nodes are named by ID when the edge list had no names sidecar
+		 * @throw std::runtime_error if the names sidecar cannot be read
+		 */
+		[[nodiscard]] std::vector<std::string> getNames(std::span<const NodeId> id) const;
+
+		/**
+		 * @return The bytes per node held in memory while ranking: the weighted degree, and OutOfCorePageRank's rank and contribution arrays
+		 */
+		[[nodiscard]] static constexpr std::size_t getResidentBytesPerNode(void) noexcept
+		{
+			return sizeof(std::uint32_t) + 3 * sizeof(double);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*****************************************************************//**
+ * @file   snapshot.hpp
+ * @brief  Binary graph snapshots that can be memory mapped, so a graph can be re-opened without parsing or rebuilding it
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_SNAPSHOT_HPP
+#define I2_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	namespace Snapshot
+	{
+		/**
+		 * @brief The current snapshot format version: bumped whenever the file layout changes.
+		 */
+		constexpr std::uint32_t formatVersion = 1;
+
+		/**
+		 * @brief Writes the graph as a binary snapshot.
+		 * @details The file starts with a 64 byte header (magic "I2GRAPH", version, byte order tag and array sizes) followed by the arrays of
+		 * Graph::Layout, each aligned to 8 bytes, in host byte order. A snapshot can only be opened on a host with the same byte order.
+		 * @param[in] graph The graph to write
+		 * @param[in] path The path of the snapshot file to create (overwritten if it exists)
+		 * @throw std::runtime_error if the file could not be written
+		 */
+		void I2LIB_API saveToFile(const Graph &graph, std::string path);
+
+		/**
+		 * @brief Memory maps a snapshot and returns a graph that views the mapped arrays directly, without deserialising them.
+		 * @details Opening takes constant time: only the header is read, and its counts are checked against the file size. The arrays are
+		 * trusted unless validate is set, which reads every offset and target (so pages in the whole file) before returning.
+		 * @param[in] path The path of the snapshot file
+		 * @param[in] validate When true, also checks that every row and name lies within its array and every link reaches a node: use it for
+		 * snapshots from an untrusted source
+		 * @return The graph: the file stays mapped until the graph (and every copy of it) is destroyed
+		 * @throw std::runtime_error if the file is not a snapshot, has an unsupported version or byte order, or is truncated (or, when
+		 * validating, corrupt)
+		 */
+		Graph I2LIB_API loadFromFile(std::string path, bool validate = false);
+
+		/**
+		 * @brief Checks the magic bytes at the start of a file, so loaders can detect the format automatically.
+		 * @param[in] path The path to the file
+		 * @return true if the file starts with the snapshot magic bytes
+		 */
+		bool I2LIB_API isSnapshotFile(std::string path);
+	}
+}
+
+#endif
@@ -0,0 +1,162 @@
+/*****************************************************************//**
+ * @file   stats.hpp
+ * @brief  Declarations of the phase timing and ranking telemetry recorder, and its process measurements
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_STATS_HPP
+#define I2_STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "i2/rankKernels.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	namespace Stats
+	{
+		/**
+		 * @brief The cost of one timed phase of a job.
+		 */
+		struct Phase
+		{
+			std::string name;
+			double wallSeconds = 0.0;
+			double cpuSeconds = 0.0; // Process CPU time, summed over every thread
+			std::uint64_t allocationCount = 0; // Calls to operator new: 0 unless the program counts them (see noteAllocation)
+		};
+
+		/**
+		 * @brief Everything recorded about a job.
+		 */
+		struct Report
+		{
+			std::vector<Phase> phase; // In the order the phases started
+			std::size_t iterationCount = 0; // PageRank iterations, when a ranking was recorded
+			std::vector<Kernels::Residual> residual; // How far the ranks moved in each iteration (see PageRankOptions::recordResiduals)
+			std::size_t adjacencyBytes = 0; // The bytes of adjacency rows each PageRank iteration reads, when a ranking was recorded (see CompressedGraph::getAdjacencyBytes)
+			std::size_t peakRSS = 0; // The peak resident set size of the process, in bytes (0 where it cannot be measured)
+		};
+
+		/**
+		 * @class Recorder
+		 * @brief Collects a Report: phases are timed by holding the object returned by time for the duration of the phase
+		 *
+		 * A disabled recorder reads no clocks and records nothing, so instrumented code costs a branch per phase when telemetry is off.
+		 */
+		class I2LIB_API Recorder
+		{
+		private:
+			Report _report;
+			bool _enabled;
+
+		public:
+			/**
+			 * @class ScopedPhase
+			 * @brief Times a phase from construction to destruction
+			 */
+			class I2LIB_API ScopedPhase
+			{
+			private:
+				Recorder *_recorder; // nullptr when the recorder is disabled
+				std::size_t _index;
+				std::chrono::steady_clock::time_point _wallStart;
+				double _cpuStart;
+				std::uint64_t _allocationStart;
+
+			public:
+				ScopedPhase(Recorder *recorder, std::string_view name);
+				~ScopedPhase(void);
+
+				ScopedPhase(const ScopedPhase &other) = delete;
+				ScopedPhase &operator=(const ScopedPhase &other) = delete;
+			};
+
+			/**
+			 * @param[in] enabled When false nothing is recorded (see the class description)
+			 */
+			explicit Recorder(bool enabled = true);
+
+			/**
+			 * @brief Stops counting allocations, unless another recorder is enabled.
+			 */
+			~Recorder(void);
+
+			Recorder(const Recorder &other) = delete;
+			Recorder &operator=(const Recorder &other) = delete;
+
+			/**
+			 * @return true if the recorder is recording
+			 */
+			[[nodiscard]] bool isEnabled(void) const noexcept;
+
+			/**
+			 * @brief Starts timing a phase: it ends when the returned object is destroyed.
+			 * @param[in] name The name the phase is reported under
+			 * @return The phase timer: keep it in scope for the duration of the phase
+			 */
+			[[nodiscard]] ScopedPhase time(std::string_view name);
+
+			/**
+			 * @brief Records how a PageRank run converged (see PageRankEngine::getIterationCount and getResidualHistory).
+			 * @param[in] iterationCount The number of iterations the run took
+			 * @param[in] residual The residual of each iteration: empty if they were not recorded
+			 */
+			void recordRanking(std::size_t iterationCount, std::span<const Kernels::Residual> residual);
+
+			/**
+			 * @brief Records the size of the adjacency layout that was ranked, so compressed and uncompressed runs can be compared.
+			 * @param[in] adjacencyBytes The bytes of the offset and row arrays
+			 */
+			void recordAdjacency(std::size_t adjacencyBytes);
+
+			/**
+			 * @brief Measures the peak resident set size and reports everything recorded so far.
+			 * @return The report: empty if the recorder is disabled
+			 */
+			[[nodiscard]] const Report &finish(void);
+		};
+
+		/**
+		 * @brief Counts one call to operator new while a Recorder is enabled.
+		 * @details The library cannot see allocations by itself: a program that wants allocation counts replaces the global operator new
+		 * and calls this from it (as i2GroupTechTest does). It costs one relaxed atomic load when no recorder is enabled.
+		 */
+		I2LIB_API void noteAllocation(void) noexcept;
+
+		/**
+		 * @return The number of allocations noted so far
+		 */
+		[[nodiscard]] I2LIB_API std::uint64_t getAllocationCount(void) noexcept;
+
+		/**
+		 * @return The CPU time used by the process so far, in seconds, summed over every thread
+		 */
+		[[nodiscard]] I2LIB_API double getCPUSeconds(void) noexcept;
+
+		/**
+		 * @return The peak resident set size of the process so far, in bytes (0 where it cannot be measured)
+		 */
+		[[nodiscard]] I2LIB_API std::size_t getPeakRSS(void) noexcept;
+
+		/**
+		 * @brief Writes a report as a single JSON object: {"phases":[{"name","wallSeconds","cpuSeconds","allocations"}...],
+		 * "iterations", "residuals":[{"l1","lInf"}...], "peakRSSBytes", "adjacencyBytes"}.
+		 * @param[in] report The report to write
+		 * @param[out] output The stream to write to
+		 */
+		I2LIB_API void writeJSON(const Report &report, std::ostream &output);
+	}
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*****************************************************************//**
+ * @file   threadPool.hpp
+ * @brief  Declarations of a work-stealing thread pool for data-parallel loops, and a task queue pool for independent jobs
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_THREAD_POOL_HPP
+#define I2_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @class WorkStealingPool
+	 * @brief Runs the tasks of a parallel loop across a fixed set of threads, rebalancing uneven tasks by stealing
+	 *
+	 * Each thread is handed an equal, contiguous share of the task indexes and works through it from the front. A thread that runs out of work
+	 * steals half of the remaining tasks from the back of the busiest share, so a few expensive tasks (e.g. high-degree hub nodes) do not leave
+	 * the other threads idle. The calling thread takes part in every loop, so a pool of one thread runs everything inline.
+	 */
+	class I2LIB_API WorkStealingPool
+	{
+	private:
+		/**
+		 * @brief The remaining task indexes [begin, end) owned by one thread.
+		 */
+		struct Share
+		{
+			std::mutex lock;
+			std::size_t begin = 0;
+			std::size_t end = 0;
+		};
+
+		using TaskFunction = void(*)(void *context, std::size_t task);
+
+		std::vector<std::thread> _worker;
+		std::vector<std::unique_ptr<Share>> _share; // One per thread, including the calling thread (index 0)
+		std::mutex _lock;
+		std::condition_variable _wake, _done;
+		TaskFunction _function = nullptr;
+		void *_context = nullptr;
+		std::size_t _generation = 0, _running = 0;
+		std::exception_ptr _error;
+		bool _stopping = false;
+
+		void workerLoop(std::size_t index);
+		void runShare(std::size_t index);
+		bool steal(std::size_t index);
+		void run(std::size_t taskCount, TaskFunction function, void *context);
+
+	public:
+		/**
+		 * @brief Starts threadCount - 1 worker threads (the calling thread is the remaining one).
+		 * @param[in] threadCount The number of threads to run loops on: 0 uses one thread per hardware thread
+		 */
+		explicit WorkStealingPool(std::size_t threadCount = 0);
+
+		WorkStealingPool(const WorkStealingPool &) = delete;
+		WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+		/**
+		 * @brief Stops and joins the worker threads.
+		 */
+		~WorkStealingPool(void);
+
+		/**
+		 * @return The number of threads loops are run on, including the calling thread
+		 */
+		[[nodiscard]] std::size_t getThreadCount(void) const noexcept;
+
+		/**
+		 * @brief Calls task(i) for every i in [0, taskCount), spread across the pool, and waits for all of them to finish.
+		 * @details The task is called by reference and never copied or allocated, so loops can be run repeatedly without allocating.
+		 * The first exception thrown by a task is rethrown here once the loop has finished.
+		 * @param[in] taskCount The number of tasks
+		 * @param[in] task Callable taking the task index: tasks must be independent of one another
+		 */
+		template<typename Task>
+		void parallelFor(std::size_t taskCount, Task &&task)
+		{
+			this->run(taskCount, [](void *context, std::size_t i) { (*static_cast<std::remove_reference_t<Task>*>(context))(i); }, const_cast<void*>(static_cast<const void*>(std::addressof(task))));
+		}
+	};
+
+	/**
+	 * @class TaskPool
+	 * @brief Runs independently submitted tasks on a fixed set of threads, in submission order (e.g. requests arriving at a service)
+	 *
+	 * Unlike WorkStealingPool, the submitting thread does not take part: submit returns as soon as the task is queued.
+	 */
+	class I2LIB_API TaskPool
+	{
+	private:
+		std::vector<std::thread> _worker;
+		std::deque<std::function<void(void)>> _task; // Queued tasks, oldest first
+		std::mutex _lock;
+		std::condition_variable _wake, _idle;
+		std::size_t _running = 0; // Tasks taken from the queue that have not finished yet
+		std::exception_ptr _error;
+		bool _stopping = false;
+
+		void workerLoop(void);
+
+	public:
+		/**
+		 * @brief Starts the worker threads.
+		 * @param[in] threadCount The number of threads to run tasks on: 0 uses one thread per hardware thread
+		 */
+		explicit TaskPool(std::size_t threadCount = 0);
+
+		TaskPool(const TaskPool &) = delete;
+		TaskPool &operator=(const TaskPool &) = delete;
+
+		/**
+		 * @brief Runs every queued task, then stops and joins the worker threads.
+		 */
+		~TaskPool(void);
+
+		/**
+		 * @return The number of threads tasks are run on
+		 */
+		[[nodiscard]] std::size_t getThreadCount(void) const noexcept;
+
+		/**
+		 * @brief Queues a task to run on the next free thread.
+		 * @param[in] task The task to run
+		 */
+		void submit(std::function<void(void)> task);
+
+		/**
+		 * @brief Waits until every submitted task has finished.
+		 * @details The first exception thrown by a task since the last wait is rethrown here.
+		 */
+		void wait(void);
+	};
+}
+
+#endif
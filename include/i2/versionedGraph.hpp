@@ -0,0 +1,135 @@
+/*****************************************************************//**
+ * @file   versionedGraph.hpp
+ * @brief  Declarations of a multi-version graph: readers pin immutable versions while writers stage and publish changes
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#pragma once
+
+#ifndef I2_VERSIONED_GRAPH_HPP
+#define I2_VERSIONED_GRAPH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "i2/graph.hpp"
+#include "i2/directives.hpp"
+
+namespace I2
+{
+	/**
+	 * @class VersionedGraph
+	 * @brief Multi-version concurrency control over Graph: analytics run against a pinned, immutable version while writers keep ingesting
+	 *
+	 * Writers stage nodes and links (addNode, addLink, removeLink) and then publish them as a new version, numbered by an increasing epoch.
+	 * Readers pin the latest version with a single atomic load and may then run any Graph algorithm on it for as long as they like: it never
+	 * changes, is always internally consistent (every published change is either wholly in it or not at all), and never blocks a writer.
+	 * A version is reclaimed as soon as it is neither the latest nor pinned by any reader.
+	 *
+	 * Links are undirected and stored in both directions, with the same rules as GraphBuilder (DuplicatePolicy::KeepFirst) and Node::addLink:
+	 * adding a link that already exists keeps its weight, and removing a missing link does nothing. Publishing copies the arrays of the latest
+	 * version once, so it costs O(nodes + links) however few changes are staged: stage changes in batches, and publish once per batch.
+	 */
+	class I2LIB_API VersionedGraph
+	{
+	public:
+		/**
+		 * @brief A published version of the graph.
+		 */
+		struct Version
+		{
+			Graph graph;
+			std::uint64_t epoch; // 0 for the initial graph, then one higher with every publish
+		};
+
+	private:
+		/**
+		 * @brief A staged change, applied in the order it was received when published.
+		 */
+		struct Change
+		{
+			NodeId source;
+			NodeId target;
+			std::uint32_t weight;
+			bool remove;
+		};
+
+		std::atomic<std::shared_ptr<const Version>> _latest;
+		std::shared_ptr<std::atomic<std::size_t>> _liveCount; // Versions not yet reclaimed: shared with their deleters, which may run after this is destroyed
+		bool _nodesCanLinkToSelf;
+
+		mutable std::mutex _stageLock; // Guards the staged changes below
+		std::vector<std::string> _stagedName;
+		std::vector<Change> _stagedChange;
+		std::size_t _nodeCount; // Including staged nodes, so links to them can be validated as they are staged
+
+		std::mutex _publishLock; // Serialises publishing, so versions are built one at a time from the latest
+
+		/**
+		 * @brief Wraps a graph as a version that counts itself within _liveCount until it is reclaimed.
+		 */
+		[[nodiscard]] std::shared_ptr<const Version> makeVersion(Graph graph, std::uint64_t epoch) const;
+
+	public:
+		/**
+		 * @brief Constructs a versioned graph, publishing the initial graph as epoch 0.
+		 * @param[in] initial The initial version (such as a loaded graph)
+		 * @param[in] nodesCanLinkToSelf when true links are valid if source and target match
+		 */
+		explicit VersionedGraph(Graph initial = Graph(), bool nodesCanLinkToSelf = false);
+
+		/**
+		 * @brief Pins the latest version, without locking.
+		 * @return The latest published version: it stays alive and unchanged for as long as the pointer is held
+		 */
+		[[nodiscard]] std::shared_ptr<const Version> pin(void) const;
+
+		/**
+		 * @brief Stages a new node: it joins the graph, unlinked, when next published.
+		 * @param[in] name The unique name of the node
+		 * @return The ID the node will have
+		 */
+		NodeId addNode(std::string_view name);
+
+		/**
+		 * @brief Stages an undirected link: ignored when published if the link already exists by then.
+		 * @param[in] source The ID of the source node: published or staged
+		 * @param[in] target The ID of the target node: published or staged
+		 * @param[in] weight The weight associated to the link
+		 * @throw std::runtime_error if the link references an unknown node, or links a node to itself when that is not allowed
+		 */
+		void addLink(NodeId source, NodeId target, unsigned int weight);
+
+		/**
+		 * @brief Stages the removal of an undirected link: ignored when published if the link does not exist by then.
+		 * @param[in] source The ID of the source node
+		 * @param[in] target The ID of the target node
+		 */
+		void removeLink(NodeId source, NodeId target);
+
+		/**
+		 * @return The number of staged nodes and changes that have not been published yet
+		 */
+		[[nodiscard]] std::size_t getPendingCount(void) const;
+
+		/**
+		 * @brief Applies every staged change, in order, to the latest version and publishes the result as a new version.
+		 * @details Readers keep the version they pinned. The previous version is reclaimed once its last reader releases it.
+		 * @return The epoch of the latest version: unchanged if nothing was staged
+		 */
+		std::uint64_t publish(void);
+
+		/**
+		 * @return The number of versions still held in memory: the latest plus any older versions that readers still pin
+		 */
+		[[nodiscard]] std::size_t getLiveVersionCount(void) const noexcept;
+	};
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*****************************************************************//**
+ * @file   allocationCounter.cpp
+ * @brief  Replaces the global allocation functions of i2GroupTechTest, so --stats can count every allocation
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include <i2/stats.hpp>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Every form of operator new and delete is replaced, so memory is always allocated by allocate and released by release, whichever form is
+// called: when no recorder is enabled, counting costs one relaxed atomic load per allocation
+namespace
+{
+	void *allocate(std::size_t size, std::size_t alignment) noexcept
+	{
+		I2::Stats::noteAllocation();
+
+		if(size == 0)
+			size = 1;
+
+#ifdef _WIN32
+		return _aligned_malloc(size, alignment); // Windows has no aligned_alloc, and _aligned_malloc memory must be freed by _aligned_free, so every allocation uses it
+#else
+		if(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			return std::malloc(size);
+
+		return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment); // The size must be a multiple of the alignment
+#endif
+	}
+
+	void release(void *memory) noexcept
+	{
+#ifdef _WIN32
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+	void *allocateOrThrow(std::size_t size, std::size_t alignment)
+	{
+		if(void *memory = allocate(size, alignment))
+			return memory;
+
+		throw std::bad_alloc();
+	}
+}
+
+void *operator new(std::size_t size)
+{
+	return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t size)
+{
+	return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+	return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept
+{
+	release(memory);
+}
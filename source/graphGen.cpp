@@ -0,0 +1,137 @@
+/*****************************************************************//**
+ * @file   graphGen.cpp
+ * @brief  i2GraphGen: generates synthetic graphs for load testing, without needing production data
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include <i2/generator.hpp>
+#include <i2/snapshot.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+
+/**
+ * @brief i2GraphGen entry point.
+ * @param[in] argC The argument count contained in argV
+ * @param[in] argV List of arguments passed to the application: the first argument is the path to the executable
+ * @return Response code: 0 indicates success, non-zero indicates failure.
+ */
+int main(int argC, char **argV)
+{
+	I2::Generator::Options options;
+	po::options_description allOptions("Menu"), generalOptions("General"), modelOptions("Model"), outputOptions("Output");
+	std::string path = "", namesPath = "", format = "json", model = "er", weights = "uniform";
+	std::vector<char> buffer(1 << 20); // A large stream buffer: the output is written sequentially, block by block
+
+	generalOptions.add_options() // Build out the CLI menu options
+		("help,h", "Display the help content.");
+
+	modelOptions.add_options()
+		("model,m", po::value<std::string>(&model)->default_value("er"),"The random graph model: 'er' (Erdos-Renyi, uniform degrees), 'ba' (Barabasi-Albert, scale-free) or 'rmat' (recursive matrix, skewed communities).")
+		("nodes,n", po::value<std::uint64_t>(&options.nodeCount)->default_value(options.nodeCount),"The number of nodes.")
+		("links,l", po::value<std::uint64_t>(&options.linkCount)->default_value(options.linkCount),"The number of links.")
+		("weights,w", po::value<std::string>(&weights)->default_value("uniform"),"The link weight distribution: 'uniform' or 'powerlaw'.")
+		("min-weight", po::value<unsigned int>(&options.minWeight)->default_value(options.minWeight),"The lowest link weight.")
+		("max-weight", po::value<unsigned int>(&options.maxWeight)->default_value(options.maxWeight),"The highest link weight.")
+		("weight-exponent", po::value<double>(&options.weightExponent)->default_value(options.weightExponent),"The exponent of the 'powerlaw' weight distribution.")
+		("self-links", po::value<double>(&options.selfLinkRatio)->default_value(options.selfLinkRatio),"The ratio of links to self (0 to 1): load such graphs with links to self allowed.")
+		("rmat", po::value<std::vector<double>>()->multitoken(),"The R-MAT quadrant probabilities a, b and c (d is the remainder): defaults to 0.57 0.19 0.19.")
+		("seed", po::value<std::uint64_t>(&options.seed)->default_value(options.seed),"The random seed: the same options and seed always generate the same graph.");
+
+	outputOptions.add_options()
+		("output,o", po::value<std::string>(&path),"The path of the file to generate.")
+		("format,f", po::value<std::string>(&format)->default_value("json"),"The output format: 'json' (streamed in the node/link format of data.json), 'binary' (streamed binary edge list) or 'snapshot' (binary snapshot, built in memory).")
+		("names", po::value<std::string>(&namesPath),"With the 'binary' format, also writes the node names sidecar to the specified path.")
+		("threads,t", po::value<std::size_t>(&options.threadCount)->default_value(1),"The number of threads to generate on (0 uses every hardware thread): the output is identical for any thread count.");
+
+	allOptions.add(generalOptions).add(modelOptions).add(outputOptions);
+
+	po::variables_map varMap;
+
+	try
+	{
+		po::store(po::parse_command_line(argC,argV,allOptions),varMap);
+		po::notify(varMap); // Load in the expected command line arguments, if they have been passed
+
+		if(argC == 1 || varMap.count("help") || !path.length())
+		{ // Display the menu if no arguments were passed (other than the executable path), if help was specifically requested, or if the output path was not passed
+			std::cout << allOptions << std::endl;
+			return 0;
+		}
+
+		if(model == "er")
+			options.model = I2::Generator::Model::ErdosRenyi;
+		else if(model == "ba")
+			options.model = I2::Generator::Model::BarabasiAlbert;
+		else if(model == "rmat")
+			options.model = I2::Generator::Model::RMAT;
+		else
+			throw po::error("unknown model '" + model + "'");
+
+		if(weights == "uniform")
+			options.weightDistribution = I2::Generator::WeightDistribution::Uniform;
+		else if(weights == "powerlaw")
+			options.weightDistribution = I2::Generator::WeightDistribution::PowerLaw;
+		else
+			throw po::error("unknown weight distribution '" + weights + "'");
+
+		if(varMap.count("rmat"))
+		{
+			const std::vector<double> &probability = varMap["rmat"].as<std::vector<double>>();
+
+			if(probability.size() != 3)
+				throw po::error("--rmat expects three probabilities");
+
+			options.rmatA = probability[0];
+			options.rmatB = probability[1];
+			options.rmatC = probability[2];
+		}
+
+		if(format == "json" || format == "binary")
+		{
+			std::ofstream output;
+
+			output.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			output.open(path, std::ios::binary | std::ios::trunc);
+
+			if(!output)
+				throw std::runtime_error("Failed to open '" + path + "' for writing.");
+
+			if(format == "json")
+				I2::Generator::writeJSON(options, output);
+			else
+				I2::Generator::writeBinary(options, output);
+
+			if(namesPath.length())
+			{
+				std::ofstream names(namesPath, std::ios::binary | std::ios::trunc);
+
+				if(!names)
+					throw std::runtime_error("Failed to open '" + namesPath + "' for writing.");
+
+				I2::Generator::writeNames(options, names);
+			}
+		}
+		else if(format == "snapshot")
+			I2::Snapshot::saveToFile(I2::Generator::generateGraph(options), path);
+		else
+			throw po::error("unknown format '" + format + "'");
+	}
+	catch(const po::error &e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl; // Report unexpected issues with program_options
+		return 1;
+	}
+	catch(const std::runtime_error &e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl; // Report unexpected issues that occurred during runtime
+		return 2;
+	}
+
+	return 0; // Execution completed successfully
+}
@@ -0,0 +1,219 @@
+/*****************************************************************//**
+ * @file   compressedGraph.cpp
+ * @brief  The CompressedGraph function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/compressedGraph.hpp"
+#include "i2/threadPool.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace I2
+{
+	namespace
+	{
+		constexpr std::size_t encodeChunkSize = std::size_t(1) << 14; // Rows sized or encoded per task
+		constexpr std::size_t rowPadding = sizeof(std::uint64_t) - 1; // Lets decodeVarint read a whole word at the end of the last row
+
+		std::uint64_t zigzag(std::int64_t value) noexcept
+		{
+			return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+		}
+
+		std::uint8_t *encodeVarint(std::uint64_t value, std::uint8_t *output) noexcept
+		{
+			for(;value >= 0x80;value >>= 7)
+				*output++ = static_cast<std::uint8_t>(value | 0x80);
+
+			*output++ = static_cast<std::uint8_t>(value);
+
+			return output;
+		}
+
+		std::size_t groupValueSize(std::uint32_t value) noexcept
+		{
+			return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+		}
+
+		/**
+		 * @brief Encodes a row in the layout CompressedGraph::decodeRow reads, or only measures it.
+		 * @return The size of the row in bytes
+		 */
+		template<bool Write>
+		std::size_t encodeRow(std::span<const NodeId> target, std::span<const std::uint32_t> weight, NodeId id, unsigned int weightWidth, std::uint8_t *output) noexcept
+		{
+			std::size_t size = 0;
+			std::uint8_t varint[10];
+
+			const auto put = [&](const void *value, std::size_t valueSize)
+			{
+				if constexpr(Write)
+					std::memcpy(output + size, value, valueSize); // Integers keep their low bytes, which come first on the little-endian hosts supported
+
+				size += valueSize;
+			};
+
+			put(varint, static_cast<std::size_t>(encodeVarint(target.size(), varint) - varint));
+
+			if(target.empty())
+				return size;
+
+			put(varint, static_cast<std::size_t>(encodeVarint(zigzag(static_cast<std::int64_t>(target[0]) - static_cast<std::int64_t>(id)), varint) - varint));
+			put(&weight[0], weightWidth);
+
+			for(std::size_t e=1;e<target.size();e+=4)
+			{
+				const std::size_t control = size;
+
+				std::uint8_t controlValue = 0;
+
+				size += 1;
+
+				for(std::size_t k=0;k<4 && e + k<target.size();++k)
+				{
+					const std::uint32_t difference = target[e + k] - target[e + k - 1]; // Modulo 2^32
+					const std::size_t valueSize = groupValueSize(difference);
+
+					controlValue |= static_cast<std::uint8_t>((valueSize - 1) << (2 * k));
+					put(&difference, valueSize);
+					put(&weight[e + k], weightWidth);
+				}
+
+				if constexpr(Write)
+					output[control] = controlValue;
+			}
+
+			return size;
+		}
+
+		/**
+		 * @return The narrowest width holding every weight: 0 when every weight is 1
+		 */
+		unsigned int weightWidthOf(std::span<const std::uint32_t> weight) noexcept
+		{
+			if(std::all_of(weight.begin(), weight.end(), [](std::uint32_t value) { return value == 1; }))
+				return 0;
+
+			const std::uint32_t maxWeight = *std::max_element(weight.begin(), weight.end());
+
+			return maxWeight <= 0xFF ? 1 : maxWeight <= 0xFFFF ? 2 : 4;
+		}
+	}
+
+	CompressedGraph::CompressedGraph(void)
+	{
+		std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+
+		storage->rowOffset.push_back(0);
+		storage->row.resize(rowPadding);
+		this->_storage = std::move(storage);
+	}
+
+	CompressedGraph::CompressedGraph(const Graph &graph, std::size_t threadCount)
+	{
+		const Graph::Layout &layout = graph.getLayout();
+		const std::size_t nodeCount = graph.getNodeCount(), chunkCount = (nodeCount + encodeChunkSize - 1) / encodeChunkSize;
+
+		std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+		WorkStealingPool pool(threadCount);
+
+		const auto forEachRow = [&](std::size_t chunk, auto &&function)
+		{
+			for(std::size_t i=chunk * encodeChunkSize,endI=std::min(nodeCount, (chunk + 1) * encodeChunkSize);i<endI;++i)
+				function(i);
+		};
+
+		storage->weightWidth = weightWidthOf(layout.weight);
+		storage->rowOffset.assign(nodeCount + 1, 0);
+
+		const auto rowOf = [&](std::size_t i)
+		{
+			return std::make_pair(layout.target.subspan(layout.offset[i], layout.offset[i + 1] - layout.offset[i]), layout.weight.subspan(layout.offset[i], layout.offset[i + 1] - layout.offset[i]));
+		};
+
+		// Size every row first, so each can be encoded straight into place
+		pool.parallelFor(chunkCount, [&](std::size_t chunk)
+		{
+			forEachRow(chunk, [&](std::size_t i)
+			{
+				const auto [target, weight] = rowOf(i);
+
+				storage->rowOffset[i + 1] = encodeRow<false>(target, weight, static_cast<NodeId>(i), storage->weightWidth, nullptr);
+			});
+		});
+
+		std::partial_sum(storage->rowOffset.begin(), storage->rowOffset.end(), storage->rowOffset.begin());
+		storage->row.resize(storage->rowOffset.back() + rowPadding);
+
+		pool.parallelFor(chunkCount, [&](std::size_t chunk)
+		{
+			forEachRow(chunk, [&](std::size_t i)
+			{
+				const auto [target, weight] = rowOf(i);
+
+				(void)encodeRow<true>(target, weight, static_cast<NodeId>(i), storage->weightWidth, storage->row.data() + storage->rowOffset[i]);
+			});
+		});
+
+		storage->weightedDegree.assign(layout.weightedDegree.begin(), layout.weightedDegree.end());
+		storage->nameOffset.assign(layout.nameOffset.begin(), layout.nameOffset.end());
+		storage->nameData.assign(layout.nameData.begin(), layout.nameData.end());
+		storage->entryCount = graph.getEntryCount();
+
+		this->_storage = std::move(storage);
+	}
+
+	std::size_t CompressedGraph::getNodeCount(void) const noexcept
+	{
+		return this->_storage->rowOffset.size() - 1;
+	}
+
+	std::uint64_t CompressedGraph::getEntryCount(void) const noexcept
+	{
+		return this->_storage->entryCount;
+	}
+
+	unsigned int CompressedGraph::getWeightWidth(void) const noexcept
+	{
+		return this->_storage->weightWidth;
+	}
+
+	std::size_t CompressedGraph::getAdjacencyBytes(void) const noexcept
+	{
+		return this->_storage->rowOffset.size() * sizeof(std::uint64_t) + this->_storage->row.size();
+	}
+
+	std::size_t CompressedGraph::getAdjacencyBytes(const Graph &graph) noexcept
+	{
+		const Graph::Layout &layout = graph.getLayout();
+
+		return layout.offset.size_bytes() + layout.target.size_bytes() + layout.weight.size_bytes();
+	}
+
+	std::string_view CompressedGraph::getName(NodeId id) const
+	{
+		if(id >= this->getNodeCount())
+			throw std::out_of_range("Error: Invalid node ID.");
+
+		return std::string_view(this->_storage->nameData.data() + this->_storage->nameOffset[id], this->_storage->nameOffset[id + 1] - this->_storage->nameOffset[id]);
+	}
+
+	std::span<const std::uint32_t> CompressedGraph::getWeightedDegrees(void) const noexcept
+	{
+		return this->_storage->weightedDegree;
+	}
+
+	unsigned int CompressedGraph::getLinkCount(NodeId id) const
+	{
+		if(id >= this->getNodeCount())
+			throw std::out_of_range("Error: Invalid node ID.");
+
+		const std::uint8_t *data = this->_storage->row.data() + this->_storage->rowOffset[id];
+
+		return static_cast<unsigned int>(decodeVarint(data));
+	}
+}
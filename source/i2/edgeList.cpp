@@ -0,0 +1,475 @@
+/*****************************************************************//**
+ * @file   edgeList.cpp
+ * @brief  The edge list loader function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/edgeList.hpp"
+#include "i2/io.hpp"
+#include "i2/threadPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace I2
+{
+	namespace EdgeList
+	{
+		namespace
+		{
+			constexpr std::size_t minChunkSize = 1 << 20; // Smaller chunks cost more to schedule than they save
+			constexpr std::size_t chunksPerThread = 4; // Enough chunks to balance uneven lines across threads
+			constexpr NodeId malformedNode = std::numeric_limits<NodeId>::max(); // Never a valid ID, so malformed lines fail validation at their own index
+			constexpr std::size_t scanBufferSize = 1 << 20; // Bytes read from the file at a time by scan
+			constexpr std::size_t scanBatchSize = 1 << 16; // Links handed to the scan consumer at a time
+
+			/**
+			 * @brief The links parsed from one chunk of the file.
+			 */
+			struct Chunk
+			{
+				std::size_t begin = 0, end = 0; // Byte range within the file
+				std::vector<Record> link;
+				NodeId maxNode = 0; // The highest valid node ID referenced, for when there is no names sidecar
+				bool hasNode = false;
+			};
+
+			/**
+			 * @return The chunk count for a file of the given size: at least one, and no more than the file can fill with minChunkSize chunks
+			 */
+			std::size_t chunkCountOf(std::size_t size, std::size_t threadCount)
+			{
+				return std::max<std::size_t>(1, std::min(threadCount * chunksPerThread, size / minChunkSize));
+			}
+
+			/**
+			 * @return true if the line holds no link (blank, or a '#' or '%' comment)
+			 */
+			bool isSkippedLine(std::string_view line)
+			{
+				const std::size_t first = line.find_first_not_of(" \t\r");
+
+				return first == std::string_view::npos || line[first] == '#' || line[first] == '%';
+			}
+
+			/**
+			 * @brief Parses one field as an unsigned integer, ignoring surrounding spaces.
+			 * @return false if the field is not a plain unsigned integer within range
+			 */
+			bool parseField(std::string_view field, std::uint32_t &value)
+			{
+				const std::size_t first = field.find_first_not_of(" \t"), last = field.find_last_not_of(" \t");
+
+				if(first == std::string_view::npos)
+					return false;
+
+				const char *begin = field.data() + first, *end = field.data() + last + 1;
+				const auto [parsed, error] = std::from_chars(begin, end, value);
+
+				return error == std::errc() && parsed == end;
+			}
+
+			/**
+			 * @brief Splits a line on the delimiter ('\0' for runs of spaces and tabs) and parses it as a link.
+			 * @return The link, or a link between malformedNode and itself if the line is malformed
+			 */
+			Record parseLine(std::string_view line, char delimiter)
+			{
+				std::string_view field[4];
+				std::size_t fieldCount = 0;
+				Record link{malformedNode, malformedNode, 1};
+
+				if(!line.empty() && line.back() == '\r')
+					line.remove_suffix(1);
+
+				if(delimiter)
+				{
+					for(std::size_t start=0;fieldCount<4;)
+					{
+						const std::size_t next = line.find(delimiter, start);
+
+						field[fieldCount++] = line.substr(start, next - start);
+
+						if(next == std::string_view::npos)
+							break;
+
+						start = next + 1;
+					}
+				}
+				else
+				{
+					for(std::size_t start=line.find_first_not_of(" \t");start!=std::string_view::npos && fieldCount<4;)
+					{
+						const std::size_t next = line.find_first_of(" \t", start);
+
+						field[fieldCount++] = line.substr(start, next - start);
+						start = next == std::string_view::npos ? next : line.find_first_not_of(" \t", next);
+					}
+				}
+
+				if(fieldCount < 2 || fieldCount > 3 || !parseField(field[0], link.source) || !parseField(field[1], link.target)
+					|| (fieldCount == 3 && !parseField(field[2], link.weight)) || link.source == malformedNode || link.target == malformedNode)
+				{
+					return Record{malformedNode, malformedNode, 0};
+				}
+
+				return link;
+			}
+
+			/**
+			 * @brief Decodes a binary Record from its little-endian bytes.
+			 */
+			Record decodeRecord(const char *data)
+			{
+				std::uint32_t field[3];
+
+				std::memcpy(field, data, recordSize); // Files and mappings are only byte aligned
+
+				if constexpr(std::endian::native == std::endian::big)
+				{
+					for(std::uint32_t &f : field)
+						f = std::byteswap(f);
+				}
+
+				return Record{field[0], field[1], field[2]};
+			}
+
+			/**
+			 * @brief Reads the names sidecar into the builder, one node per line.
+			 */
+			void addNames(GraphBuilder &builder, const std::string &path)
+			{
+				std::ifstream input(path, std::ios::binary);
+				std::string name;
+
+				if(!input)
+					throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+
+				while(std::getline(input, name))
+				{
+					if(!name.empty() && name.back() == '\r')
+						name.pop_back();
+
+					builder.addNode(name); // Throws for a blank name, as the Node constructor does
+				}
+			}
+
+			/**
+			 * @brief Adds the nodes (from the sidecar, or named by ID) and then the links of every chunk in file order, and builds the graph.
+			 */
+			Graph buildGraph(std::vector<Chunk> &chunk, const Options &options)
+			{
+				GraphBuilder builder(options.nodesCanLinkToSelf, options.duplicatePolicy);
+				std::size_t linkCount = 0;
+
+				for(const Chunk &c : chunk)
+					linkCount += c.link.size();
+
+				if(options.namesPath.length())
+					addNames(builder, options.namesPath);
+				else
+				{
+					NodeId maxNode = 0;
+					bool hasNode = false;
+
+					for(const Chunk &c : chunk)
+					{
+						if(c.hasNode)
+						{
+							maxNode = hasNode ? std::max(maxNode, c.maxNode) : c.maxNode;
+							hasNode = true;
+						}
+					}
+
+					builder.reserve(hasNode ? std::size_t(maxNode) + 1 : 0, linkCount);
+
+					for(std::size_t i=0;hasNode && i<=maxNode;++i)
+						builder.addNode(std::to_string(i));
+				}
+
+				builder.reserve(builder.getNodeCount(), linkCount);
+
+				for(Chunk &c : chunk)
+				{
+					for(const Record &link : c.link)
+						builder.addLink(link.source, link.target, link.weight);
+
+					std::vector<Record>().swap(c.link); // Release each chunk once merged, so the peak is not two copies of every link
+				}
+
+				return builder.build(options.threadCount); // Validates every link: the lowest invalid index is reported, wherever the chunk boundaries fell
+			}
+
+			void noteNodes(Chunk &chunk, const Record &link)
+			{
+				if(link.source == malformedNode || link.target == malformedNode)
+					return; // Fails validation at its own index instead
+
+				const NodeId maxNode = std::max(link.source, link.target);
+
+				chunk.maxNode = chunk.hasNode ? std::max(chunk.maxNode, maxNode) : maxNode;
+				chunk.hasNode = true;
+			}
+		}
+
+		Graph loadText(const std::string &path, const Options &options)
+		{
+			const IO::MappedFile file(path);
+			const std::string_view text(file.data(), file.size());
+
+			WorkStealingPool pool(options.threadCount);
+			std::vector<Chunk> chunk(chunkCountOf(text.size(), pool.getThreadCount()));
+			char delimiter = options.delimiter;
+			std::size_t start = 0;
+
+			// Find the first link, skipping comments and a header line, and detect the delimiter from it
+			while(start < text.size())
+			{
+				const std::size_t end = std::min(text.find('\n', start), text.size());
+				const std::string_view line = text.substr(start, end - start);
+
+				if(!isSkippedLine(line))
+				{
+					const std::size_t first = line.find_first_not_of(" \t");
+
+					if(!delimiter)
+						delimiter = line.find(',') != std::string_view::npos ? ',' : line.find('\t') != std::string_view::npos ? '\t' : '\0';
+
+					if(!std::isdigit(static_cast<unsigned char>(line[first])))
+						start = end + 1; // A header
+
+					break;
+				}
+
+				start = end + 1;
+			}
+
+			if(delimiter == ' ')
+				delimiter = '\0'; // Spaces are always treated as runs
+
+			// Split at newline boundaries: each chunk ends just after the first newline following its share of the file
+			for(std::size_t i=0,chunkCount=chunk.size();i<chunkCount;++i)
+			{
+				const std::size_t target = i + 1 == chunkCount ? text.size() : std::max(start, text.size() / chunkCount * (i + 1));
+				const std::size_t newline = target < text.size() ? text.find('\n', target) : std::string_view::npos;
+
+				chunk[i].begin = i ? chunk[i - 1].end : std::min(start, text.size());
+				chunk[i].end = std::max(chunk[i].begin, newline == std::string_view::npos ? text.size() : newline + 1);
+			}
+
+			pool.parallelFor(chunk.size(), [&](std::size_t i)
+			{
+				Chunk &c = chunk[i];
+
+				for(std::size_t lineStart=c.begin;lineStart<c.end;)
+				{
+					const std::size_t lineEnd = std::min(text.find('\n', lineStart), c.end);
+					const std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+
+					if(!isSkippedLine(line))
+					{
+						c.link.push_back(parseLine(line, delimiter));
+						noteNodes(c, c.link.back());
+					}
+
+					lineStart = lineEnd + 1;
+				}
+			});
+
+			return buildGraph(chunk, options);
+		}
+
+		Graph loadBinary(const std::string &path, const Options &options)
+		{
+			const IO::MappedFile file(path);
+
+			if(file.size() % recordSize)
+				throw std::runtime_error("Error: Edge list '" + path + "' is truncated.");
+
+			const std::size_t recordCount = file.size() / recordSize;
+
+			WorkStealingPool pool(options.threadCount);
+			std::vector<Chunk> chunk(chunkCountOf(file.size(), pool.getThreadCount()));
+
+			for(std::size_t i=0,chunkCount=chunk.size();i<chunkCount;++i)
+			{
+				chunk[i].begin = recordCount * i / chunkCount;
+				chunk[i].end = recordCount * (i + 1) / chunkCount;
+			}
+
+			pool.parallelFor(chunk.size(), [&](std::size_t i)
+			{
+				Chunk &c = chunk[i];
+
+				c.link.resize(c.end - c.begin);
+
+				for(std::size_t r=c.begin;r<c.end;++r)
+				{
+					c.link[r - c.begin] = decodeRecord(file.data() + r * recordSize);
+					noteNodes(c, c.link[r - c.begin]);
+				}
+			});
+
+			return buildGraph(chunk, options);
+		}
+
+		void scan(const std::string &path, const Options &options, const std::function<void(std::span<const Record>, std::size_t)> &consumer)
+		{
+			const Format format = detectFormat(path);
+
+			std::ifstream input(path, std::ios::binary);
+			std::vector<Record> batch;
+			std::size_t index = 0; // The index of the next link within the file
+
+			if(format == Format::None)
+				throw std::runtime_error("Error: '" + path + "' is not an edge list.");
+
+			if(!input)
+				throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+
+			batch.reserve(scanBatchSize);
+
+			const auto deliver = [&]()
+			{
+				if(batch.size())
+					consumer(batch, index - batch.size());
+
+				batch.clear();
+			};
+
+			if(format == Format::Binary)
+			{
+				std::vector<char> buffer(scanBatchSize * recordSize);
+
+				if(std::filesystem::file_size(path) % recordSize)
+					throw std::runtime_error("Error: Edge list '" + path + "' is truncated.");
+
+				while(input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0)
+				{
+					const std::size_t recordCount = static_cast<std::size_t>(input.gcount()) / recordSize;
+
+					for(std::size_t r=0;r<recordCount;++r)
+						batch.push_back(decodeRecord(buffer.data() + r * recordSize));
+
+					index += recordCount;
+					deliver();
+				}
+
+				return;
+			}
+
+			std::vector<char> buffer(scanBufferSize);
+			std::string pending; // The start of a line that continues into the next read
+			char delimiter = options.delimiter;
+			bool hasFirstLine = false;
+
+			// As loadText: the first link detects the delimiter, and a first line that does not start with a digit is a header
+			const auto parse = [&](std::string_view line)
+			{
+				if(isSkippedLine(line))
+					return;
+
+				if(!hasFirstLine)
+				{
+					const std::size_t first = line.find_first_not_of(" \t");
+
+					hasFirstLine = true;
+
+					if(!delimiter)
+						delimiter = line.find(',') != std::string_view::npos ? ',' : line.find('\t') != std::string_view::npos ? '\t' : '\0';
+
+					if(delimiter == ' ')
+						delimiter = '\0'; // Spaces are always treated as runs
+
+					if(!std::isdigit(static_cast<unsigned char>(line[first])))
+						return; // A header
+				}
+
+				const Record link = parseLine(line, delimiter);
+
+				if(link.source == malformedNode || link.target == malformedNode)
+				{
+					deliver(); // The links before it may hold an earlier invalid link
+					throw std::runtime_error(GraphBuilder::invalidLinkError(index));
+				}
+
+				batch.push_back(link);
+
+				if(++index % scanBatchSize == 0)
+					deliver();
+			};
+
+			while(input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0)
+			{
+				const std::string_view text(buffer.data(), static_cast<std::size_t>(input.gcount()));
+
+				std::size_t start = 0;
+
+				for(std::size_t end=text.find('\n');end!=std::string_view::npos;end=text.find('\n', start))
+				{
+					if(pending.size())
+					{
+						pending.append(text.substr(start, end - start));
+						parse(pending);
+						pending.clear();
+					}
+					else
+						parse(text.substr(start, end - start));
+
+					start = end + 1;
+				}
+
+				pending.append(text.substr(start));
+			}
+
+			parse(pending); // The last line need not end with a newline
+			deliver();
+		}
+
+		void writeBinary(std::ostream &output, std::span<const Record> record)
+		{
+			std::vector<char> buffer(record.size() * recordSize);
+
+			for(std::size_t r=0,recordCount=record.size();r<recordCount;++r)
+			{
+				std::uint32_t field[3] = {record[r].source, record[r].target, record[r].weight};
+
+				if constexpr(std::endian::native == std::endian::big)
+				{
+					for(std::uint32_t &f : field)
+						f = std::byteswap(f);
+				}
+
+				std::memcpy(buffer.data() + r * recordSize, field, recordSize);
+			}
+
+			output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		}
+
+		Format detectFormat(const std::string &path)
+		{
+			std::string extension = std::filesystem::path(path).extension().string();
+
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+			if(extension == ".csv" || extension == ".tsv" || extension == ".txt" || extension == ".edges")
+				return Format::Text;
+
+			if(extension == ".bin")
+				return Format::Binary;
+
+			return Format::None;
+		}
+	}
+}
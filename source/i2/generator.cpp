@@ -0,0 +1,418 @@
+/*****************************************************************//**
+ * @file   generator.cpp
+ * @brief  The synthetic graph generator function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/generator.hpp"
+#include "i2/edgeList.hpp"
+#include "i2/threadPool.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace I2
+{
+	namespace Generator
+	{
+		namespace
+		{
+			constexpr std::uint64_t selfLinkSalt = 0x5E1F5E1F5E1F5E1F, attachmentSalt = 0xA77AC4A77AC4A77A; // Keep the independent random streams of a link apart
+			constexpr int maxAttempts = 64; // Redraws allowed before falling back to a uniformly chosen node, when avoiding a link to self
+			constexpr std::size_t blocksPerThread = 4; // Blocks in flight per thread when streaming: enough to balance, few enough to bound memory
+
+			/**
+			 * @brief SplitMix64: a tiny, fast generator whose state can be derived from any 64-bit value, so every link gets its own stream.
+			 */
+			struct SplitMix
+			{
+				std::uint64_t state;
+
+				std::uint64_t next(void) noexcept
+				{
+					std::uint64_t z = (this->state += 0x9E3779B97F4A7C15);
+
+					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+					z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+
+					return z ^ (z >> 31);
+				}
+
+				std::uint64_t below(std::uint64_t bound) noexcept
+				{
+					return this->next() % bound; // The modulo bias is below 2^-32 for any bound a NodeId can hold
+				}
+
+				double unit(void) noexcept
+				{
+					return static_cast<double>(this->next() >> 11) * 0x1.0p-53; // [0, 1)
+				}
+			};
+
+			/**
+			 * @return The random stream of a value (such as a link index) under a seed
+			 */
+			SplitMix streamOf(std::uint64_t seed, std::uint64_t value) noexcept
+			{
+				SplitMix mix{seed ^ (value * 0xD1B54A32D192ED03)};
+
+				return SplitMix{mix.next()};
+			}
+
+			bool isSelfLink(const Options &options, std::uint64_t index) noexcept
+			{
+				return options.selfLinkRatio > 0.0 && streamOf(options.seed ^ selfLinkSalt, index).unit() < options.selfLinkRatio;
+			}
+
+			std::uint32_t drawWeight(const Options &options, SplitMix &random) noexcept
+			{
+				if(options.weightDistribution == WeightDistribution::Uniform)
+					return static_cast<std::uint32_t>(options.minWeight + random.below(static_cast<std::uint64_t>(options.maxWeight) - options.minWeight + 1));
+
+				// Inverse transform of a continuous power law over [minWeight + 1, maxWeight + 2), shifted back down so a minimum weight of 0 is supported
+				const double low = static_cast<double>(options.minWeight) + 1.0, high = static_cast<double>(options.maxWeight) + 2.0, u = random.unit();
+				const double exponent = 1.0 - options.weightExponent;
+				const double x = std::fabs(exponent) < 1e-12 ? low * std::pow(high / low, u) : std::pow(std::pow(low, exponent) + u * (std::pow(high, exponent) - std::pow(low, exponent)), 1.0 / exponent);
+
+				return std::min(static_cast<std::uint32_t>(x) - 1, static_cast<std::uint32_t>(options.maxWeight));
+			}
+
+			/**
+			 * @brief Any node other than source, chosen uniformly: the fallback once redrawing keeps landing on source.
+			 */
+			NodeId otherNode(const Options &options, NodeId source, SplitMix &random) noexcept
+			{
+				const NodeId target = static_cast<NodeId>(random.below(options.nodeCount - 1));
+
+				return target >= source ? target + 1 : target;
+			}
+
+			/**
+			 * @return The number of links each node adds under Model::BarabasiAlbert
+			 */
+			std::uint64_t linksPerNode(const Options &options) noexcept
+			{
+				return std::max<std::uint64_t>(1, (options.linkCount + options.nodeCount - 1) / options.nodeCount);
+			}
+
+			/**
+			 * @brief Resolves the target of a Barabási–Albert link without storing any earlier links (Sanders and Schulz's hashing variant of Batagelj and Brandes).
+			 * @details Conceptually, link e writes its source to endpoint[2e] and a copy of a uniformly chosen earlier endpoint to endpoint[2e + 1].
+			 * Copying a uniform endpoint picks a node in proportion to its degree. Even endpoints are known outright, and the choice made by each odd
+			 * endpoint is a hash of its position, so any endpoint can be recomputed by following copies back to an even one.
+			 * @param[in] options The graph to generate
+			 * @param[in] link The index of the link to resolve
+			 * @return The target node of the link
+			 */
+			NodeId attachmentTarget(const Options &options, std::uint64_t link)
+			{
+				const std::uint64_t m = linksPerNode(options), endpoint = 2 * link + 1;
+				const NodeId source = static_cast<NodeId>(link / m);
+
+				if(isSelfLink(options, link))
+					return source;
+
+				SplitMix random = streamOf(options.seed ^ attachmentSalt, endpoint);
+
+				for(int attempt=0;attempt<maxAttempts;++attempt)
+				{
+					const std::uint64_t chosen = random.below(endpoint); // Any earlier endpoint, including this link's own source
+					const NodeId target = chosen % 2 ? attachmentTarget(options, chosen / 2) : static_cast<NodeId>(chosen / 2 / m);
+
+					if(target != source)
+						return target;
+				}
+
+				return otherNode(options, source, random);
+			}
+
+			Link generateLink(const Options &options, std::uint64_t index)
+			{
+				SplitMix random = streamOf(options.seed, index);
+				Link link{0, 0, 0};
+
+				switch(options.model)
+				{
+				case Model::ErdosRenyi:
+					link.source = static_cast<NodeId>(random.below(options.nodeCount));
+					link.target = isSelfLink(options, index) ? link.source : otherNode(options, link.source, random);
+					break;
+
+				case Model::BarabasiAlbert:
+					link.source = static_cast<NodeId>(index / linksPerNode(options));
+					link.target = attachmentTarget(options, index);
+					break;
+
+				case Model::RMAT:
+				{
+					const bool selfLink = isSelfLink(options, index);
+
+					int scale = 0;
+
+					while((std::uint64_t(1) << scale) < options.nodeCount)
+						++scale;
+
+					// Descend one quadrant per bit; links landing outside the node range (when it is not a power of two), or on self when not wanted, are
+					// redrawn, up to maxAttempts times before falling back to a uniform draw, so even degenerate probabilities end
+					for(int attempt=0;;++attempt)
+					{
+						std::uint64_t source = 0, target = 0;
+
+						for(int bit=0;bit<scale;++bit)
+						{
+							const double u = random.unit();
+
+							source = (source << 1) | (u >= options.rmatA + options.rmatB ? 1 : 0);
+							target = (target << 1) | ((u >= options.rmatA && u < options.rmatA + options.rmatB) || u >= options.rmatA + options.rmatB + options.rmatC ? 1 : 0);
+						}
+
+						if(selfLink)
+							target = source;
+
+						if(source < options.nodeCount && target < options.nodeCount && (selfLink || source != target))
+						{
+							link.source = static_cast<NodeId>(source);
+							link.target = static_cast<NodeId>(target);
+							break;
+						}
+
+						if(attempt == maxAttempts)
+						{
+							link.source = source < options.nodeCount ? static_cast<NodeId>(source) : static_cast<NodeId>(random.below(options.nodeCount));
+							link.target = selfLink ? link.source : otherNode(options, link.source, random);
+							break;
+						}
+					}
+
+					break;
+				}
+				}
+
+				link.weight = drawWeight(options, random);
+
+				return link;
+			}
+
+			/**
+			 * @brief Appends an unsigned integer to text without allocating a temporary string.
+			 */
+			void appendNumber(std::string &text, std::uint64_t value)
+			{
+				char buffer[24];
+				const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+				(void)error; // 24 characters always hold a 64-bit value
+				text.append(buffer, end);
+			}
+
+			/**
+			 * @brief Runs task over [0, taskCount) in windows of the given size, then hands each window to flush (in order) before starting the next.
+			 */
+			template<typename Task, typename Flush>
+			void runWindows(WorkStealingPool &pool, std::uint64_t taskCount, std::size_t windowSize, Task &&task, Flush &&flush)
+			{
+				for(std::uint64_t first=0;first<taskCount;first+=windowSize)
+				{
+					const std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(windowSize, taskCount - first));
+
+					pool.parallelFor(count, [&](std::size_t i) { task(i, first + i); });
+					flush(count);
+				}
+			}
+		}
+
+		void validate(const Options &options)
+		{
+			if(options.nodeCount == 0 || options.nodeCount > std::numeric_limits<NodeId>::max())
+				throw std::runtime_error("Error: The node count must be between 1 and " + std::to_string(std::numeric_limits<NodeId>::max()) + ".");
+
+			if(options.nodeCount == 1 && options.linkCount && options.selfLinkRatio < 1.0)
+				throw std::runtime_error("Error: A single node can only link to itself: set the self-link ratio to 1.");
+
+			if(options.selfLinkRatio < 0.0 || options.selfLinkRatio > 1.0)
+				throw std::runtime_error("Error: The self-link ratio must be between 0 and 1.");
+
+			if(options.minWeight > options.maxWeight)
+				throw std::runtime_error("Error: The minimum weight must not exceed the maximum weight.");
+
+			if(options.maxWeight == std::numeric_limits<unsigned int>::max())
+				throw std::runtime_error("Error: The maximum weight is out of range.");
+
+			if(options.rmatA < 0.0 || options.rmatB < 0.0 || options.rmatC < 0.0 || options.rmatA + options.rmatB + options.rmatC > 1.0)
+				throw std::runtime_error("Error: The R-MAT probabilities must not be negative and must sum to no more than 1.");
+
+			if(options.model == Model::RMAT && options.linkCount)
+			{
+				// Below a power of two, the IDs in range all start with a 0 bit, so a source and a target must each be able to draw one
+				if((options.nodeCount & (options.nodeCount - 1)) && (options.rmatA + options.rmatB == 0.0 || options.rmatA + options.rmatC == 0.0))
+					throw std::runtime_error("Error: The R-MAT probabilities a + b and a + c must be positive unless the node count is a power of two.");
+
+				// Quadrants a and d keep the source and target bits equal, so only b and c can draw a link to another node
+				if(options.nodeCount > 1 && options.selfLinkRatio < 1.0 && options.rmatB + options.rmatC == 0.0)
+					throw std::runtime_error("Error: The R-MAT probabilities b and c must not both be 0 unless every link is a link to self.");
+			}
+		}
+
+		std::uint64_t getBlockCount(const Options &options) noexcept
+		{
+			return (options.linkCount + blockSize - 1) / blockSize;
+		}
+
+		void generateBlock(const Options &options, std::uint64_t block, std::vector<Link> &link)
+		{
+			const std::uint64_t begin = block * blockSize, end = std::min(options.linkCount, begin + blockSize);
+
+			link.clear();
+			link.reserve(end > begin ? end - begin : 0);
+
+			for(std::uint64_t i=begin;i<end;++i)
+				link.push_back(generateLink(options, i));
+		}
+
+		Graph generateGraph(const Options &options)
+		{
+			GraphBuilder builder(options.selfLinkRatio > 0.0);
+			WorkStealingPool pool(options.threadCount);
+			std::vector<std::vector<Link>> window(pool.getThreadCount() * blocksPerThread);
+
+			validate(options);
+			builder.reserve(options.nodeCount, options.linkCount);
+
+			for(std::uint64_t i=0;i<options.nodeCount;++i)
+				builder.addNode("Node" + std::to_string(i));
+
+			runWindows(pool, getBlockCount(options), window.size(),
+				[&](std::size_t slot, std::uint64_t block) { generateBlock(options, block, window[slot]); },
+				[&](std::size_t count)
+				{
+					for(std::size_t slot=0;slot<count;++slot)
+					{
+						for(const Link &link : window[slot])
+							builder.addLink(link.source, link.target, link.weight);
+					}
+				});
+
+			return builder.build(options.threadCount);
+		}
+
+		void writeJSON(const Options &options, std::ostream &output)
+		{
+			WorkStealingPool pool(options.threadCount);
+			std::vector<std::string> text(pool.getThreadCount() * blocksPerThread); // Each block is formatted on a worker thread, then written in order
+			std::vector<std::vector<Link>> link(text.size());
+
+			const auto flush = [&](std::size_t count)
+			{
+				for(std::size_t slot=0;slot<count;++slot)
+					output.write(text[slot].data(), static_cast<std::streamsize>(text[slot].size()));
+
+				if(!output)
+					throw std::runtime_error("Error: Failed to write the generated graph.");
+			};
+
+			validate(options);
+			output << "{\"nodes\":[";
+
+			runWindows(pool, (options.nodeCount + blockSize - 1) / blockSize, text.size(), [&](std::size_t slot, std::uint64_t block)
+			{
+				std::string &nodes = text[slot];
+
+				nodes.clear();
+
+				for(std::uint64_t i=block * blockSize,end=std::min(options.nodeCount, (block + 1) * blockSize);i<end;++i)
+				{
+					nodes += i ? ",{\"name\":\"Node" : "{\"name\":\"Node";
+					appendNumber(nodes, i);
+					nodes += "\"}";
+				}
+			}, flush);
+
+			output << "],\"links\":[";
+
+			runWindows(pool, getBlockCount(options), text.size(), [&](std::size_t slot, std::uint64_t block)
+			{
+				std::string &links = text[slot];
+
+				generateBlock(options, block, link[slot]);
+				links.clear();
+
+				for(std::size_t i=0,linkCount=link[slot].size();i<linkCount;++i)
+				{
+					links += block || i ? ",{\"source\":" : "{\"source\":";
+					appendNumber(links, link[slot][i].source);
+					links += ",\"target\":";
+					appendNumber(links, link[slot][i].target);
+					links += ",\"value\":";
+					appendNumber(links, link[slot][i].weight);
+					links += '}';
+				}
+			}, flush);
+
+			output << "]}";
+			output.flush();
+
+			if(!output)
+				throw std::runtime_error("Error: Failed to write the generated graph.");
+		}
+	
+		void writeBinary(const Options &options, std::ostream &output)
+		{
+			WorkStealingPool pool(options.threadCount);
+			std::vector<std::vector<Link>> link(pool.getThreadCount() * blocksPerThread);
+			std::vector<EdgeList::Record> record;
+
+			validate(options);
+
+			runWindows(pool, getBlockCount(options), link.size(), [&](std::size_t slot, std::uint64_t block) { generateBlock(options, block, link[slot]); }, [&](std::size_t count)
+			{
+				for(std::size_t slot=0;slot<count;++slot)
+				{
+					record.clear();
+
+					for(const Link &l : link[slot])
+						record.push_back(EdgeList::Record{l.source, l.target, l.weight});
+
+					EdgeList::writeBinary(output, record);
+				}
+
+				if(!output)
+					throw std::runtime_error("Error: Failed to write the generated graph.");
+			});
+
+			output.flush();
+
+			if(!output)
+				throw std::runtime_error("Error: Failed to write the generated graph.");
+		}
+
+		void writeNames(const Options &options, std::ostream &output)
+		{
+			std::string names;
+
+			validate(options);
+
+			for(std::uint64_t i=0;i<options.nodeCount;++i)
+			{
+				names += "Node";
+				appendNumber(names, i);
+				names += '\n';
+
+				if(names.size() >= blockSize || i + 1 == options.nodeCount)
+				{
+					output.write(names.data(), static_cast<std::streamsize>(names.size()));
+					names.clear();
+				}
+			}
+
+			output.flush();
+
+			if(!output)
+				throw std::runtime_error("Error: Failed to write the generated graph.");
+		}
+	}
+}
@@ -0,0 +1,459 @@
+/*****************************************************************//**
+ * @file   graph.cpp
+ * @brief  The Graph and GraphBuilder function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/graph.hpp"
+#include "i2/threadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <unordered_map>
+
+namespace I2
+{
+	namespace
+	{
+		/**
+		 * @brief The arrays of a graph built in memory, shared between copies of the graph.
+		 */
+		struct OwnedStorage
+		{
+			std::vector<std::uint64_t> offset, nameOffset;
+			std::vector<NodeId> target;
+			std::vector<std::uint32_t> weight, weightedDegree;
+			std::vector<char> nameData;
+		};
+
+		/**
+		 * @return The layout of the arrays within storage
+		 */
+		Graph::Layout layoutOf(const OwnedStorage &storage)
+		{
+			return Graph::Layout{storage.offset, storage.target, storage.weight, storage.weightedDegree, storage.nameOffset, storage.nameData};
+		}
+
+		constexpr std::size_t buildChunkSize = 1 << 16; // Links (or adjacency entries) per build task: large enough to amortise scheduling
+		constexpr std::size_t noIndex = std::numeric_limits<std::size_t>::max();
+
+		/**
+		 * @brief An adjacency entry while building, remembering the index of the link that produced it so rows can be ordered by input.
+		 */
+		struct BuildEntry
+		{
+			NodeId target;
+			std::uint32_t weight;
+			std::size_t link;
+		};
+
+		/**
+		 * @return The number of tasks to split count items into
+		 */
+		std::size_t chunkCountOf(std::size_t count)
+		{
+			return std::max<std::size_t>(1, (count + buildChunkSize - 1) / buildChunkSize);
+		}
+	}
+
+	struct Graph::NameLookup
+	{
+		std::once_flag built;
+		NameIndex index;
+	};
+
+	Graph::Graph(void) : Graph(NamePool(), std::vector<std::uint64_t>(1, 0), std::vector<NodeId>(), std::vector<std::uint32_t>())
+	{
+	}
+
+	Graph::Graph(NamePool name, std::vector<std::uint64_t> offset, std::vector<NodeId> target, std::vector<std::uint32_t> weight) : _nameLookup(std::make_shared<NameLookup>())
+	{
+		const std::size_t nodeCount = name.size();
+
+		std::shared_ptr<OwnedStorage> storage = std::make_shared<OwnedStorage>();
+
+		if(offset.size() != nodeCount + 1 || target.size() != weight.size() || offset.back() != target.size())
+			throw std::runtime_error("Error: Graph adjacency arrays are inconsistent.");
+
+		storage->offset = std::move(offset);
+		storage->target = std::move(target);
+		storage->weight = std::move(weight);
+		storage->weightedDegree.resize(nodeCount);
+
+		for(std::size_t i=0;i<nodeCount;++i)
+		{
+			std::uint32_t weightedDegree = 0; // Temporarily stores the accumulation of the link weights
+
+			for(std::size_t e=storage->offset[i],endE=storage->offset[i + 1];e<endE;++e)
+				weightedDegree += storage->weight[e];
+
+			storage->weightedDegree[i] = weightedDegree;
+		}
+
+		// The pool already packs the names back to back, as a snapshot does: adopt its buffers and its index as they are
+		name.release(storage->nameOffset, storage->nameData, this->_nameLookup->index);
+		std::call_once(this->_nameLookup->built, []() {});
+
+		this->_layout = layoutOf(*storage);
+		this->_storage = std::move(storage);
+	}
+
+	Graph::Graph(std::shared_ptr<const void> storage, const Layout &layout) : _storage(std::move(storage)), _layout(layout), _nameLookup(std::make_shared<NameLookup>())
+	{
+		const std::size_t nodeCount = layout.weightedDegree.size();
+
+		if(layout.offset.size() != nodeCount + 1 || layout.nameOffset.size() != nodeCount + 1 || layout.target.size() != layout.weight.size()
+			|| layout.offset.front() != 0 || layout.offset.back() != layout.target.size() || layout.nameOffset.front() != 0 || layout.nameOffset.back() != layout.nameData.size())
+		{
+			throw std::runtime_error("Error: Graph adjacency arrays are inconsistent.");
+		}
+	}
+
+	const Graph::Layout &Graph::getLayout(void) const noexcept
+	{
+		return this->_layout;
+	}
+
+	std::size_t Graph::getNodeCount(void) const noexcept
+	{
+		return this->_layout.weightedDegree.size();
+	}
+
+	std::size_t Graph::getEntryCount(void) const noexcept
+	{
+		return this->_layout.target.size();
+	}
+
+	std::string_view Graph::getName(NodeId id) const
+	{
+		if(id >= this->getNodeCount())
+			throw std::out_of_range("Error: Invalid node ID.");
+
+		return std::string_view(this->_layout.nameData.data() + this->_layout.nameOffset[id], this->_layout.nameOffset[id + 1] - this->_layout.nameOffset[id]);
+	}
+
+	std::optional<NodeId> Graph::findNode(std::string_view name) const
+	{
+		std::call_once(this->_nameLookup->built, [this]() { this->_nameLookup->index = NameIndex(this->_layout.nameOffset, this->_layout.nameData); });
+
+		return this->_nameLookup->index.find(name, this->_layout.nameOffset, this->_layout.nameData);
+	}
+
+	unsigned int Graph::getWeightedDegree(NodeId id) const
+	{
+		if(id >= this->getNodeCount())
+			throw std::out_of_range("Error: Invalid node ID.");
+
+		return this->_layout.weightedDegree[id];
+	}
+
+	unsigned int Graph::getLinkCount(NodeId id) const
+	{
+		if(id >= this->getNodeCount())
+			throw std::out_of_range("Error: Invalid node ID.");
+
+		return static_cast<unsigned int>(this->_layout.offset[id + 1] - this->_layout.offset[id]);
+	}
+
+	std::span<const NodeId> Graph::getNeighbours(NodeId id) const
+	{
+		return this->_layout.target.subspan(this->_layout.offset[id], this->getLinkCount(id));
+	}
+
+	std::span<const std::uint32_t> Graph::getWeights(NodeId id) const
+	{
+		return this->_layout.weight.subspan(this->_layout.offset[id], this->getLinkCount(id));
+	}
+
+	std::vector<std::shared_ptr<Node>> Graph::toNodes(std::pmr::memory_resource *resource) const
+	{
+		const std::size_t nodeCount = this->getNodeCount();
+
+		const std::pmr::polymorphic_allocator<Node> allocator(resource);
+		std::vector<std::shared_ptr<Node>> result;
+		std::vector<std::pair<std::shared_ptr<Node>, unsigned int>> link; // Re-used scratch space for one adjacency row
+
+		result.reserve(nodeCount);
+
+		for(std::size_t i=0;i<nodeCount;++i)
+			result.push_back(std::allocate_shared<Node>(allocator, this->getName(static_cast<NodeId>(i)), resource)); // The node and its control block share one allocation
+
+		// Hand each node its whole adjacency row at once, so each node is locked once rather than once per link
+		for(std::size_t i=0;i<nodeCount;++i)
+		{
+			link.clear();
+
+			for(std::size_t e=this->_layout.offset[i],endE=this->_layout.offset[i + 1];e<endE;++e)
+				link.emplace_back(result[this->_layout.target[e]], this->_layout.weight[e]);
+
+			result[i]->addLinks(link);
+		}
+
+		return result;
+	}
+
+	Graph Graph::fromNodes(const std::vector<std::shared_ptr<Node>> &nodeList)
+	{
+		const std::size_t nodeCount = nodeList.size();
+
+		std::unordered_map<const Node*, NodeId> index; // Only used while converting: the resulting graph never touches a shared_ptr
+		NamePool name;
+		std::vector<std::uint64_t> offset(1, 0);
+		std::vector<NodeId> target;
+		std::vector<std::uint32_t> weight;
+		std::vector<std::pair<NodeId,std::uint32_t>> row; // Re-used scratch space for sorting one adjacency row
+
+		index.reserve(nodeCount);
+		name.reserve(nodeCount, 0);
+		offset.reserve(nodeCount + 1);
+
+		for(std::size_t i=0;i<nodeCount;++i)
+		{
+			if(!nodeList[i])
+				throw std::runtime_error("Error: Invalid node.");
+
+			index.emplace(nodeList[i].get(), static_cast<NodeId>(i));
+			name.add(nodeList[i]->getName());
+		}
+
+		for(const std::shared_ptr<Node> &node : nodeList)
+		{
+			row.clear();
+
+			// Visit the links in place, rather than copying each node's link table
+			node->forEachLink([&index, &row](const std::shared_ptr<Node> &link, unsigned int linkWeight)
+			{
+				const auto itIndex = index.find(link.get());
+
+				if(itIndex != index.cend())
+					row.emplace_back(itIndex->second, linkWeight);
+			});
+
+			std::sort(row.begin(), row.end()); // Neighbour order within a row follows NodeId, as with GraphBuilder
+
+			for(const auto &entry : row)
+			{
+				target.push_back(entry.first);
+				weight.push_back(entry.second);
+			}
+
+			offset.push_back(target.size());
+		}
+
+		return Graph(std::move(name), std::move(offset), std::move(target), std::move(weight));
+	}
+
+	GraphBuilder::GraphBuilder(bool nodesCanLinkToSelf, DuplicatePolicy duplicatePolicy) : _nodesCanLinkToSelf(nodesCanLinkToSelf), _duplicatePolicy(duplicatePolicy)
+	{
+	}
+
+	void GraphBuilder::reserve(std::size_t nodeCount, std::size_t linkCount)
+	{
+		this->_name.reserve(nodeCount, 0);
+		this->_link.reserve(linkCount);
+	}
+
+	NodeId GraphBuilder::addNode(std::string_view name)
+	{
+		if(!name.length())
+			throw std::runtime_error("Node invalid: no name provided!"); // Consistent with the Node constructor
+
+		return this->_name.add(name);
+	}
+
+	void GraphBuilder::addLink(NodeId source, NodeId target, unsigned int weight)
+	{
+		this->_link.push_back(Link{source, target, weight});
+	}
+
+	bool GraphBuilder::isValidLink(NodeId source, NodeId target) const noexcept
+	{
+		const std::size_t nodeCount = this->_name.size();
+
+		return source < nodeCount && target < nodeCount && (this->_nodesCanLinkToSelf || source != target);
+	}
+
+	std::optional<std::size_t> GraphBuilder::findInvalidLink(void) const noexcept
+	{
+		for(std::size_t i=0,linkCount=this->_link.size();i<linkCount;++i)
+		{
+			if(!this->isValidLink(this->_link[i].source, this->_link[i].target))
+				return i;
+		}
+
+		return std::nullopt;
+	}
+
+	std::size_t GraphBuilder::getNodeCount(void) const noexcept
+	{
+		return this->_name.size();
+	}
+
+	std::size_t GraphBuilder::getLinkCount(void) const noexcept
+	{
+		return this->_link.size();
+	}
+
+	Graph GraphBuilder::build(std::size_t threadCount)
+	{
+		const std::size_t nodeCount = this->_name.size(), linkCount = this->_link.size(), linkChunkCount = chunkCountOf(linkCount);
+
+		WorkStealingPool pool(threadCount);
+		std::vector<std::size_t> chunkError(linkChunkCount, noIndex); // The first invalid (or repeated) link found by each task
+		std::vector<std::uint64_t> offset(nodeCount + 1, 0), cursor, length(nodeCount), compactOffset(nodeCount + 1, 0);
+		std::vector<BuildEntry> entry;
+		std::vector<NodeId> target, rowChunkBegin(1, 0);
+		std::vector<std::uint32_t> weight;
+
+		const auto throwFirstError = [&chunkError](std::string (*error)(std::size_t))
+		{
+			const auto first = std::min_element(chunkError.cbegin(), chunkError.cend());
+
+			if(first != chunkError.cend() && *first != noIndex)
+				throw std::runtime_error(error(*first));
+		};
+
+		const auto forEachLink = [&](std::size_t chunk, auto &&function)
+		{
+			for(std::size_t i=chunk * buildChunkSize,endI=std::min(linkCount, (chunk + 1) * buildChunkSize);i<endI;++i)
+				function(i, this->_link[i]);
+		};
+
+		pool.parallelFor(linkChunkCount, [&](std::size_t chunk)
+		{
+			forEachLink(chunk, [&](std::size_t i, const Link &link)
+			{
+				if(chunkError[chunk] == noIndex && !this->isValidLink(link.source, link.target))
+					chunkError[chunk] = i;
+			});
+		});
+
+		throwFirstError(invalidLinkError);
+
+		// Pass 1: count the entries of each row (a link to self is only stored once, as Node::addLink rejects the second insert)
+		pool.parallelFor(linkChunkCount, [&](std::size_t chunk)
+		{
+			forEachLink(chunk, [&](std::size_t, const Link &link)
+			{
+				std::atomic_ref<std::uint64_t>(offset[link.source + 1]).fetch_add(1, std::memory_order_relaxed);
+
+				if(link.source != link.target)
+					std::atomic_ref<std::uint64_t>(offset[link.target + 1]).fetch_add(1, std::memory_order_relaxed);
+			});
+		});
+
+		for(std::size_t i=0;i<nodeCount;++i)
+			offset[i + 1] += offset[i];
+
+		// Pass 2: place each link into its pre-sized rows: the order within a row depends on scheduling until the rows are sorted
+		entry.resize(offset.back());
+		cursor.assign(offset.cbegin(), offset.cend() - 1);
+
+		pool.parallelFor(linkChunkCount, [&](std::size_t chunk)
+		{
+			forEachLink(chunk, [&](std::size_t i, const Link &link)
+			{
+				entry[std::atomic_ref<std::uint64_t>(cursor[link.source]).fetch_add(1, std::memory_order_relaxed)] = BuildEntry{link.target, link.weight, i};
+
+				if(link.source != link.target)
+					entry[std::atomic_ref<std::uint64_t>(cursor[link.target]).fetch_add(1, std::memory_order_relaxed)] = BuildEntry{link.source, link.weight, i};
+			});
+		});
+
+		// Group the rows into tasks of similar entry counts
+		for(std::size_t i=0,chunkEntries=0;i<nodeCount;++i)
+		{
+			if((chunkEntries += offset[i + 1] - offset[i] + 1) >= buildChunkSize || i + 1 == nodeCount)
+			{
+				rowChunkBegin.push_back(static_cast<NodeId>(i + 1));
+				chunkEntries = 0;
+			}
+		}
+
+		chunkError.assign(rowChunkBegin.size() - 1, noIndex);
+
+		// Pass 3: sort each row by target then input order, and merge the entries of repeated links in place
+		pool.parallelFor(chunkError.size(), [&](std::size_t chunk)
+		{
+			for(std::size_t row=rowChunkBegin[chunk];row<rowChunkBegin[chunk + 1];++row)
+			{
+				const auto begin = entry.begin() + offset[row], end = entry.begin() + offset[row + 1];
+
+				auto write = begin;
+
+				std::sort(begin, end, [](const BuildEntry &a, const BuildEntry &b) { return a.target < b.target || (a.target == b.target && a.link < b.link); });
+
+				for(auto read=begin;read!=end;++read)
+				{
+					if(write == begin || (write - 1)->target != read->target)
+					{
+						*write++ = *read;
+						continue;
+					}
+
+					BuildEntry &kept = *(write - 1); // The link pre-exists: resolve it with the duplicate policy
+
+					switch(this->_duplicatePolicy)
+					{
+					case DuplicatePolicy::Reject:
+						chunkError[chunk] = std::min(chunkError[chunk], read->link);
+						break;
+
+					case DuplicatePolicy::KeepFirst:
+						break;
+
+					case DuplicatePolicy::SumWeights:
+						kept.weight = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t(kept.weight) + read->weight, std::numeric_limits<std::uint32_t>::max()));
+						break;
+
+					case DuplicatePolicy::MaxWeight:
+						kept.weight = std::max(kept.weight, read->weight);
+						break;
+					}
+				}
+
+				length[row] = static_cast<std::uint64_t>(write - begin);
+			}
+		});
+
+		throwFirstError(duplicateLinkError);
+
+		// Compact the merged rows into the final arrays
+		for(std::size_t i=0;i<nodeCount;++i)
+			compactOffset[i + 1] = compactOffset[i] + length[i];
+
+		target.resize(compactOffset.back());
+		weight.resize(compactOffset.back());
+
+		pool.parallelFor(rowChunkBegin.size() - 1, [&](std::size_t chunk)
+		{
+			for(std::size_t row=rowChunkBegin[chunk];row<rowChunkBegin[chunk + 1];++row)
+			{
+				for(std::uint64_t e=0;e<length[row];++e)
+				{
+					target[compactOffset[row] + e] = entry[offset[row] + e].target;
+					weight[compactOffset[row] + e] = entry[offset[row] + e].weight;
+				}
+			}
+		});
+
+		this->_link.clear();
+
+		return Graph(std::exchange(this->_name, {}), std::move(compactOffset), std::move(target), std::move(weight));
+	}
+
+	std::string GraphBuilder::invalidLinkError(std::size_t index)
+	{
+		return "Invalid link at index '" + std::to_string(index) + "'.";
+	}
+
+	std::string GraphBuilder::duplicateLinkError(std::size_t index)
+	{
+		return "Duplicate link at index '" + std::to_string(index) + "'.";
+	}
+}
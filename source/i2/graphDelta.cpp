@@ -0,0 +1,181 @@
+/*****************************************************************//**
+ * @file   graphDelta.cpp
+ * @brief  The GraphDelta function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/graphDelta.hpp"
+#include <algorithm>
+#include <functional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace I2
+{
+	void GraphDelta::stage(std::shared_ptr<Node> source, std::shared_ptr<Node> target, std::uint32_t weight, Kind kind)
+	{
+		if(!source || !target)
+			throw std::runtime_error("Error: Invalid node.");
+
+		this->_change.push_back(Change{std::move(source), std::move(target), weight, kind});
+	}
+
+	void GraphDelta::reserve(std::size_t changeCount)
+	{
+		this->_change.reserve(changeCount);
+	}
+
+	void GraphDelta::addLink(std::shared_ptr<Node> source, std::shared_ptr<Node> target, unsigned int weight)
+	{
+		this->stage(std::move(source), std::move(target), weight, Kind::Insert);
+	}
+
+	void GraphDelta::removeLink(std::shared_ptr<Node> source, std::shared_ptr<Node> target)
+	{
+		this->stage(std::move(source), std::move(target), 0, Kind::Remove);
+	}
+
+	void GraphDelta::updateLink(std::shared_ptr<Node> source, std::shared_ptr<Node> target, unsigned int weight)
+	{
+		this->stage(std::move(source), std::move(target), weight, Kind::Update);
+	}
+
+	std::size_t GraphDelta::size(void) const noexcept
+	{
+		return this->_change.size();
+	}
+
+	std::size_t GraphDelta::apply(void)
+	{
+		/**
+		 * @brief One direction of a staged change: the change to make to node's links.
+		 */
+		struct Edit
+		{
+			Node *node;
+			const std::shared_ptr<Node> *link;
+			const Change *change;
+		};
+
+		/**
+		 * @brief A change that took effect, reported to the node's observers once every lock is released.
+		 */
+		struct Notification
+		{
+			Node *node;
+			std::shared_ptr<Node> link;
+			std::uint32_t weight;
+			bool added;
+		};
+
+		std::vector<Edit> edit;
+		std::vector<Notification> notification;
+		std::vector<std::unique_lock<std::shared_mutex>> locker;
+		std::size_t changeCount = 0;
+
+		edit.reserve(this->_change.size() * 2);
+
+		for(const Change &change : this->_change)
+		{
+			edit.push_back(Edit{change.source.get(), &change.target, &change});
+
+			if(change.source != change.target) // A self link is a single adjacency entry
+				edit.push_back(Edit{change.target.get(), &change.source, &change});
+		}
+
+		// Group the edits by node, in address order: the stable sort keeps each node's edits in the order they were staged
+		std::stable_sort(edit.begin(), edit.end(), [](const Edit &a, const Edit &b) { return std::less<Node*>()(a.node, b.node); });
+
+		// Lock every affected node in the canonical order before changing any, so both directions of each link change together
+		for(std::size_t e=0,editCount=edit.size();e<editCount;++e)
+		{
+			if(e == 0 || edit[e].node != edit[e - 1].node)
+				locker.emplace_back(edit[e].node->_lock); // Lock for writing (prevent simultaneous read/writes)
+		}
+
+		for(std::size_t first=0,editCount=edit.size(),last;first<editCount;first=last)
+		{
+			Node &node = *edit[first].node;
+			const bool observed = node._isObserved; // Only keep notifications someone will receive: an observer subscribing later sees these changes in the node
+			unsigned int weightedDegree = node._weightedDegree;
+
+			for(last=first;last<editCount && edit[last].node == &node;++last)
+			{
+				const std::shared_ptr<Node> &link = *edit[last].link;
+				const Change &change = *edit[last].change;
+
+				switch(change.kind)
+				{
+					case Kind::Insert:
+						if(node._link.emplace(link, change.weight).second)
+						{
+							weightedDegree += change.weight;
+							++changeCount;
+
+							if(observed)
+								notification.push_back(Notification{&node, link, change.weight, true});
+						}
+						break;
+
+					case Kind::Remove:
+						if(auto itL = node._link.find(link); itL != node._link.end())
+						{
+							weightedDegree -= itL->second;
+							++changeCount;
+
+							if(observed)
+								notification.push_back(Notification{&node, link, itL->second, false});
+
+							node._link.erase(itL);
+						}
+						break;
+
+					case Kind::Update:
+						if(auto itL = node._link.find(link); itL != node._link.end() && itL->second != change.weight)
+						{
+							weightedDegree += change.weight - itL->second;
+							++changeCount;
+
+							if(observed)
+							{
+								notification.push_back(Notification{&node, link, itL->second, false});
+								notification.push_back(Notification{&node, link, change.weight, true});
+							}
+
+							itL->second = change.weight;
+						}
+						break;
+				}
+			}
+
+			node._weightedDegree = weightedDegree; // Written once per node, however many of its links changed
+		}
+
+		locker.clear(); // Release every lock before notifying, as Node does
+
+		// The staged changes may hold the last references to the nodes notified below, so they are kept until every notification is delivered
+		const std::vector<Change> applied = std::exchange(this->_change, std::vector<Change>());
+
+		// Notifications are grouped by node, so each node's observer lock is taken once, and held while its notifications are delivered
+		for(std::size_t first=0,notificationCount=notification.size(),last;first<notificationCount;first=last)
+		{
+			for(last=first;last<notificationCount && notification[last].node == notification[first].node;++last);
+
+			notification[first].node->notifyObservers([&](LinkObserver &observer)
+			{
+				for(std::size_t n=first;n<last;++n)
+				{
+					if(notification[n].added)
+						observer.onLinkAdded(*notification[n].node, notification[n].link, notification[n].weight);
+					else
+						observer.onLinkRemoved(*notification[n].node, notification[n].link, notification[n].weight);
+				}
+			});
+		}
+
+		return changeCount;
+	}
+}
@@ -9,11 +9,260 @@
 #include "i2/io.hpp"
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 namespace I2
 {
 	namespace IO
 	{
+		namespace
+		{
+			constexpr std::size_t streamBufferSize = 1 << 20; // Bytes read from the stream per refill: bounds the parser's memory use
+
+			/**
+			 * @brief A chunked reader over an input stream that keeps track of the absolute offset, for error reporting.
+			 */
+			class StreamCursor
+			{
+			private:
+				std::istream &_input;
+				std::vector<char> _buffer;
+				std::size_t _position = 0, _end = 0, _consumed = 0;
+
+				bool refill(void)
+				{
+					this->_consumed += this->_end;
+					this->_input.read(this->_buffer.data(), static_cast<std::streamsize>(this->_buffer.size()));
+					this->_end = static_cast<std::size_t>(this->_input.gcount());
+					this->_position = 0;
+
+					return this->_end != 0;
+				}
+
+			public:
+				explicit StreamCursor(std::istream &input) : _input(input), _buffer(streamBufferSize)
+				{
+				}
+
+				/**
+				 * @return The next character without consuming it, or EOF at the end of the stream
+				 */
+				int peek(void)
+				{
+					if(this->_position == this->_end && !this->refill())
+						return std::char_traits<char>::eof();
+
+					return static_cast<unsigned char>(this->_buffer[this->_position]);
+				}
+
+				/**
+				 * @return The next character, or EOF at the end of the stream
+				 */
+				int get(void)
+				{
+					const int c = this->peek();
+
+					if(c != std::char_traits<char>::eof())
+						++this->_position;
+
+					return c;
+				}
+
+				void skipWhitespace(void)
+				{
+					for(int c=this->peek();c == ' ' || c == '\t' || c == '\n' || c == '\r';c=this->peek())
+						++this->_position;
+				}
+
+				[[nodiscard]] std::size_t offset(void) const noexcept
+				{
+					return this->_consumed + this->_position;
+				}
+			};
+
+			/**
+			 * @brief Appends a unicode code point to out as UTF-8.
+			 */
+			void appendUTF8(std::string &out, unsigned long codePoint)
+			{
+				if(codePoint < 0x80)
+					out += static_cast<char>(codePoint);
+				else if(codePoint < 0x800)
+				{
+					out += static_cast<char>(0xC0 | (codePoint >> 6));
+					out += static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+				else if(codePoint < 0x10000)
+				{
+					out += static_cast<char>(0xE0 | (codePoint >> 12));
+					out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+					out += static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+				else
+				{
+					out += static_cast<char>(0xF0 | (codePoint >> 18));
+					out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+					out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+					out += static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+			}
+
+			/**
+			 * @brief Reads the four hex digits of a '\\u' escape.
+			 * @return The code unit, or -1 if the digits were invalid
+			 */
+			long readHex4(StreamCursor &cursor)
+			{
+				long result = 0;
+
+				for(int i=0;i<4;++i)
+				{
+					const int c = cursor.get();
+
+					result <<= 4;
+
+					if(c >= '0' && c <= '9')
+						result |= c - '0';
+					else if(c >= 'a' && c <= 'f')
+						result |= c - 'a' + 10;
+					else if(c >= 'A' && c <= 'F')
+						result |= c - 'A' + 10;
+					else
+						return -1;
+				}
+
+				return result;
+			}
+
+			/**
+			 * @brief Reads a string token (the opening quote must be next) into out, decoding escape sequences.
+			 * @return An empty string on success, otherwise a description of the syntax error
+			 */
+			std::string readString(StreamCursor &cursor, std::string &out)
+			{
+				out.clear();
+				cursor.get(); // Opening quote
+
+				for(int c=cursor.get();c != '"';c=cursor.get())
+				{
+					if(c == std::char_traits<char>::eof())
+						return "unterminated string";
+
+					if(c != '\\')
+					{
+						out += static_cast<char>(c);
+						continue;
+					}
+
+					switch(c = cursor.get())
+					{
+						case '"': case '\\': case '/': out += static_cast<char>(c); break;
+						case 'b': out += '\b'; break;
+						case 'f': out += '\f'; break;
+						case 'n': out += '\n'; break;
+						case 'r': out += '\r'; break;
+						case 't': out += '\t'; break;
+						case 'u':
+						{
+							long codePoint = readHex4(cursor);
+
+							if(codePoint < 0)
+								return "invalid unicode escape";
+
+							if(codePoint >= 0xD800 && codePoint <= 0xDBFF) // High surrogate: must be followed by the low surrogate
+							{
+								long low = -1;
+
+								if(cursor.get() == '\\' && cursor.get() == 'u')
+									low = readHex4(cursor);
+
+								if(low < 0xDC00 || low > 0xDFFF)
+									return "invalid unicode surrogate pair";
+
+								codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+							}
+
+							appendUTF8(out, static_cast<unsigned long>(codePoint));
+							break;
+						}
+						default:
+							return "invalid escape sequence";
+					}
+				}
+
+				return "";
+			}
+
+			/**
+			 * @brief Reads a number token into out, validating it against the JSON number grammar.
+			 * @return true if the token was a valid number
+			 */
+			bool readNumber(StreamCursor &cursor, std::string &out)
+			{
+				const auto isDigit = [](int c) { return c >= '0' && c <= '9'; };
+				const auto readDigits = [&](void) { bool any = false; for(int c=cursor.peek();isDigit(c);c=cursor.peek()) { out += static_cast<char>(cursor.get()); any = true; } return any; };
+
+				out.clear();
+
+				if(cursor.peek() == '-')
+					out += static_cast<char>(cursor.get());
+
+				if(cursor.peek() == '0')
+					out += static_cast<char>(cursor.get()); // Leading zeros are not permitted
+				else if(!readDigits())
+					return false;
+
+				if(cursor.peek() == '.')
+				{
+					out += static_cast<char>(cursor.get());
+
+					if(!readDigits())
+						return false;
+				}
+
+				if(cursor.peek() == 'e' || cursor.peek() == 'E')
+				{
+					out += static_cast<char>(cursor.get());
+
+					if(cursor.peek() == '+' || cursor.peek() == '-')
+						out += static_cast<char>(cursor.get());
+
+					if(!readDigits())
+						return false;
+				}
+
+				return true;
+			}
+
+			/**
+			 * @brief Consumes the remainder of a literal (true/false/null).
+			 * @return true if the input matched the literal
+			 */
+			bool readLiteral(StreamCursor &cursor, std::string_view literal)
+			{
+				for(char expected : literal)
+				{
+					if(cursor.get() != static_cast<unsigned char>(expected))
+						return false;
+				}
+
+				return true;
+			}
+		}
+
 		bool loadJSONFromFile(std::string path, Json::Value &result)
 		{
 			std::ifstream file(path, std::ifstream::binary);
@@ -32,5 +281,255 @@ namespace I2
 			std::cerr << "Error: Failed to parse JSON, errors:\n" << errors << std::endl;
 			return false;
 		}
+
+		bool parseJSONFromStream(std::istream &input, JsonHandler &handler, std::string &errors)
+		{
+			enum class Expect { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, Done };
+
+			StreamCursor cursor(input);
+			std::vector<char> container; // Stack of the open containers ('{' or '['), held explicitly so deep nesting cannot overflow the call stack
+			std::string token; // Re-used for every string/number token
+			Expect expect = Expect::Value;
+			int c = 0;
+
+			const auto fail = [&](const std::string &reason)
+			{
+				errors = "Syntax error at offset " + std::to_string(cursor.offset()) + ": " + reason + ".";
+				return false;
+			};
+
+			const auto afterValue = [&](void) { expect = container.empty() ? Expect::Done : Expect::CommaOrEnd; };
+
+			if(cursor.peek() == 0xEF && !readLiteral(cursor, "\xEF\xBB\xBF")) // Skip a UTF-8 byte order mark
+				return fail("invalid byte order mark");
+
+			while(true)
+			{
+				cursor.skipWhitespace();
+				c = cursor.peek();
+
+				if(c == std::char_traits<char>::eof())
+					return expect == Expect::Done ? true : fail("unexpected end of input");
+
+				switch(expect)
+				{
+					case Expect::Done:
+						return fail("unexpected data after the root value");
+
+					case Expect::Colon:
+						if(cursor.get() != ':')
+							return fail("expected ':'");
+
+						expect = Expect::Value;
+						break;
+
+					case Expect::CommaOrEnd:
+						cursor.get();
+
+						if(c == ',')
+							expect = container.back() == '{' ? Expect::Key : Expect::Value;
+						else if(c == (container.back() == '{' ? '}' : ']'))
+						{
+							container.back() == '{' ? handler.onEndObject() : handler.onEndArray();
+							container.pop_back();
+							afterValue();
+						}
+						else
+							return fail("expected ',' or the end of the container");
+
+						break;
+
+					case Expect::Key:
+					case Expect::KeyOrEnd:
+						if(expect == Expect::KeyOrEnd && c == '}')
+						{
+							cursor.get();
+							container.pop_back();
+							handler.onEndObject();
+							afterValue();
+						}
+						else if(c == '"')
+						{
+							const std::string error = readString(cursor, token);
+
+							if(error.length())
+								return fail(error);
+
+							handler.onKey(token);
+							expect = Expect::Colon;
+						}
+						else
+							return fail("expected an object key");
+
+						break;
+
+					case Expect::Value:
+					case Expect::ValueOrEnd:
+						if(expect == Expect::ValueOrEnd && c == ']')
+						{
+							cursor.get();
+							container.pop_back();
+							handler.onEndArray();
+							afterValue();
+						}
+						else if(c == '{')
+						{
+							cursor.get();
+							container.push_back('{');
+							handler.onStartObject();
+							expect = Expect::KeyOrEnd;
+						}
+						else if(c == '[')
+						{
+							cursor.get();
+							container.push_back('[');
+							handler.onStartArray();
+							expect = Expect::ValueOrEnd;
+						}
+						else if(c == '"')
+						{
+							const std::string error = readString(cursor, token);
+
+							if(error.length())
+								return fail(error);
+
+							handler.onString(token);
+							afterValue();
+						}
+						else if(c == '-' || (c >= '0' && c <= '9'))
+						{
+							if(!readNumber(cursor, token))
+								return fail("invalid number");
+
+							handler.onNumber(token);
+							afterValue();
+						}
+						else if(c == 't' || c == 'f' || c == 'n')
+						{
+							const std::string_view literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+
+							if(!readLiteral(cursor, literal))
+								return fail("invalid literal");
+
+							c == 'n' ? handler.onNull() : handler.onBool(c == 't');
+							afterValue();
+						}
+						else
+							return fail("expected a value");
+
+						break;
+				}
+			}
+		}
+
+		bool streamJSONFromFile(std::string path, JsonHandler &handler)
+		{
+			std::ifstream file(path, std::ifstream::binary);
+			std::string errors;
+
+			if(!file.is_open())
+			{
+				std::cerr << "Error: opening file with path '" + path + "' failed.";
+				return false;
+			}
+
+			if(parseJSONFromStream(file, handler, errors))
+				return true;
+
+			std::cerr << "Error: Failed to parse JSON, errors:\n" << errors << std::endl;
+			return false;
+		}
+
+#ifdef _WIN32
+		MappedFile::MappedFile(const std::string &path)
+		{
+			LARGE_INTEGER size;
+
+			this->_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+			if(this->_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(this->_file, &size))
+			{
+				if(this->_file != INVALID_HANDLE_VALUE)
+					CloseHandle(this->_file);
+
+				throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+			}
+
+			this->_size = static_cast<std::size_t>(size.QuadPart);
+
+			if(this->_size) // Empty files cannot be mapped
+			{
+				this->_mapping = CreateFileMappingA(this->_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				this->_data = this->_mapping ? static_cast<const char*>(MapViewOfFile(this->_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+				if(!this->_data)
+				{
+					if(this->_mapping)
+						CloseHandle(this->_mapping);
+
+					CloseHandle(this->_file);
+					throw std::runtime_error("Error: mapping file with path '" + path + "' failed.");
+				}
+			}
+		}
+
+		MappedFile::~MappedFile(void)
+		{
+			if(this->_data)
+				UnmapViewOfFile(this->_data);
+
+			if(this->_mapping)
+				CloseHandle(this->_mapping);
+
+			CloseHandle(this->_file);
+		}
+#else
+		MappedFile::MappedFile(const std::string &path)
+		{
+			struct stat status;
+			const int file = open(path.c_str(), O_RDONLY);
+
+			if(file < 0 || fstat(file, &status) != 0)
+			{
+				if(file >= 0)
+					close(file);
+
+				throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+			}
+
+			this->_size = static_cast<std::size_t>(status.st_size);
+
+			if(this->_size) // Empty files cannot be mapped
+			{
+				void *data = mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+				if(data == MAP_FAILED)
+				{
+					close(file);
+					throw std::runtime_error("Error: mapping file with path '" + path + "' failed.");
+				}
+
+				this->_data = static_cast<const char*>(data);
+			}
+
+			close(file); // The mapping remains valid once the descriptor is closed
+		}
+
+		MappedFile::~MappedFile(void)
+		{
+			if(this->_data)
+				munmap(const_cast<char*>(this->_data), this->_size);
+		}
+#endif
+
+		const char *MappedFile::data(void) const noexcept
+		{
+			return this->_data;
+		}
+
+		std::size_t MappedFile::size(void) const noexcept
+		{
+			return this->_size;
+		}
 	}
-}
\ No newline at end of file
+}
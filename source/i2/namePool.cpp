@@ -0,0 +1,138 @@
+/*****************************************************************//**
+ * @file   namePool.cpp
+ * @brief  The NamePool and NameIndex function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/namePool.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace I2
+{
+	namespace
+	{
+		constexpr std::size_t minSlotCount = 16;
+
+		/**
+		 * @return The name of node id within the arrays
+		 */
+		std::string_view nameOf(NodeId id, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData) noexcept
+		{
+			return std::string_view(nameData.data() + nameOffset[id], nameOffset[id + 1] - nameOffset[id]);
+		}
+	}
+
+	NameIndex::NameIndex(void) : _count(0)
+	{
+	}
+
+	NameIndex::NameIndex(std::span<const std::uint64_t> nameOffset, std::span<const char> nameData) : _count(0)
+	{
+		const std::size_t nodeCount = nameOffset.empty() ? 0 : nameOffset.size() - 1;
+
+		this->_slot.assign(std::bit_ceil(std::max(minSlotCount, nodeCount * 2)), emptySlot); // Sized up front, so no rehashing while indexing
+
+		for(std::size_t i=0;i<nodeCount;++i)
+			this->insert(static_cast<NodeId>(i), nameOffset, nameData);
+	}
+
+	std::size_t NameIndex::probe(std::string_view name, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData) const noexcept
+	{
+		const std::size_t mask = this->_slot.size() - 1;
+
+		// Linear probing: the table is kept at most half full, so probe sequences stay short
+		for(std::size_t slot=std::hash<std::string_view>()(name) & mask;;slot=(slot + 1) & mask)
+		{
+			if(this->_slot[slot] == emptySlot || nameOf(this->_slot[slot], nameOffset, nameData) == name)
+				return slot;
+		}
+	}
+
+	bool NameIndex::insert(NodeId id, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData)
+	{
+		std::size_t slot;
+
+		if((this->_count + 1) * 2 > this->_slot.size())
+		{ // Grow before inserting, re-placing every indexed ID
+			std::vector<NodeId> previous = std::exchange(this->_slot, std::vector<NodeId>(std::max(minSlotCount, this->_slot.size() * 2), emptySlot));
+
+			for(NodeId indexed : previous)
+			{
+				if(indexed != emptySlot)
+					this->_slot[this->probe(nameOf(indexed, nameOffset, nameData), nameOffset, nameData)] = indexed;
+			}
+		}
+
+		slot = this->probe(nameOf(id, nameOffset, nameData), nameOffset, nameData);
+
+		if(this->_slot[slot] != emptySlot)
+			return false; // Keep the lowest ID for a repeated name
+
+		this->_slot[slot] = id;
+		++this->_count;
+
+		return true;
+	}
+
+	std::optional<NodeId> NameIndex::find(std::string_view name, std::span<const std::uint64_t> nameOffset, std::span<const char> nameData) const noexcept
+	{
+		if(this->_slot.empty())
+			return std::nullopt;
+
+		const NodeId id = this->_slot[this->probe(name, nameOffset, nameData)];
+
+		return id == emptySlot ? std::nullopt : std::optional<NodeId>(id);
+	}
+
+	NamePool::NamePool(void) : _offset(1, 0)
+	{
+	}
+
+	void NamePool::reserve(std::size_t nameCount, std::size_t byteCount)
+	{
+		this->_offset.reserve(nameCount + 1);
+		this->_data.reserve(byteCount);
+	}
+
+	NodeId NamePool::add(std::string_view name)
+	{
+		const NodeId id = static_cast<NodeId>(this->size());
+
+		this->_data.insert(this->_data.end(), name.cbegin(), name.cend());
+		this->_offset.push_back(this->_data.size());
+		this->_index.insert(id, this->_offset, this->_data);
+
+		return id;
+	}
+
+	std::string_view NamePool::get(NodeId id) const
+	{
+		if(id >= this->size())
+			throw std::out_of_range("Error: Invalid node ID.");
+
+		return nameOf(id, this->_offset, this->_data);
+	}
+
+	std::optional<NodeId> NamePool::find(std::string_view name) const noexcept
+	{
+		return this->_index.find(name, this->_offset, this->_data);
+	}
+
+	std::size_t NamePool::size(void) const noexcept
+	{
+		return this->_offset.size() - 1;
+	}
+
+	void NamePool::release(std::vector<std::uint64_t> &offset, std::vector<char> &data, NameIndex &index)
+	{
+		offset = std::exchange(this->_offset, std::vector<std::uint64_t>(1, 0));
+		data = std::exchange(this->_data, {});
+		index = std::exchange(this->_index, {});
+	}
+}
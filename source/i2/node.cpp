@@ -7,12 +7,13 @@
  *********************************************************************/
 
 #include "i2/node.hpp"
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 
 namespace I2
 {
-	Node::Node(std::string name) : _name(name), _weightedDegree(0)
+	Node::Node(std::string_view name, std::pmr::memory_resource *resource) : _link(resource), _name(name, resource), _weightedDegree(0)
 	{
 		if(!name.length())
 			throw std::runtime_error("Node invalid: no name provided!");
@@ -20,11 +21,13 @@ namespace I2
 
 	Node::Node(const Node &other)
 	{
+		std::shared_lock<std::shared_mutex> locker(other._lock); // Lock for reading (allow simultaneous reads, but prevent writes)
+
 		this->_name = other._name;
-		this->addLinks(other._link); // The addLinks call will update _weightedDegree
+		this->insertLinks(other._link); // The insertLinks call will update _weightedDegree
 	}
 
-	Node::Node(Node &&other) noexcept
+	Node::Node(Node &&other) noexcept : _link(other._link.get_allocator()), _name(other._name.get_allocator()) // Share the memory resource, so the moves below take the memory rather than copying it
 	{
 		std::shared_lock<std::shared_mutex> locker(other._lock); // Lock for reading (allow simultaneous reads, but prevent writes)
 
@@ -33,14 +36,16 @@ namespace I2
 		this->_link									= std::move(other._link);
 	}
 
-	std::string Node::getName(void) const noexcept
+	std::string_view Node::getName(void) const noexcept
 	{
 		return this->_name;
 	}
 
-	std::unordered_map<std::shared_ptr<Node>, unsigned int> Node::getLinks(void) const noexcept
+	std::unordered_map<std::shared_ptr<Node>, unsigned int> Node::getLinks(void) const
 	{
-		return this->_link;
+		std::shared_lock<std::shared_mutex> locker(this->_lock); // Lock for reading (allow simultaneous reads, but prevent writes)
+
+		return std::unordered_map<std::shared_ptr<Node>, unsigned int>(this->_link.cbegin(), this->_link.cend());
 	}
 
 	unsigned int Node::getWeightedDegree(void) const noexcept
@@ -59,7 +64,7 @@ namespace I2
 
 		std::shared_lock<std::shared_mutex> locker(this->_lock); // Lock for reading (allow simultaneous reads, but prevent writes)
 
-		for(std::unordered_map<std::shared_ptr<Node>,unsigned int>::const_iterator itL=this->_link.cbegin(),endL=this->_link.cend();itL!=endL;++itL)
+		for(std::pmr::unordered_map<std::shared_ptr<Node>,unsigned int>::const_iterator itL=this->_link.cbegin(),endL=this->_link.cend();itL!=endL;++itL)
 			weightedDegree += itL->second; // Accumulate the weight of each node
 
 		this->_weightedDegree = weightedDegree; // Save the weighted result
@@ -72,47 +77,99 @@ namespace I2
 		if(!n)
 			throw std::runtime_error("Error: Invalid node.");
 
-		std::unique_lock<std::shared_mutex> locker(this->_lock); // Lock for writing (prevent simultaneous read/writes)
+		{ // Provide a separate scope so the lock releases prior to notifying the observers
+			std::unique_lock<std::shared_mutex> locker(this->_lock); // Lock for writing (prevent simultaneous read/writes)
 
-		auto insertResult = this->_link.insert(std::pair<std::shared_ptr<Node>,unsigned int>(n,weight));
+			auto insertResult = this->_link.insert(std::pair<std::shared_ptr<Node>,unsigned int>(n,weight));
+
+			if(!insertResult.second)
+			{
+				std::cerr << "Attempted to add a link that pre-exists!";
+				return;
+			}
+
+			this->_weightedDegree += weight; // Insert was successful (link did not pre-exist)
+		}
 
-		if(insertResult.second) // Insert was successful (link did not pre-exist)
-			this->_weightedDegree += weight;
-		else
-			std::cerr << "Attempted to add a link that pre-exists!";
+		this->notifyObservers([&](LinkObserver &observer) { observer.onLinkAdded(*this, n, weight); });
 	}
 
-	void Node::addLinks(std::unordered_map<std::shared_ptr<Node>, unsigned int> link)
+	template<typename Links>
+	void Node::insertLinks(const Links &link)
 	{
 		if(this->getLinkCount())
 		{ // If there are pre-existing links then we need to check if each link pre-exists and only modify the stored weighted degree accordingly
-			for(std::unordered_map<std::shared_ptr<Node>,unsigned int>::const_iterator itL=link.cbegin(),endL=link.cend();itL!=endL;++itL)
+			for(auto itL=link.begin(),endL=link.end();itL!=endL;++itL)
 				this->addLink(itL->first, itL->second);
 		}
 		else 
 		{ // Cut out of the overhead in Node::addLink if there are no pre-existing links to be checked
 			{ // Provide a separate scope so the lock releases prior to the recalculateWeightedDegree call - equivalent to 'locker.release()'
 				std::unique_lock<std::shared_mutex> locker(this->_lock); // Lock for writing (prevent simultaneous read/writes)
-				this->_link.insert(link.cbegin(),link.cend());
+				this->_link.reserve(link.size());
+				this->_link.insert(link.begin(),link.end());
 			}
 
 			this->recalculateWeightedDegree(); // Determine and store the weighted degree after mass insertion of links
+
+			this->notifyObservers([&](LinkObserver &observer)
+			{
+				for(auto itL=link.begin(),endL=link.end();itL!=endL;++itL)
+					observer.onLinkAdded(*this, itL->first, itL->second);
+			});
 		}
 	}
 
+	void Node::addLinks(std::unordered_map<std::shared_ptr<Node>, unsigned int> link)
+	{
+		this->insertLinks(link);
+	}
+
+	void Node::addLinks(std::span<const std::pair<std::shared_ptr<Node>, unsigned int>> link)
+	{
+		this->insertLinks(link);
+	}
+
 	void Node::removeLink(std::shared_ptr<Node> n)
 	{
-		std::unordered_map<std::shared_ptr<Node>, unsigned int>::node_type link;
+		std::pmr::unordered_map<std::shared_ptr<Node>, unsigned int>::node_type link;
 
 		if(!n) // Unable to process n if it is not valid
 			throw std::runtime_error("Error: Invalid node.");
 
-		std::unique_lock<std::shared_mutex> locker(this->_lock); // Lock for writing (prevent simultaneous read/writes)
+		{ // Provide a separate scope so the lock releases prior to notifying the observers
+			std::unique_lock<std::shared_mutex> locker(this->_lock); // Lock for writing (prevent simultaneous read/writes)
+
+			link = this->_link.extract(n); // Extracting the link (if it exists) so that we can use to adjust the weighted degree
+
+			if(link.empty())
+				return;
+
+			this->_weightedDegree -= link.mapped(); // Adjust the over all weighted degree of the weight associated with the link, if the link exists
+		}
+
+		this->notifyObservers([&](LinkObserver &observer) { observer.onLinkRemoved(*this, n, link.mapped()); });
+	}
 
-		link = this->_link.extract(n); // Extracting the link (if it exists) so that we can use to adjust the weighted degree
+	void Node::subscribe(LinkObserver *observer)
+	{
+		if(!observer)
+			throw std::runtime_error("Error: Invalid observer.");
+
+		std::unique_lock<std::shared_mutex> locker(this->_observerLock); // Lock for writing (prevent simultaneous read/writes)
+
+		if(std::find(this->_observer.cbegin(), this->_observer.cend(), observer) == this->_observer.cend())
+			this->_observer.push_back(observer);
+
+		this->_isObserved = true;
+	}
+
+	void Node::unsubscribe(LinkObserver *observer)
+	{
+		std::unique_lock<std::shared_mutex> locker(this->_observerLock); // Waits for any notification in flight to finish
 
-		if(!link.empty()) // Adjust the over all weighted degree of the weight associated with the link, if the link exists
-			this->_weightedDegree -= link.mapped();
+		std::erase(this->_observer, observer);
+		this->_isObserved = !this->_observer.empty();
 	}
 
 	std::strong_ordering Node::operator<=>(const Node &other) const noexcept
@@ -122,12 +179,12 @@ namespace I2
 
 	Node::operator std::string(void) const noexcept
 	{
-		return this->_name + ": " + std::to_string(this->_weightedDegree);
+		return std::string(this->_name) + ": " + std::to_string(this->_weightedDegree);
 	}
 
 	std::ostream & operator<<(std::ostream& os, const Node &n) noexcept
 	{
-		os << static_cast<std::string>(n) << std::endl;
+		os << n.getName() << ": " << n.getWeightedDegree() << '\n'; // No flush per node: callers flush once they are done
 		return os;
 	}
 
@@ -8,163 +8,579 @@
 
 #include "i2/nodeLoader.hpp"
 #include "i2/io.hpp"
+#include "i2/snapshot.hpp"
+#include "i2/edgeList.hpp"
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <optional>
 
 namespace I2
 {
 	namespace NodeLoader
 	{
-		std::vector<std::shared_ptr<Node>> constructNodesFromJSON(const Json::Value &data, bool nodesCanLinkToSelf)
+		namespace
+		{
+			const std::string invalidStructureError = "Error: JSON data is not valid: expected an object containing arrays 'nodes' and 'links'.";
+
+			/**
+			 * @brief Converts a JSON number token with the same rules as Json::Value::isUInt (integral, non-negative and within range).
+			 * @param[in] text The number token
+			 * @return The converted value, or nothing if the number is not an unsigned integer
+			 */
+			std::optional<unsigned int> parseUInt(std::string_view text)
+			{
+				constexpr double maxUInt = static_cast<double>(std::numeric_limits<unsigned int>::max());
+
+				unsigned long long integer = 0;
+				double real = 0.0;
+				auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), integer);
+
+				if(error == std::errc() && end == text.data() + text.size()) // Plain integer: the common case
+					return integer <= std::numeric_limits<unsigned int>::max() ? std::optional<unsigned int>(static_cast<unsigned int>(integer)) : std::nullopt;
+
+				real = std::strtod(std::string(text).c_str(), nullptr); // Fractions/exponents/negatives are rare, so the copy is acceptable
+
+				if(real >= 0.0 && real <= maxUInt && std::trunc(real) == real)
+					return static_cast<unsigned int>(real);
+
+				return std::nullopt;
+			}
+
+			/**
+			 * @brief Orders the best count of total items with the same result as a full sort, in roughly O(total) rather than O(total log total).
+			 * @details Ties break on the lowest index, so the order is total and selecting the top count returns exactly the first count of a full sort.
+			 * @param[in] total The number of items to select from
+			 * @param[in] count The number of items to return: 0 (or more than total) returns every item, fully sorted
+			 * @param[in] isBetter Strict comparison of two item indexes: true when the first should be returned before the second
+			 * @return The indexes of the selected items, best first
+			 */
+			template<typename Comparator>
+			std::vector<std::size_t> selectTop(std::size_t total, std::size_t count, Comparator isBetter)
+			{
+				const auto comes = [&isBetter](std::size_t a, std::size_t b) { return isBetter(a, b) || (!isBetter(b, a) && a < b); };
+
+				std::vector<std::size_t> order(total);
+
+				std::iota(order.begin(), order.end(), 0);
+
+				if(count && count < total)
+				{
+					std::nth_element(order.begin(), order.begin() + count, order.end(), comes); // Partition the best count to the front, without ordering them
+					order.resize(count);
+				}
+
+				std::sort(order.begin(), order.end(), comes); // Only the selected items are sorted
+
+				return order;
+			}
+
+			/**
+			 * @class GraphStreamHandler
+			 * @brief Feeds the 'nodes' and 'links' arrays straight into a GraphBuilder as they are parsed
+			 *
+			 * Validation matches constructGraphFromJSON: node errors take precedence over link errors, and link errors are reported for the
+			 * lowest link index. When the links precede the nodes (as in data.json) the index checks are deferred to GraphBuilder::build.
+			 */
+			class GraphStreamHandler : public IO::JsonHandler
+			{
+			private:
+				enum class Section { None, Nodes, Links };
+				enum class Field { None, Name, Source, Target, Value };
+
+				GraphBuilder &_builder;
+				Section _section = Section::None;
+				Field _field = Field::None;
+				std::size_t _depth = 0, _elementIndex = 0;
+				std::string _rootKey, _name;
+				std::optional<unsigned int> _source, _target, _value;
+				std::optional<std::size_t> _firstInvalidLink;
+				bool _rootIsObject = false, _hasNodes = false, _hasLinks = false, _nodesComplete = false, _elementIsObject = false, _hasName = false;
+
+				[[nodiscard]] bool inElement(void) const noexcept
+				{
+					return this->_section != Section::None && this->_depth == 3 && this->_elementIsObject;
+				}
+
+				void startElement(bool isObject)
+				{
+					this->_elementIsObject = isObject;
+					this->_field = Field::None;
+					this->_hasName = false;
+					this->_source.reset();
+					this->_target.reset();
+					this->_value.reset();
+
+					if(!isObject)
+						this->finishElement(); // Only objects are valid elements
+				}
+
+				void finishElement(void)
+				{
+					const std::size_t index = this->_elementIndex++;
+
+					if(this->_section == Section::Nodes)
+					{
+						if(!this->_elementIsObject || !this->_hasName)
+							throw std::runtime_error("Invalid node at index '" + std::to_string(index) + "'.");
+
+						this->_builder.addNode(this->_name); // Interned into the builder's pool: _name keeps its capacity for the next node
+						return;
+					}
+
+					if(!this->_elementIsObject || !this->_source || !this->_target || !this->_value // Ensure each member is present and an unsigned integer
+						|| (this->_nodesComplete && !this->_builder.isValidLink(*this->_source, *this->_target))) // Ensure the indexes reference a valid node, once the nodes are known
+					{
+						if(this->_nodesComplete)
+							throw std::runtime_error(GraphBuilder::invalidLinkError(index));
+
+						if(!this->_firstInvalidLink)
+							this->_firstInvalidLink = index; // Earlier links may still reference missing nodes, so the error is raised once those are checked
+
+						return;
+					}
+
+					if(!this->_firstInvalidLink) // Later links are irrelevant once an error is pending
+						this->_builder.addLink(*this->_source, *this->_target, *this->_value);
+				}
+
+				void onMember(std::optional<std::string_view> string, std::optional<std::string_view> number)
+				{
+					switch(this->_field)
+					{
+						case Field::Name:
+							this->_hasName = string.has_value();
+							this->_name.assign(string ? *string : std::string_view());
+							break;
+						case Field::Source: this->_source = number ? parseUInt(*number) : std::nullopt; break;
+						case Field::Target: this->_target = number ? parseUInt(*number) : std::nullopt; break;
+						case Field::Value: this->_value = number ? parseUInt(*number) : std::nullopt; break;
+						case Field::None: break;
+					}
+				}
+
+				void onScalar(std::optional<std::string_view> string, std::optional<std::string_view> number)
+				{
+					if(this->_depth == 0)
+						throw std::runtime_error(invalidStructureError);
+
+					if(this->_section != Section::None && this->_depth == 2)
+						this->startElement(false);
+					else if(this->inElement())
+						this->onMember(string, number);
+				}
+
+			public:
+				explicit GraphStreamHandler(GraphBuilder &builder) : _builder(builder)
+				{
+				}
+
+				void onStartObject(void) override
+				{
+					if(this->_depth == 0)
+						this->_rootIsObject = true;
+					else if(this->_section != Section::None && this->_depth == 2)
+						this->startElement(true);
+					else if(this->inElement())
+						this->onMember(std::nullopt, std::nullopt); // A nested container is not a valid member value
+
+					++this->_depth;
+				}
+
+				void onEndObject(void) override
+				{
+					--this->_depth;
+
+					if(this->_section != Section::None && this->_depth == 2 && this->_elementIsObject)
+						this->finishElement();
+				}
+
+				void onStartArray(void) override
+				{
+					if(this->_depth == 0)
+						throw std::runtime_error(invalidStructureError);
+
+					if(this->_depth == 1 && (this->_rootKey == "nodes" || this->_rootKey == "links"))
+					{
+						this->_section = this->_rootKey == "nodes" ? Section::Nodes : Section::Links;
+						(this->_section == Section::Nodes ? this->_hasNodes : this->_hasLinks) = true;
+						this->_elementIndex = 0;
+					}
+					else if(this->_section != Section::None && this->_depth == 2)
+						this->startElement(false);
+					else if(this->inElement())
+						this->onMember(std::nullopt, std::nullopt); // A nested container is not a valid member value
+
+					++this->_depth;
+				}
+
+				void onEndArray(void) override
+				{
+					--this->_depth;
+
+					if(this->_depth == 1 && this->_section != Section::None)
+					{
+						this->_nodesComplete = this->_nodesComplete || this->_section == Section::Nodes;
+						this->_section = Section::None;
+					}
+				}
+
+				void onKey(std::string_view key) override
+				{
+					if(this->_depth == 1)
+						this->_rootKey = key;
+					else if(this->inElement())
+					{
+						if(this->_section == Section::Nodes)
+							this->_field = key == "name" ? Field::Name : Field::None;
+						else
+							this->_field = key == "source" ? Field::Source : (key == "target" ? Field::Target : (key == "value" ? Field::Value : Field::None));
+					}
+				}
+
+				void onString(std::string_view value) override
+				{
+					this->onScalar(value, std::nullopt);
+				}
+
+				void onNumber(std::string_view text) override
+				{
+					this->onScalar(std::nullopt, text);
+				}
+
+				void onBool(bool) override
+				{
+					this->onScalar(std::nullopt, std::nullopt);
+				}
+
+				void onNull(void) override
+				{
+					this->onScalar(std::nullopt, std::nullopt);
+				}
+
+				/**
+				 * @brief Completes validation once the whole document has been parsed, and lays out the graph.
+				 * @param[in] threadCount The number of threads to lay the graph out on (see GraphBuilder::build)
+				 * @return The constructed graph
+				 */
+				Graph finish(std::size_t threadCount)
+				{
+					if(!this->_rootIsObject || !this->_hasNodes || !this->_hasLinks)
+						throw std::runtime_error(invalidStructureError);
+
+					if(this->_firstInvalidLink)
+					{
+						const std::optional<std::size_t> firstRangeError = this->_builder.findInvalidLink(); // Any earlier link that references a missing node
+
+						throw std::runtime_error(GraphBuilder::invalidLinkError(firstRangeError ? std::min(*firstRangeError, *this->_firstInvalidLink) : *this->_firstInvalidLink));
+					}
+
+					return this->_builder.build(threadCount);
+				}
+			};
+		}
+
+		Graph constructGraphFromJSON(const Json::Value &data, bool nodesCanLinkToSelf)
 		{
 			const Json::String nodeKey = "nodes", linkKey = "links", nameKey = "name", sourceKey = "source", targetKey = "target", valueKey = "value";
 
-			std::vector<std::shared_ptr<Node>> result;
-			std::shared_ptr<Node> sourceNode = nullptr, targetNode = nullptr;
+			GraphBuilder builder(nodesCanLinkToSelf);
 			std::size_t nodeCount = 0, linkCount = 0;
-			std::string error = "";
-			unsigned int weight = 0, sourceIndex = 0, targetIndex = 0;
+			unsigned int sourceIndex = 0, targetIndex = 0;
 
 			if(!data.isObject() || !data.isMember(nodeKey) || !data.isMember(linkKey) || !data[nodeKey].isArray() || !data[linkKey].isArray())
-				throw std::runtime_error("Error: JSON data is not valid: expected an object containing arrays 'nodes' and 'links'.");
+				throw std::runtime_error(invalidStructureError);
 
-			// Pre-allocate the size for optimisation (without this the entire result list would have to be relocated in memory on each append,
-			// to make room for the next entry, as the data in a std::vector sits at consecutive memory addresses
+			// Pre-allocate the size for optimisation (without this the builder storage would have to be relocated in memory as it grows)
 			nodeCount = data[nodeKey].size();
-			result.reserve(nodeCount);
+			linkCount = data[linkKey].size();
+			builder.reserve(nodeCount, linkCount);
 
 			// Load the nodes without links (need all nodes to exist prior to linking)
-			for(int i=0;i<nodeCount;++i)
+			for(Json::ArrayIndex i=0;i<nodeCount;++i)
 			{
 				const Json::Value &node = data[nodeKey][i];
 
 				if(!node.isObject() || !node.isMember(nameKey) || !node[nameKey].isString())
 					throw std::runtime_error("Invalid node at index '" + std::to_string(i) + "'.");
 
-				result.push_back(std::make_shared<Node>(node[nameKey].asString()));
+				builder.addNode(node[nameKey].asString());
 			}
 
 			// Link the nodes
-			linkCount = data[linkKey].size();
-
-			for(int i=0;i<linkCount;++i)
+			for(Json::ArrayIndex i=0;i<linkCount;++i)
 			{
-				error = "Invalid link at index '" + std::to_string(i) + "'.";
-
 				const Json::Value &link = data[linkKey][i];
 
 				if(!link.isObject() || !link.isMember(sourceKey)  || !link.isMember(targetKey)  || !link.isMember(valueKey) // Ensure the JSON structure is valid
 					|| !link[sourceKey].isUInt() || !link[targetKey].isUInt() || !link[valueKey].isUInt()) // Ensure each member is an unsigned integer
 				{
-					throw std::runtime_error(error);
+					throw std::runtime_error(GraphBuilder::invalidLinkError(i));
 				}
 
 				sourceIndex = link[sourceKey].asUInt();
 				targetIndex = link[targetKey].asUInt();
 
-				if((sourceIndex >= nodeCount || targetIndex >= nodeCount) // Ensure source and target indexes reference a valid node
-					|| (!nodesCanLinkToSelf && sourceIndex == targetIndex))
+				if(!builder.isValidLink(sourceIndex, targetIndex)) // Ensure source and target indexes reference a valid node (and only self reference if allowed)
+					throw std::runtime_error(GraphBuilder::invalidLinkError(i));
+
+				builder.addLink(sourceIndex, targetIndex, link[valueKey].asUInt());
+			}
+
+			return builder.build();
+		}
+
+		std::vector<std::shared_ptr<Node>> constructNodesFromJSON(const Json::Value &data, bool nodesCanLinkToSelf, std::pmr::memory_resource *resource)
+		{
+			return constructGraphFromJSON(data, nodesCanLinkToSelf).toNodes(resource); // The Node API is a view over the graph layout
+		}
+
+		std::vector<double> computePageRank(const Graph &graph, double dampeningFactor, double tolerance)
+		{
+			PageRankEngine engine(graph);
+
+			return engine.run(PageRankOptions{dampeningFactor, tolerance});
+		}
+
+		std::vector<double> computePageRank(const Graph &graph, const PageRankOptions &options)
+		{
+			PageRankEngine engine(graph);
+
+			return engine.run(options);
+		}
+
+		std::vector<std::pair<std::shared_ptr<Node>,double>> computePageRank(const std::vector<std::shared_ptr<Node>> &nodeList, double dampeningFactor, double tolerance)
+		{
+			const std::size_t nodeCount = nodeList.size();
+
+			std::vector<std::pair<std::shared_ptr<Node>,double>> result;
+			PageRankEngine engine(Graph::fromNodes(nodeList)); // Rank over dense arrays: node i of the list is NodeId i
+			const std::vector<double> &pageRank = engine.run(PageRankOptions{dampeningFactor, tolerance});
+
+			result.reserve(nodeCount);
+
+			for(std::size_t i=0;i<nodeCount;++i)
+				result.emplace_back(nodeList[i], pageRank[i]);
+
+			return result;
+		}
+
+		std::vector<std::pair<NodeId,double>> computePersonalizedPageRank(const Graph &graph, const std::vector<NodeId> &seeds, const PersonalizedPageRankOptions &options)
+		{
+			PersonalizedPageRank query(graph);
+
+			return query.run(seeds, options);
+		}
+
+		std::vector<std::pair<std::shared_ptr<Node>,double>> computePersonalizedPageRank(const std::vector<std::shared_ptr<Node>> &nodeList, const std::vector<std::shared_ptr<Node>> &seeds, const PersonalizedPageRankOptions &options)
+		{
+			std::vector<NodeId> seedId;
+			std::vector<std::pair<std::shared_ptr<Node>,double>> result;
+
+			for(const std::shared_ptr<Node> &seed : seeds)
+			{
+				const auto itNode = std::find(nodeList.cbegin(), nodeList.cend(), seed);
+
+				if(itNode == nodeList.cend())
+					throw std::out_of_range("Error: Seed node is not within the node list.");
+
+				seedId.push_back(static_cast<NodeId>(itNode - nodeList.cbegin()));
+			}
+
+			for(const std::pair<NodeId,double> &related : computePersonalizedPageRank(Graph::fromNodes(nodeList), seedId, options))
+				result.emplace_back(nodeList[related.first], related.second);
+
+			return result;
+		}
+
+		Graph constructGraphFromStream(std::istream &input, bool nodesCanLinkToSelf, DuplicatePolicy duplicatePolicy)
+		{
+			GraphBuilder builder(nodesCanLinkToSelf, duplicatePolicy);
+			GraphStreamHandler handler(builder);
+			std::string errors;
+
+			if(!I2::IO::parseJSONFromStream(input, handler, errors))
+				throw std::runtime_error("Error: Failed to parse JSON, errors:\n" + errors);
+
+			return handler.finish(1);
+		}
+
+		Graph loadGraphFromFile(std::string path, bool nodesCanLinkToSelf, DuplicatePolicy duplicatePolicy, std::size_t threadCount)
+		{
+			GraphBuilder builder(nodesCanLinkToSelf, duplicatePolicy);
+			GraphStreamHandler handler(builder);
+			Graph result;
+
+			if(I2::Snapshot::isSnapshotFile(path)) // Snapshots are mapped rather than parsed: only their header is checked, so opening one takes constant time
+				return I2::Snapshot::loadFromFile(path);
+
+			switch(I2::EdgeList::detectFormat(path))
+			{
+			case I2::EdgeList::Format::Text:
+				return I2::EdgeList::loadText(path, I2::EdgeList::Options{.nodesCanLinkToSelf = nodesCanLinkToSelf, .duplicatePolicy = duplicatePolicy, .threadCount = threadCount});
+
+			case I2::EdgeList::Format::Binary:
+				return I2::EdgeList::loadBinary(path, I2::EdgeList::Options{.nodesCanLinkToSelf = nodesCanLinkToSelf, .duplicatePolicy = duplicatePolicy, .threadCount = threadCount});
+
+			default:
+				break;
+			}
+
+			if(I2::IO::streamJSONFromFile(path, handler)) // Stream the file into the builder, rather than building a Json::Value document first
+				result = handler.finish(threadCount);
+
+			return result;
+		}
+
+		std::vector<std::shared_ptr<Node>> loadNodesFromFile(std::string path, bool nodesCanLinkToSelf, std::pmr::memory_resource *resource)
+		{
+			return loadGraphFromFile(path, nodesCanLinkToSelf).toNodes(resource);
+		}
+
+		void saveRanksToFile(const Graph &graph, const std::vector<double> &pageRank, std::string path)
+		{
+			std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+			std::string line;
+			char buffer[32];
+
+			if(pageRank.size() != graph.getNodeCount())
+				throw std::runtime_error("Error: Ranks do not match the graph.");
+
+			if(!file.is_open())
+				throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+
+			for(NodeId i=0;i<graph.getNodeCount();++i)
+			{
+				const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), pageRank[i]); // Shortest round-trip representation
+
+				(void)error; // 32 characters always hold a double
+				line.assign(graph.getName(i));
+				line.push_back('\t');
+				line.append(buffer, end);
+				line.push_back('\n');
+				file.write(line.data(), static_cast<std::streamsize>(line.size()));
+			}
+
+			if(!file.flush())
+				throw std::runtime_error("Error: writing ranks with path '" + path + "' failed.");
+		}
+
+		std::vector<double> loadRanksFromFile(const Graph &graph, std::string path)
+		{
+			const std::size_t nodeCount = graph.getNodeCount();
+
+			std::ifstream file(path, std::ifstream::binary);
+			std::vector<double> result(nodeCount, std::numeric_limits<double>::quiet_NaN()); // NaN marks a node without a saved rank
+			std::string line;
+			std::size_t lineNumber = 0, matchCount = 0;
+			double rankSum = 0.0;
+
+			if(!file.is_open())
+				throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+
+			while(std::getline(file, line))
+			{
+				++lineNumber;
+
+				if(!line.empty() && line.back() == '\r')
+					line.pop_back();
+
+				const std::size_t tab = line.rfind('\t'); // The rank follows the last tab, so names may hold tabs
+				double rank = 0.0;
+
+				if(tab == std::string::npos || !tab)
+					throw std::runtime_error("Error: rank file '" + path + "' line " + std::to_string(lineNumber) + " is malformed.");
+
+				const auto [end, error] = std::from_chars(line.data() + tab + 1, line.data() + line.size(), rank);
+
+				if(error != std::errc() || end != line.data() + line.size() || !std::isfinite(rank) || rank < 0.0)
+					throw std::runtime_error("Error: rank file '" + path + "' line " + std::to_string(lineNumber) + " is malformed.");
+
+				const std::optional<NodeId> id = graph.findNode(std::string_view(line.data(), tab));
+
+				if(id && std::isnan(result[*id])) // The first rank saved for a name wins, as with the first node of that name in a graph
 				{
-					throw std::runtime_error(error);
+					result[*id] = rank;
+					rankSum += rank;
+					++matchCount;
 				}
+			}
 
-				// Extract the referenced nodes, as well as the assigned weight
-				sourceNode = result[sourceIndex];
-				targetNode = result[targetIndex];
-				weight = link[valueKey].asUInt();
+			const double fill = matchCount ? rankSum / static_cast<double>(matchCount) : 1.0 / static_cast<double>(nodeCount);
 
-				// Add the link to both the source and the target node, together with the associated weight
-				sourceNode->addLink(targetNode,weight);
-				targetNode->addLink(sourceNode,weight);
+			for(double &rank : result)
+			{
+				if(std::isnan(rank))
+					rank = fill;
 			}
 
 			return result;
 		}
 
-		std::vector<std::pair<std::shared_ptr<Node>,double>> computePageRank(const std::vector<std::shared_ptr<Node>> &nodeList, double dampeningFactor, double tolerance)
+		bool pageRankComparatorGT(const std::pair<std::shared_ptr<Node>,double> &a, const std::pair<std::shared_ptr<Node>,double> &b)
 		{
-			const std::size_t nodeCount = nodeList.size();
-			const double nodeCountD = static_cast<double>(nodeCount);
-			const double initialRank = 1.0 / nodeCountD;
-			const double dampeningDiff = 1.0 - dampeningFactor;
-			const double maxRankValue = 1e3;  // Limit rank to 3-4 figures (e.g., max of 1000)
-			constexpr double maxDouble = std::numeric_limits<double>::max();
-
-			std::vector<std::pair<std::shared_ptr<Node>,double>> result(nodeCount);
-			std::unordered_map<std::shared_ptr<Node>,double> pageRank;
-            bool finishedRanking = false;
-			int index = 0;
-
-            // Initialize each node's PageRank value
-
-			for(std::vector<std::shared_ptr<Node>>::const_iterator itN=nodeList.cbegin(),endN=nodeList.cend();itN!=endN;++itN)
-				pageRank[*itN] = initialRank; // Equal distribution of rank initially
-
-            while(!finishedRanking)
-            {
-                finishedRanking = true;
-                std::unordered_map<std::shared_ptr<Node>,double> newPageRank;
-				
-                // Iterate over each node and calculate its new PageRank
-                for(const std::shared_ptr<Node> &node : nodeList)
-                {
-                    double rankSum = 0.0;
-					std::unordered_map<std::shared_ptr<Node>,unsigned int> linkList = node->getLinks();
-
-                    // Get each linked node and accumulate rank contributions
-                    for(const auto &link : linkList)
-                    {
-						const auto &linkedNode = link.first;
-						double weight = static_cast<double>(link.second);
-						double linkCount = static_cast<double>(linkedNode->getLinkCount());
-
-						// If the linked node has an outgoing link, contribute to the rank of this node
-						if(pageRank[linkedNode] < maxDouble / weight)
-							rankSum += (pageRank[linkedNode] * weight) / (linkCount ? linkCount : 1.0);
-						else // If it's too large, apply a maximum rank value
-							rankSum += std::min(maxDouble, pageRank[linkedNode]) / (linkCount ? linkCount : 1.0);
-                    }
-
-                    // Apply the dampening factor and set the new PageRank for this node
-                    newPageRank[node] = dampeningDiff / nodeCountD + dampeningFactor * rankSum;
-                    newPageRank[node] = std::min(newPageRank[node], maxRankValue);
-                }
-
-                // Check for convergence (difference between old and new PageRank values)
-                for(const auto &newPR : newPageRank)
-                {
-                    if(std::fabs(pageRank[newPR.first] - newPR.second) > tolerance)
-                    {
-                        finishedRanking = false;
-                        break;
-                    }
-                }
-
-                // Update the PageRank values
-                pageRank = newPageRank;
-            }
-
-			index = 0;
-
-			for(std::unordered_map<std::shared_ptr<Node>,double>::iterator itPR=pageRank.begin(),endPR=pageRank.end();itPR!=endPR;++itPR)
-				result[index++] = std::make_pair(std::move(itPR->first),std::move(itPR->second)); // Move the results to the output container
+			return a.second > b.second;
+		}
+
+		std::vector<NodeId> topNodesByWeightedDegree(const Graph &graph, std::size_t count)
+		{
+			return topNodesByWeightedDegree(graph.getLayout().weightedDegree, count);
+		}
+
+		std::vector<NodeId> topNodesByWeightedDegree(std::span<const std::uint32_t> weightedDegree, std::size_t count)
+		{
+			std::vector<NodeId> result;
+
+			for(const std::size_t i : selectTop(weightedDegree.size(), count, [&weightedDegree](std::size_t a, std::size_t b) { return weightedDegree[a] > weightedDegree[b]; }))
+				result.push_back(static_cast<NodeId>(i));
+
+			return result;
+		}
+
+		std::vector<NodeId> topNodesByRank(const std::vector<double> &pageRank, std::size_t count)
+		{
+			std::vector<NodeId> result;
+
+			for(const std::size_t i : selectTop(pageRank.size(), count, [&pageRank](std::size_t a, std::size_t b) { return pageRank[a] > pageRank[b]; }))
+				result.push_back(static_cast<NodeId>(i));
 
 			return result;
 		}
 
-		std::vector<std::shared_ptr<Node>> loadNodesFromFile(std::string path, bool nodesCanLinkToSelf)
+		std::vector<std::shared_ptr<Node>> topNodes(const std::vector<std::shared_ptr<Node>> &nodeList, std::size_t count)
 		{
-			Json::Value data;
+			std::vector<unsigned int> weightedDegree; // Read each node once, rather than locking it for every comparison
 			std::vector<std::shared_ptr<Node>> result;
 
-			if(I2::IO::loadJSONFromFile(path, data))
-				result = constructNodesFromJSON(data,nodesCanLinkToSelf);
+			weightedDegree.reserve(nodeList.size());
+
+			for(const std::shared_ptr<Node> &node : nodeList)
+			{
+				if(!node)
+					throw std::runtime_error("Error: Invalid node.");
+
+				weightedDegree.push_back(node->getWeightedDegree());
+			}
+
+			for(const std::size_t i : selectTop(nodeList.size(), count, [&weightedDegree](std::size_t a, std::size_t b) { return weightedDegree[a] > weightedDegree[b]; }))
+				result.push_back(nodeList[i]);
 
 			return result;
 		}
 
-		bool pageRankComparatorGT(const std::pair<std::shared_ptr<Node>,double> &a, const std::pair<std::shared_ptr<Node>,double> &b)
+		std::vector<std::pair<std::shared_ptr<Node>,double>> topPageRanks(const std::vector<std::pair<std::shared_ptr<Node>,double>> &pageRank, std::size_t count)
 		{
-			return a.second > b.second;
+			std::vector<std::pair<std::shared_ptr<Node>,double>> result;
+
+			for(const std::size_t i : selectTop(pageRank.size(), count, [&pageRank](std::size_t a, std::size_t b) { return pageRankComparatorGT(pageRank[a], pageRank[b]); }))
+				result.push_back(pageRank[i]);
+
+			return result;
 		}
 	}
 }
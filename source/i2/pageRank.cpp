@@ -0,0 +1,843 @@
+/*****************************************************************//**
+ * @file   pageRank.cpp
+ * @brief  The PageRankEngine, OutOfCorePageRank, IncrementalPageRank and PersonalizedPageRank function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/pageRank.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace I2
+{
+	namespace
+	{
+		constexpr std::size_t extrapolationSpacing = 4; // Plain iterations between extrapolations: the rate is re-measured after each jump
+		constexpr double extrapolationRateDrift = 0.05; // How much two successive rates may differ, relatively, for the series to count as geometric
+		constexpr double maxExtrapolationRate = 0.99; // Slower series are left to plain iteration: the jump would be too long to trust
+	}
+
+	PageRankEngine::PageRankEngine(Graph graph) : _graph(std::move(graph))
+	{
+		this->allocate();
+	}
+
+	PageRankEngine::PageRankEngine(CompressedGraph graph) : _compressedGraph(std::move(graph)), _isCompressed(true)
+	{
+		this->allocate();
+	}
+
+	void PageRankEngine::allocate(void)
+	{
+		const std::size_t nodeCount = this->_isCompressed ? this->_compressedGraph.getNodeCount() : this->_graph.getNodeCount();
+
+		this->_normaliser.resize(nodeCount);
+		this->_rank.resize(nodeCount);
+		this->_nextRank.resize(nodeCount);
+		this->_contribution.resize(nodeCount);
+		this->_nextContribution.resize(nodeCount);
+		this->_chunkBegin.push_back(0);
+
+		for(std::size_t i=0,chunkEntries=0;i<nodeCount;++i)
+		{
+			const NodeId id = static_cast<NodeId>(i);
+			const std::uint64_t linkCount = this->_isCompressed ? this->_compressedGraph.getLinkCount(id) : this->_graph.getLinkCount(id);
+
+			this->_normaliser[i] = 1.0 / static_cast<double>(linkCount ? linkCount : 1);
+
+			// Close the chunk once it holds enough work, so hub nodes get a chunk to themselves and stealing can balance the rest
+			if((chunkEntries += linkCount + 1) >= Kernels::chunkSize || i + 1 == nodeCount)
+			{
+				this->_chunkBegin.push_back(static_cast<NodeId>(i + 1));
+				chunkEntries = 0;
+			}
+		}
+
+		this->_chunkResidual.resize(this->_chunkBegin.size() - 1);
+	}
+
+	void PageRankEngine::rankChunk(std::size_t chunk, double teleport, const PageRankOptions &options) noexcept
+	{
+		const Graph::Layout &layout = this->_graph.getLayout();
+		const std::size_t begin = this->_chunkBegin[chunk], end = this->_chunkBegin[chunk + 1];
+
+		// Gather each node's rank sum from its neighbours: ranks are capped at maxRankValue, so the products cannot overflow
+		if(this->_isCompressed)
+		{
+			for(std::size_t i=begin;i<end;++i)
+			{
+				double rankSum = 0.0;
+
+				this->_compressedGraph.forEachLink(static_cast<NodeId>(i), [&](NodeId target, std::uint32_t weight)
+				{
+					rankSum += this->_contribution[target] * static_cast<double>(weight);
+				});
+
+				this->_nextRank[i] = rankSum;
+			}
+		}
+		else
+		{
+			for(std::size_t i=begin;i<end;++i)
+			{
+				double rankSum = 0.0;
+
+				for(std::uint64_t e=layout.offset[i],endE=layout.offset[i + 1];e<endE;++e)
+					rankSum += this->_contribution[layout.target[e]] * static_cast<double>(layout.weight[e]);
+
+				this->_nextRank[i] = rankSum;
+			}
+		}
+
+		// Apply the dampening factor, clamp, and prepare the next iteration's contributions, saving a separate pass
+		this->_chunkResidual[chunk] = Kernels::dampen(this->_rank.data() + begin, this->_nextRank.data() + begin, this->_nextContribution.data() + begin, this->_normaliser.data() + begin,
+			end - begin, teleport, options.dampeningFactor, options.maxRankValue);
+	}
+
+	void PageRankEngine::sweepChunk(std::size_t chunk, double teleport, const PageRankOptions &options) noexcept
+	{
+		const Graph::Layout &layout = this->_graph.getLayout();
+		const std::size_t begin = this->_chunkBegin[chunk], end = this->_chunkBegin[chunk + 1];
+
+		Kernels::Residual residual;
+
+		// As rankChunk, but each node's new rank is final before the next node gathers, and nodes earlier in the chunk are gathered from their new contribution
+		for(std::size_t i=begin;i<end;++i)
+		{
+			double rankSum = 0.0;
+
+			const auto gather = [&](NodeId target, std::uint32_t weight)
+			{
+				rankSum += (target >= begin && target < i ? this->_nextContribution[target] : this->_contribution[target]) * static_cast<double>(weight);
+			};
+
+			if(this->_isCompressed)
+				this->_compressedGraph.forEachLink(static_cast<NodeId>(i), gather);
+			else
+			{
+				for(std::uint64_t e=layout.offset[i],endE=layout.offset[i + 1];e<endE;++e)
+					gather(layout.target[e], layout.weight[e]);
+			}
+
+			const double nextRank = std::min(teleport + options.dampeningFactor * rankSum, options.maxRankValue), change = std::fabs(nextRank - this->_rank[i]);
+
+			this->_nextRank[i] = nextRank;
+			this->_nextContribution[i] = nextRank * this->_normaliser[i];
+			residual.l1 += change;
+			residual.lInf = std::max(residual.lInf, change);
+		}
+
+		this->_chunkResidual[chunk] = residual;
+	}
+
+	double PageRankEngine::measureRate(void)
+	{
+		double product = 0.0, previousSquare = 0.0;
+
+		// _rank, _nextRank and _previousRank hold the last three iterates, newest first, as the buffers have just been rotated
+		this->_pool->parallelFor(this->_chunkResidual.size(), [&](std::size_t chunk)
+		{
+			std::pair<double,double> &sum = this->_chunkProduct[chunk];
+
+			sum = std::make_pair(0.0, 0.0);
+
+			for(std::size_t i=this->_chunkBegin[chunk],endI=this->_chunkBegin[chunk + 1];i<endI;++i)
+			{
+				const double change = this->_rank[i] - this->_nextRank[i], previousChange = this->_nextRank[i] - this->_previousRank[i];
+
+				sum.first += change * previousChange;
+				sum.second += previousChange * previousChange;
+			}
+		});
+
+		for(const std::pair<double,double> &sum : this->_chunkProduct) // Reduced in chunk order, as with the residual
+		{
+			product += sum.first;
+			previousSquare += sum.second;
+		}
+
+		return previousSquare > 0.0 ? product / previousSquare : 0.0;
+	}
+
+	void PageRankEngine::extrapolate(double factor, const PageRankOptions &options)
+	{
+		this->_pool->parallelFor(this->_chunkResidual.size(), [&](std::size_t chunk)
+		{
+			for(std::size_t i=this->_chunkBegin[chunk],endI=this->_chunkBegin[chunk + 1];i<endI;++i)
+			{
+				this->_rank[i] = std::clamp(this->_rank[i] + factor * (this->_rank[i] - this->_nextRank[i]), 0.0, options.maxRankValue);
+				this->_contribution[i] = this->_rank[i] * this->_normaliser[i];
+			}
+		});
+
+		++this->_extrapolationCount;
+	}
+
+	const std::vector<double> &PageRankEngine::run(const PageRankOptions &options)
+	{
+		std::fill(this->_rank.begin(), this->_rank.end(), 1.0 / static_cast<double>(this->_rank.size())); // Equal distribution of rank initially
+
+		return this->iterate(options);
+	}
+
+	const std::vector<double> &PageRankEngine::run(const PageRankOptions &options, const std::vector<double> &initialRank)
+	{
+		if(initialRank.size() != this->_rank.size())
+			throw std::runtime_error("Error: Initial ranks do not match the graph.");
+
+		std::copy(initialRank.cbegin(), initialRank.cend(), this->_rank.begin());
+
+		return this->iterate(options);
+	}
+
+	const std::vector<double> &PageRankEngine::iterate(const PageRankOptions &options)
+	{
+		const std::size_t nodeCount = this->_rank.size(), chunkCount = this->_chunkResidual.size();
+		const double teleport = (1.0 - options.dampeningFactor) / static_cast<double>(nodeCount);
+
+		const bool accelerate = options.acceleration == Acceleration::Extrapolation;
+
+		bool finishedRanking = nodeCount == 0;
+		std::size_t sinceExtrapolation = 0; // Plain iterations since the last extrapolation (or the start)
+		double previousRate = 0.0;
+
+		if(!this->_pool || this->_poolThreadCount != options.threadCount)
+		{
+			this->_pool = std::make_unique<WorkStealingPool>(options.threadCount);
+			this->_poolThreadCount = options.threadCount;
+		}
+
+		if(accelerate && this->_previousRank.size() != nodeCount)
+		{ // Only allocated once a run extrapolates
+			this->_previousRank.resize(nodeCount);
+			this->_chunkProduct.resize(chunkCount);
+		}
+
+		for(std::size_t i=0;i<nodeCount;++i)
+			this->_contribution[i] = this->_rank[i] * this->_normaliser[i];
+
+		this->_iterationCount = 0;
+		this->_extrapolationCount = 0;
+		this->_residual = Kernels::Residual();
+		this->_residualHistory.clear();
+
+		while(!finishedRanking && (!options.maxIterations || this->_iterationCount < options.maxIterations))
+		{
+			++this->_iterationCount;
+
+			if(accelerate)
+				this->_previousRank.swap(this->_nextRank); // Keep the ranks from two iterations back: the iteration overwrites every entry of _nextRank
+
+			if(options.acceleration == Acceleration::GaussSeidel)
+				this->_pool->parallelFor(chunkCount, [&](std::size_t chunk) { this->sweepChunk(chunk, teleport, options); });
+			else
+				this->_pool->parallelFor(chunkCount, [&](std::size_t chunk) { this->rankChunk(chunk, teleport, options); });
+
+			// Check for convergence (difference between old and new PageRank values): reduced in chunk order, so the result is independent of scheduling
+			this->_residual = Kernels::Residual();
+
+			for(const Kernels::Residual &residual : this->_chunkResidual)
+			{
+				this->_residual.l1 += residual.l1;
+				this->_residual.lInf = std::max(this->_residual.lInf, residual.lInf);
+			}
+
+			finishedRanking = (options.stoppingRule == StoppingRule::L1 ? this->_residual.l1 : this->_residual.lInf) <= options.tolerance;
+
+			if(options.recordResiduals)
+				this->_residualHistory.push_back(this->_residual);
+
+			this->_rank.swap(this->_nextRank);
+			this->_contribution.swap(this->_nextContribution);
+
+			// The first change after the start (or a jump) has no predecessor in the same series, so the rate is measured from the second
+			if(accelerate && !finishedRanking && ++sinceExtrapolation >= 2)
+			{
+				const double rate = this->measureRate();
+
+				// Two successive rates must agree, so the series the jump sums is really geometric
+				if(sinceExtrapolation >= extrapolationSpacing && std::fabs(rate) <= maxExtrapolationRate && std::fabs(rate - previousRate) <= extrapolationRateDrift * std::fabs(rate))
+				{
+					this->extrapolate(rate / (1.0 - rate), options);
+					sinceExtrapolation = 0;
+					previousRate = 0.0;
+				}
+				else
+					previousRate = rate;
+			}
+		}
+
+		this->_hasConverged = finishedRanking;
+
+		return this->_rank;
+	}
+
+	const std::vector<double> &PageRankEngine::getRanks(void) const noexcept
+	{
+		return this->_rank;
+	}
+
+	Kernels::Residual PageRankEngine::getResidual(void) const noexcept
+	{
+		return this->_residual;
+	}
+
+	const std::vector<Kernels::Residual> &PageRankEngine::getResidualHistory(void) const noexcept
+	{
+		return this->_residualHistory;
+	}
+
+	std::size_t PageRankEngine::getIterationCount(void) const noexcept
+	{
+		return this->_iterationCount;
+	}
+
+	std::size_t PageRankEngine::getExtrapolationCount(void) const noexcept
+	{
+		return this->_extrapolationCount;
+	}
+
+	bool PageRankEngine::hasConverged(void) const noexcept
+	{
+		return this->_hasConverged;
+	}
+
+	OutOfCorePageRank::OutOfCorePageRank(const ShardedGraph &graph) : _graph(graph), _reader(1)
+	{
+		const std::size_t nodeCount = this->_graph.getNodeCount();
+
+		this->_rank.resize(nodeCount);
+		this->_contribution.resize(nodeCount);
+		this->_nextContribution.resize(nodeCount);
+	}
+
+	void OutOfCorePageRank::prepareBlock(void)
+	{
+		const std::size_t rowCount = this->_block.end - this->_block.begin;
+
+		this->_blockRank.resize(rowCount);
+		this->_blockNormaliser.resize(rowCount);
+		this->_chunkBegin.assign(1, 0);
+
+		// Split the block into the chunks PageRankEngine would: blocks start and end at chunk boundaries
+		for(std::size_t i=0,chunkEntries=0;i<rowCount;++i)
+		{
+			const std::uint64_t linkCount = this->_block.offset[i + 1] - this->_block.offset[i];
+
+			this->_blockNormaliser[i] = 1.0 / static_cast<double>(linkCount ? linkCount : 1);
+
+			if((chunkEntries += linkCount + 1) >= Kernels::chunkSize || i + 1 == rowCount)
+			{
+				this->_chunkBegin.push_back(static_cast<NodeId>(i + 1));
+				chunkEntries = 0;
+			}
+		}
+
+		this->_chunkResidual.resize(this->_chunkBegin.size() - 1);
+	}
+
+	void OutOfCorePageRank::rankChunk(std::size_t chunk, double teleport, const PageRankOptions &options) noexcept
+	{
+		const ShardedGraph::Block &block = this->_block;
+		const std::size_t begin = this->_chunkBegin[chunk], end = this->_chunkBegin[chunk + 1];
+
+		// As PageRankEngine::rankChunk, with the block's rows
+		for(std::size_t i=begin;i<end;++i)
+		{
+			double rankSum = 0.0;
+
+			for(std::uint64_t e=block.offset[i],endE=block.offset[i + 1];e<endE;++e)
+				rankSum += this->_contribution[block.target[e]] * static_cast<double>(block.weight[e]);
+
+			this->_blockRank[i] = rankSum;
+		}
+
+		this->_chunkResidual[chunk] = Kernels::dampen(this->_rank.data() + block.begin + begin, this->_blockRank.data() + begin, this->_nextContribution.data() + block.begin + begin,
+			this->_blockNormaliser.data() + begin, end - begin, teleport, options.dampeningFactor, options.maxRankValue);
+
+		std::copy(this->_blockRank.cbegin() + begin, this->_blockRank.cbegin() + end, this->_rank.begin() + block.begin + begin); // No other chunk reads these ranks
+	}
+
+	void OutOfCorePageRank::forEachBlock(const std::function<void(void)> &function)
+	{
+		const std::size_t blockCount = this->_graph.getBlockCount();
+
+		for(std::size_t b=0;b<blockCount;++b)
+		{
+			if(this->_nextBlockIndex == b)
+			{ // Read ahead while the previous block was ranked
+				this->_nextBlockIndex = this->_blockIndex = noBlock; // Neither block can be trusted if the read failed
+				this->_reader.wait();
+				std::swap(this->_block, this->_nextBlock);
+				this->_blockIndex = b;
+			}
+			else if(this->_blockIndex != b)
+			{
+				this->_blockIndex = noBlock;
+				this->_graph.readBlock(b, this->_block);
+				this->_blockIndex = b;
+			}
+
+			// Read the following block, wrapping around to the first for the next pass, while this one is in use
+			if(const std::size_t next=(b + 1) % blockCount;next != b)
+			{
+				this->_nextBlockIndex = next;
+				this->_reader.submit([this,next]() { this->_graph.readBlock(next, this->_nextBlock); });
+			}
+
+			this->prepareBlock();
+			function();
+		}
+
+		this->_reader.wait(); // The read ahead overlapped the last block: finish it, so its errors surface here and the next pass finds it ready
+	}
+
+	const std::vector<double> &OutOfCorePageRank::run(const PageRankOptions &options)
+	{
+		std::fill(this->_rank.begin(), this->_rank.end(), 1.0 / static_cast<double>(this->_graph.getNodeCount())); // Equal distribution of rank initially
+
+		return this->iterate(options);
+	}
+
+	const std::vector<double> &OutOfCorePageRank::run(const PageRankOptions &options, const std::vector<double> &initialRank)
+	{
+		if(initialRank.size() != this->_graph.getNodeCount())
+			throw std::runtime_error("Error: Initial ranks do not match the graph.");
+
+		std::copy(initialRank.cbegin(), initialRank.cend(), this->_rank.begin());
+
+		return this->iterate(options);
+	}
+
+	const std::vector<double> &OutOfCorePageRank::iterate(const PageRankOptions &options)
+	{
+		const std::size_t nodeCount = this->_graph.getNodeCount();
+		const double teleport = (1.0 - options.dampeningFactor) / static_cast<double>(nodeCount);
+
+		bool finishedRanking = nodeCount == 0;
+
+		if(options.acceleration != Acceleration::None)
+			throw std::runtime_error("Error: Out-of-core ranking does not support acceleration.");
+
+		if(!this->_pool || this->_poolThreadCount != options.threadCount)
+		{
+			this->_pool = std::make_unique<WorkStealingPool>(options.threadCount);
+			this->_poolThreadCount = options.threadCount;
+		}
+
+		// The normalisers live in the blocks, so the first contributions take a pass of their own
+		this->forEachBlock([this]()
+		{
+			for(std::size_t i=0,rowCount=this->_blockNormaliser.size();i<rowCount;++i)
+				this->_contribution[this->_block.begin + i] = this->_rank[this->_block.begin + i] * this->_blockNormaliser[i];
+		});
+
+		this->_iterationCount = 0;
+		this->_residual = Kernels::Residual();
+		this->_residualHistory.clear();
+
+		while(!finishedRanking && (!options.maxIterations || this->_iterationCount < options.maxIterations))
+		{
+			++this->_iterationCount;
+			this->_residual = Kernels::Residual();
+
+			this->forEachBlock([&]()
+			{
+				this->_pool->parallelFor(this->_chunkResidual.size(), [&](std::size_t chunk) { this->rankChunk(chunk, teleport, options); });
+
+				// Reduced in chunk order across the blocks, so the residual matches PageRankEngine's
+				for(const Kernels::Residual &residual : this->_chunkResidual)
+				{
+					this->_residual.l1 += residual.l1;
+					this->_residual.lInf = std::max(this->_residual.lInf, residual.lInf);
+				}
+			});
+
+			finishedRanking = (options.stoppingRule == StoppingRule::L1 ? this->_residual.l1 : this->_residual.lInf) <= options.tolerance;
+
+			if(options.recordResiduals)
+				this->_residualHistory.push_back(this->_residual);
+
+			this->_contribution.swap(this->_nextContribution);
+		}
+
+		this->_hasConverged = finishedRanking;
+
+		return this->_rank;
+	}
+
+	const std::vector<double> &OutOfCorePageRank::getRanks(void) const noexcept
+	{
+		return this->_rank;
+	}
+
+	Kernels::Residual OutOfCorePageRank::getResidual(void) const noexcept
+	{
+		return this->_residual;
+	}
+
+	const std::vector<Kernels::Residual> &OutOfCorePageRank::getResidualHistory(void) const noexcept
+	{
+		return this->_residualHistory;
+	}
+
+	std::size_t OutOfCorePageRank::getIterationCount(void) const noexcept
+	{
+		return this->_iterationCount;
+	}
+
+	bool OutOfCorePageRank::hasConverged(void) const noexcept
+	{
+		return this->_hasConverged;
+	}
+
+	IncrementalPageRank::IncrementalPageRank(std::vector<std::shared_ptr<Node>> nodeList, const PageRankOptions &options) : _nodeList(std::move(nodeList)), _options(options)
+	{
+		const std::size_t nodeCount = this->_nodeList.size();
+
+		std::unique_lock<std::mutex> locker(this->_lock); // Edits made while the initial ranks are computed wait, and are then applied on top of them
+
+		for(std::size_t i=0;i<nodeCount;++i)
+		{
+			if(!this->_nodeList[i])
+				throw std::runtime_error("Error: Invalid node.");
+
+			this->_index.emplace(this->_nodeList[i].get(), static_cast<NodeId>(i));
+		}
+
+		try
+		{
+			// Subscribe before taking the snapshot, so no edit can be missed: an edit that is already within the snapshot is ignored when it arrives.
+			// A node listed twice is subscribed to once, as subscribing again would wait on a notification to this, which waits on the lock held here
+			for(std::size_t i=0;i<nodeCount;++i)
+			{
+				if(this->_index.at(this->_nodeList[i].get()) == i)
+					this->_nodeList[i]->subscribe(this);
+			}
+
+			const Graph graph = Graph::fromNodes(this->_nodeList);
+
+			PageRankEngine engine(graph);
+
+			this->_row.resize(nodeCount);
+			this->_gatheredBy.resize(nodeCount);
+			this->_isPending.assign(nodeCount, false);
+
+			for(NodeId i=0;i<nodeCount;++i)
+			{
+				const std::span<const NodeId> neighbours = graph.getNeighbours(i);
+				const std::span<const std::uint32_t> weights = graph.getWeights(i);
+
+				for(std::size_t e=0,endE=neighbours.size();e<endE;++e)
+				{
+					this->_row[i].emplace_back(neighbours[e], weights[e]);
+					this->_gatheredBy[neighbours[e]].push_back(i);
+				}
+			}
+
+			this->_rank = engine.run(options);
+		}
+		catch(...)
+		{
+			locker.unlock(); // Unsubscribing waits for notifications in flight, which wait for this lock
+
+			for(const std::shared_ptr<Node> &node : this->_nodeList)
+				node->unsubscribe(this);
+
+			throw;
+		}
+	}
+
+	IncrementalPageRank::~IncrementalPageRank(void)
+	{
+		for(const std::shared_ptr<Node> &node : this->_nodeList)
+			node->unsubscribe(this);
+	}
+
+	void IncrementalPageRank::markPending(NodeId id)
+	{
+		if(this->_isPending[id])
+			return;
+
+		this->_isPending[id] = true;
+		this->_pending.push_back(id);
+	}
+
+	void IncrementalPageRank::markLinkChanged(NodeId id)
+	{
+		this->markPending(id); // The node's row changed
+
+		for(const NodeId gatherer : this->_gatheredBy[id])
+			this->markPending(gatherer); // The node's link count (and so the share of rank it hands out) changed
+	}
+
+	double IncrementalPageRank::evaluate(NodeId id) const noexcept
+	{
+		const double teleport = (1.0 - this->_options.dampeningFactor) / static_cast<double>(this->_rank.size());
+
+		double rankSum = 0.0;
+
+		// The same rank equation as PageRankEngine: each linked node hands out rank * weight / linkCount
+		for(const std::pair<NodeId,std::uint32_t> &link : this->_row[id])
+		{
+			const std::size_t linkCount = this->_row[link.first].size();
+
+			rankSum += this->_rank[link.first] * (1.0 / static_cast<double>(linkCount ? linkCount : 1)) * static_cast<double>(link.second);
+		}
+
+		return std::min(teleport + this->_options.dampeningFactor * rankSum, this->_options.maxRankValue);
+	}
+
+	std::size_t IncrementalPageRank::propagate(void)
+	{
+		std::size_t evaluationCount = 0;
+
+		while(!this->_pending.empty())
+		{
+			const NodeId id = this->_pending.front();
+
+			this->_pending.pop_front();
+			this->_isPending[id] = false;
+			++evaluationCount;
+
+			const double nextRank = this->evaluate(id);
+			const double change = std::fabs(nextRank - this->_rank[id]);
+
+			this->_rank[id] = nextRank;
+
+			// Only pass on a change that a full run would not have stopped at
+			if(change > this->_options.tolerance)
+			{
+				for(const NodeId gatherer : this->_gatheredBy[id])
+					this->markPending(gatherer);
+			}
+		}
+
+		return evaluationCount;
+	}
+
+	std::size_t IncrementalPageRank::update(void)
+	{
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		return this->propagate();
+	}
+
+	std::size_t IncrementalPageRank::refresh(void)
+	{
+		const std::size_t nodeCount = this->_nodeList.size();
+
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		NamePool name;
+		std::vector<std::uint64_t> offset(1, 0);
+		std::vector<NodeId> target;
+		std::vector<std::uint32_t> weight;
+		std::vector<std::pair<NodeId,std::uint32_t>> row; // Re-used scratch space for sorting one adjacency row
+
+		this->propagate();
+
+		// Lay the mirrored rows out as a graph, so the full iterations run on the dense engine
+		name.reserve(nodeCount, 0);
+		offset.reserve(nodeCount + 1);
+
+		for(std::size_t i=0;i<nodeCount;++i)
+		{
+			name.add(this->_nodeList[i]->getName());
+			row = this->_row[i];
+
+			std::sort(row.begin(), row.end()); // Neighbour order within a row follows NodeId, as with Graph::fromNodes
+
+			for(const auto &entry : row)
+			{
+				target.push_back(entry.first);
+				weight.push_back(entry.second);
+			}
+
+			offset.push_back(target.size());
+		}
+
+		PageRankEngine engine(Graph(std::move(name), std::move(offset), std::move(target), std::move(weight)));
+
+		this->_rank = engine.run(this->_options, this->_rank);
+
+		return engine.getIterationCount();
+	}
+
+	std::vector<std::pair<std::shared_ptr<Node>,double>> IncrementalPageRank::getRanks(void)
+	{
+		std::vector<std::pair<std::shared_ptr<Node>,double>> result;
+
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		this->propagate();
+
+		result.reserve(this->_nodeList.size());
+
+		for(std::size_t i=0,nodeCount=this->_nodeList.size();i<nodeCount;++i)
+			result.emplace_back(this->_nodeList[i], this->_rank[i]);
+
+		return result;
+	}
+
+	double IncrementalPageRank::getRank(const std::shared_ptr<Node> &node)
+	{
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		const auto itIndex = this->_index.find(node.get());
+
+		if(itIndex == this->_index.cend())
+			throw std::out_of_range("Error: Node is not ranked.");
+
+		this->propagate();
+
+		return this->_rank[itIndex->second];
+	}
+
+	std::size_t IncrementalPageRank::getPendingCount(void) const
+	{
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		return this->_pending.size();
+	}
+
+	void IncrementalPageRank::onLinkAdded(Node &node, const std::shared_ptr<Node> &link, unsigned int weight)
+	{
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		const auto itSource = this->_index.find(&node), itTarget = this->_index.find(link.get());
+
+		if(itSource == this->_index.cend() || itTarget == this->_index.cend())
+			return; // Links to nodes outside of the list are not ranked
+
+		std::vector<std::pair<NodeId,std::uint32_t>> &row = this->_row[itSource->second];
+
+		if(std::find_if(row.cbegin(), row.cend(), [&](const auto &entry) { return entry.first == itTarget->second; }) != row.cend())
+			return; // Already mirrored: the edit was made while the initial ranks were computed
+
+		row.emplace_back(itTarget->second, weight);
+		this->_gatheredBy[itTarget->second].push_back(itSource->second);
+		this->markLinkChanged(itSource->second);
+	}
+
+	void IncrementalPageRank::onLinkRemoved(Node &node, const std::shared_ptr<Node> &link, unsigned int weight)
+	{
+		(void)weight; // The mirrored row holds the weight
+
+		std::lock_guard<std::mutex> locker(this->_lock);
+
+		const auto itSource = this->_index.find(&node), itTarget = this->_index.find(link.get());
+
+		if(itSource == this->_index.cend() || itTarget == this->_index.cend())
+			return;
+
+		std::vector<std::pair<NodeId,std::uint32_t>> &row = this->_row[itSource->second];
+		std::vector<NodeId> &gatheredBy = this->_gatheredBy[itTarget->second];
+
+		const auto itLink = std::find_if(row.cbegin(), row.cend(), [&](const auto &entry) { return entry.first == itTarget->second; });
+
+		if(itLink == row.cend())
+			return; // Never mirrored: the edit was made while the initial ranks were computed
+
+		row.erase(itLink);
+		gatheredBy.erase(std::find(gatheredBy.cbegin(), gatheredBy.cend(), itSource->second));
+		this->markLinkChanged(itSource->second);
+	}
+
+	PersonalizedPageRank::PersonalizedPageRank(Graph graph) : _graph(std::move(graph))
+	{
+	}
+
+	std::vector<std::pair<NodeId,double>> PersonalizedPageRank::run(std::span<const NodeId> seeds, const PersonalizedPageRankOptions &options)
+	{
+		const Graph::Layout &layout = this->_graph.getLayout();
+		const double restart = 1.0 - options.dampeningFactor;
+
+		std::vector<std::pair<NodeId,double>> result;
+
+		if(seeds.empty())
+			throw std::runtime_error("Error: No seed nodes provided.");
+
+		this->_state.clear();
+		this->_queue.clear();
+		this->_pushCount = 0;
+
+		for(const NodeId seed : seeds)
+		{
+			if(seed >= this->_graph.getNodeCount())
+				throw std::out_of_range("Error: Invalid node ID.");
+
+			State &state = this->_state[seed];
+
+			state.residual += 1.0 / static_cast<double>(seeds.size());
+
+			if(!state.isQueued)
+			{
+				state.isQueued = true;
+				this->_queue.push_back(seed);
+			}
+		}
+
+		while(!this->_queue.empty())
+		{
+			const NodeId id = this->_queue.front();
+			State &state = this->_state[id]; // References to map elements survive the insertions made below
+			const double weightedDegree = static_cast<double>(layout.weightedDegree[id]);
+			const double residual = state.residual;
+
+			this->_queue.pop_front();
+			state.isQueued = false;
+			state.residual = 0.0;
+			++this->_pushCount;
+
+			if(layout.offset[id] == layout.offset[id + 1] || weightedDegree == 0.0)
+			{
+				state.score += residual; // Nowhere to walk to: the walk restarts, so the node keeps the probability
+				continue;
+			}
+
+			state.score += restart * residual;
+
+			const double share = options.dampeningFactor * residual / weightedDegree;
+
+			for(std::uint64_t e=layout.offset[id],endE=layout.offset[id + 1];e<endE;++e)
+			{
+				const NodeId neighbour = layout.target[e];
+				State &next = this->_state[neighbour];
+
+				next.residual += share * static_cast<double>(layout.weight[e]);
+
+				if(!next.isQueued && next.residual > options.tolerance * static_cast<double>(layout.weightedDegree[neighbour]))
+				{
+					next.isQueued = true;
+					this->_queue.push_back(neighbour);
+				}
+			}
+		}
+
+		result.reserve(this->_state.size());
+
+		for(std::unordered_map<NodeId,State>::const_iterator itS=this->_state.cbegin(),endS=this->_state.cend();itS!=endS;++itS)
+		{
+			if(itS->second.score > 0.0)
+				result.emplace_back(itS->first, itS->second.score);
+		}
+
+		// Only order the nodes that are returned
+		const auto comparator = [](const std::pair<NodeId,double> &a, const std::pair<NodeId,double> &b) { return a.second > b.second || (a.second == b.second && a.first < b.first); };
+		const std::size_t resultSize = options.topK ? std::min(options.topK, result.size()) : result.size();
+
+		std::partial_sort(result.begin(), result.begin() + resultSize, result.end(), comparator);
+		result.resize(resultSize);
+
+		return result;
+	}
+
+	std::size_t PersonalizedPageRank::getPushCount(void) const noexcept
+	{
+		return this->_pushCount;
+	}
+}
@@ -0,0 +1,200 @@
+/*****************************************************************//**
+ * @file   rankKernels.cpp
+ * @brief  The rank kernel implementations and runtime dispatch - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/rankKernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define I2_KERNELS_X86
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define I2_TARGET(isa) // MSVC allows any intrinsic in any function
+	#else
+		#define I2_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#endif
+
+namespace I2
+{
+	namespace Kernels
+	{
+		namespace
+		{
+			Residual dampenScalar(const double *rank, double *nextRank, double *nextContribution, const double *normaliser, std::size_t count, double teleport, double dampeningFactor, double maxRankValue) noexcept
+			{
+				Residual residual;
+
+				for(std::size_t i=0;i<count;++i)
+				{
+					const double difference = std::fabs(rank[i] - (nextRank[i] = std::min(teleport + dampeningFactor * nextRank[i], maxRankValue)));
+
+					nextContribution[i] = nextRank[i] * normaliser[i];
+					residual.l1 += difference;
+					residual.lInf = std::max(residual.lInf, difference);
+				}
+
+				return residual;
+			}
+
+#ifdef I2_KERNELS_X86
+			I2_TARGET("avx2")
+			Residual dampenAVX2(const double *rank, double *nextRank, double *nextContribution, const double *normaliser, std::size_t count, double teleport, double dampeningFactor, double maxRankValue) noexcept
+			{
+				const __m256d teleportV = _mm256_set1_pd(teleport), dampeningV = _mm256_set1_pd(dampeningFactor), maxV = _mm256_set1_pd(maxRankValue);
+				const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+
+				__m256d l1V = _mm256_setzero_pd(), lInfV = _mm256_setzero_pd();
+				alignas(32) double l1Lane[4], lInfLane[4];
+				std::size_t i = 0;
+				Residual residual;
+
+				for(;i+4<=count;i+=4)
+				{
+					// Separate multiply and add (rather than FMA) so the ranks round exactly as the scalar kernel's do
+					const __m256d next = _mm256_min_pd(_mm256_add_pd(teleportV, _mm256_mul_pd(dampeningV, _mm256_loadu_pd(nextRank + i))), maxV);
+					const __m256d difference = _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(rank + i), next), absMask);
+
+					_mm256_storeu_pd(nextRank + i, next);
+					_mm256_storeu_pd(nextContribution + i, _mm256_mul_pd(next, _mm256_loadu_pd(normaliser + i)));
+					l1V = _mm256_add_pd(l1V, difference);
+					lInfV = _mm256_max_pd(lInfV, difference);
+				}
+
+				_mm256_store_pd(l1Lane, l1V);
+				_mm256_store_pd(lInfLane, lInfV);
+				residual = dampenScalar(rank + i, nextRank + i, nextContribution + i, normaliser + i, count - i, teleport, dampeningFactor, maxRankValue); // Remainder
+				residual.l1 += (l1Lane[0] + l1Lane[1]) + (l1Lane[2] + l1Lane[3]);
+				residual.lInf = std::max({residual.lInf, lInfLane[0], lInfLane[1], lInfLane[2], lInfLane[3]});
+
+				return residual;
+			}
+
+			I2_TARGET("avx512f")
+			Residual dampenAVX512(const double *rank, double *nextRank, double *nextContribution, const double *normaliser, std::size_t count, double teleport, double dampeningFactor, double maxRankValue) noexcept
+			{
+				const __m512d teleportV = _mm512_set1_pd(teleport), dampeningV = _mm512_set1_pd(dampeningFactor), maxV = _mm512_set1_pd(maxRankValue);
+				const __m512i absMask = _mm512_set1_epi64(0x7FFFFFFFFFFFFFFF); // Clears the sign bit: an integer and, as the double forms need AVX-512DQ
+
+				__m512d l1V = _mm512_setzero_pd(), lInfV = _mm512_setzero_pd();
+				alignas(64) double l1Lane[8], lInfLane[8];
+				std::size_t i = 0;
+				Residual residual;
+
+				// GCC 12 fills the unused source operand of the unmasked min, max and extract forms with an "undefined" vector that -Wall reports as
+				// uninitialised, so min and max pass an explicit source with every lane selected, and the lanes are reduced from memory
+				for(;i+8<=count;i+=8)
+				{
+					// Separate multiply and add (rather than FMA) so the ranks round exactly as the scalar kernel's do
+					const __m512d sum = _mm512_add_pd(teleportV, _mm512_mul_pd(dampeningV, _mm512_loadu_pd(nextRank + i)));
+					const __m512d next = _mm512_mask_min_pd(sum, 0xFF, sum, maxV);
+					const __m512d difference = _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(_mm512_sub_pd(_mm512_loadu_pd(rank + i), next)), absMask));
+
+					_mm512_storeu_pd(nextRank + i, next);
+					_mm512_storeu_pd(nextContribution + i, _mm512_mul_pd(next, _mm512_loadu_pd(normaliser + i)));
+					l1V = _mm512_add_pd(l1V, difference);
+					lInfV = _mm512_mask_max_pd(lInfV, 0xFF, lInfV, difference);
+				}
+
+				_mm512_store_pd(l1Lane, l1V);
+				_mm512_store_pd(lInfLane, lInfV);
+				residual = dampenScalar(rank + i, nextRank + i, nextContribution + i, normaliser + i, count - i, teleport, dampeningFactor, maxRankValue); // Remainder
+				residual.l1 += ((l1Lane[0] + l1Lane[4]) + (l1Lane[1] + l1Lane[5])) + ((l1Lane[2] + l1Lane[6]) + (l1Lane[3] + l1Lane[7])); // Adds the two halves first, then their lanes as the AVX2 kernel does
+				residual.lInf = std::max({residual.lInf, lInfLane[0], lInfLane[1], lInfLane[2], lInfLane[3], lInfLane[4], lInfLane[5], lInfLane[6], lInfLane[7]});
+
+				return residual;
+			}
+
+			/**
+			 * @return The best instruction set the CPU and operating system both support
+			 */
+			InstructionSet detectInstructionSet(void) noexcept
+			{
+#ifdef _MSC_VER
+				int info[4];
+				const auto osSaves = [](unsigned long long mask) { return (_xgetbv(0) & mask) == mask; }; // The OS must preserve the wider registers
+
+				__cpuid(info, 1);
+
+				if(!(info[2] & (1 << 27)) || !osSaves(0x6)) // OSXSAVE, and XMM/YMM state
+					return InstructionSet::Scalar;
+
+				__cpuidex(info, 7, 0);
+
+				if((info[1] & (1 << 16)) && osSaves(0xE6)) // AVX-512F, and opmask/ZMM state
+					return InstructionSet::AVX512;
+
+				return (info[1] & (1 << 5)) ? InstructionSet::AVX2 : InstructionSet::Scalar;
+#else
+				__builtin_cpu_init();
+
+				if(__builtin_cpu_supports("avx512f"))
+					return InstructionSet::AVX512;
+
+				return __builtin_cpu_supports("avx2") ? InstructionSet::AVX2 : InstructionSet::Scalar;
+#endif
+			}
+#else
+			InstructionSet detectInstructionSet(void) noexcept
+			{
+				return InstructionSet::Scalar;
+			}
+#endif
+
+			std::atomic<InstructionSet> &dispatchedInstructionSet(void) noexcept
+			{
+				static std::atomic<InstructionSet> instructionSet(getSupportedInstructionSet());
+				return instructionSet;
+			}
+		}
+
+		InstructionSet getSupportedInstructionSet(void) noexcept
+		{
+			static const InstructionSet supported = detectInstructionSet();
+			return supported;
+		}
+
+		InstructionSet getInstructionSet(void) noexcept
+		{
+			return dispatchedInstructionSet().load(std::memory_order_relaxed);
+		}
+
+		InstructionSet setInstructionSet(InstructionSet instructionSet) noexcept
+		{
+			instructionSet = std::min(instructionSet, getSupportedInstructionSet()); // Enumerators are ordered by capability
+			dispatchedInstructionSet().store(instructionSet, std::memory_order_relaxed);
+
+			return instructionSet;
+		}
+
+		std::string_view getInstructionSetName(InstructionSet instructionSet) noexcept
+		{
+			switch(instructionSet)
+			{
+				case InstructionSet::AVX512: return "avx512";
+				case InstructionSet::AVX2: return "avx2";
+				default: return "scalar";
+			}
+		}
+
+		Residual dampen(const double *rank, double *nextRank, double *nextContribution, const double *normaliser, std::size_t count, double teleport, double dampeningFactor, double maxRankValue) noexcept
+		{
+			switch(getInstructionSet())
+			{
+#ifdef I2_KERNELS_X86
+				case InstructionSet::AVX512: return dampenAVX512(rank, nextRank, nextContribution, normaliser, count, teleport, dampeningFactor, maxRankValue);
+				case InstructionSet::AVX2: return dampenAVX2(rank, nextRank, nextContribution, normaliser, count, teleport, dampeningFactor, maxRankValue);
+#endif
+				default: return dampenScalar(rank, nextRank, nextContribution, normaliser, count, teleport, dampeningFactor, maxRankValue);
+			}
+		}
+	}
+}
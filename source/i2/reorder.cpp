@@ -0,0 +1,297 @@
+/*****************************************************************//**
+ * @file   reorder.cpp
+ * @brief  The node reordering function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/reorder.hpp"
+#include "i2/threadPool.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace I2
+{
+	namespace Reorder
+	{
+		namespace
+		{
+			constexpr std::size_t applyChunkSize = std::size_t(1) << 14; // Rows relabelled per task
+
+			/**
+			 * @return Every node, most linked first: ties keep their ID order
+			 */
+			std::vector<NodeId> orderByDegree(const Graph &graph)
+			{
+				std::vector<NodeId> order(graph.getNodeCount());
+
+				std::iota(order.begin(), order.end(), 0);
+				std::stable_sort(order.begin(), order.end(), [&graph](NodeId left, NodeId right) { return graph.getLinkCount(left) > graph.getLinkCount(right); });
+
+				return order;
+			}
+
+			std::vector<NodeId> orderByReverseCuthillMcKee(const Graph &graph)
+			{
+				const Graph::Layout &layout = graph.getLayout();
+				const std::size_t nodeCount = graph.getNodeCount();
+
+				std::vector<NodeId> order, start = orderByDegree(graph), neighbour;
+				std::vector<bool> visited(nodeCount, false);
+
+				const auto byDegree = [&graph](NodeId left, NodeId right)
+				{
+					const unsigned int leftCount = graph.getLinkCount(left), rightCount = graph.getLinkCount(right);
+
+					return leftCount < rightCount || (leftCount == rightCount && left < right);
+				};
+
+				order.reserve(nodeCount);
+				std::reverse(start.begin(), start.end()); // Each component is started from its least linked node: a cheap stand-in for a peripheral node
+
+				for(const NodeId root : start)
+				{
+					if(visited[root])
+						continue;
+
+					visited[root] = true;
+					order.push_back(root);
+
+					for(std::size_t head=order.size() - 1;head<order.size();++head)
+					{
+						const NodeId id = order[head];
+
+						neighbour.clear();
+
+						for(std::uint64_t e=layout.offset[id],endE=layout.offset[id + 1];e<endE;++e)
+						{
+							if(!visited[layout.target[e]])
+							{
+								visited[layout.target[e]] = true;
+								neighbour.push_back(layout.target[e]);
+							}
+						}
+
+						std::sort(neighbour.begin(), neighbour.end(), byDegree);
+						order.insert(order.end(), neighbour.cbegin(), neighbour.cend());
+					}
+				}
+
+				std::reverse(order.begin(), order.end());
+
+				return order;
+			}
+
+			/**
+			 * @brief A single pass of Rabbit Order's incremental aggregation: without merging the adjacency of each community, so linear in the
+			 * size of the graph.
+			 */
+			std::vector<NodeId> orderByCommunity(const Graph &graph)
+			{
+				constexpr NodeId none = ~NodeId(0);
+
+				const Graph::Layout &layout = graph.getLayout();
+				const std::size_t nodeCount = graph.getNodeCount();
+
+				std::vector<NodeId> parent(nodeCount), firstChild(nodeCount, none), nextSibling(nodeCount, none), touched, order, stack;
+				std::vector<double> degree(nodeCount), linkWeight(nodeCount, 0.0); // linkWeight: the weight from the node being merged to each community
+				double totalWeight = 0.0;
+
+				const auto findCommunity = [&parent](NodeId id)
+				{
+					for(;parent[id]!=id;id=parent[id])
+						parent[id] = parent[parent[id]]; // Path halving
+
+					return id;
+				};
+
+				std::iota(parent.begin(), parent.end(), 0);
+
+				for(std::size_t i=0;i<nodeCount;++i)
+				{
+					for(std::uint64_t e=layout.offset[i],endE=layout.offset[i + 1];e<endE;++e)
+						degree[i] += static_cast<double>(layout.weight[e]); // Not the weighted degree, which wraps
+
+					totalWeight += degree[i];
+				}
+
+				// Merge the least linked nodes first, as their community is the clearest, into the neighbouring community that gains the most modularity
+				std::vector<NodeId> mergeOrder = orderByDegree(graph);
+
+				std::reverse(mergeOrder.begin(), mergeOrder.end());
+
+				for(const NodeId id : mergeOrder)
+				{
+					NodeId best = none;
+					double bestGain = 0.0;
+
+					touched.clear();
+
+					for(std::uint64_t e=layout.offset[id],endE=layout.offset[id + 1];e<endE;++e)
+					{
+						const NodeId community = findCommunity(layout.target[e]);
+
+						if(community == id)
+							continue;
+
+						if(linkWeight[community] == 0.0)
+							touched.push_back(community);
+
+						linkWeight[community] += static_cast<double>(layout.weight[e]);
+					}
+
+					for(const NodeId community : touched)
+					{
+						const double gain = linkWeight[community] - degree[id] * degree[community] / totalWeight; // Proportional to the change in modularity
+
+						if(gain > bestGain || (gain == bestGain && best != none && community < best))
+						{
+							best = community;
+							bestGain = gain;
+						}
+
+						linkWeight[community] = 0.0;
+					}
+
+					if(best != none)
+					{
+						parent[id] = best;
+						degree[best] += degree[id];
+						nextSibling[id] = firstChild[best];
+						firstChild[best] = id;
+					}
+				}
+
+				// Number each community depth first through the merges, so every community (and the communities merged into it) is contiguous
+				order.reserve(nodeCount);
+
+				for(NodeId root=0;root<nodeCount;++root)
+				{
+					if(parent[root] != root)
+						continue;
+
+					stack.push_back(root);
+
+					while(!stack.empty())
+					{
+						const NodeId id = stack.back();
+
+						stack.pop_back();
+						order.push_back(id);
+
+						for(NodeId child=firstChild[id];child!=none;child=nextSibling[child])
+							stack.push_back(child);
+					}
+				}
+
+				return order;
+			}
+		}
+
+		Permutation::Permutation(void)
+		{
+		}
+
+		Permutation::Permutation(std::vector<NodeId> originalId) : _originalId(std::move(originalId)), _reorderedId(this->_originalId.size(), ~NodeId(0))
+		{
+			for(std::size_t i=0;i<this->_originalId.size();++i)
+			{
+				if(this->_originalId[i] >= this->_originalId.size() || this->_reorderedId[this->_originalId[i]] != ~NodeId(0))
+					throw std::runtime_error("Error: Invalid node permutation.");
+
+				this->_reorderedId[this->_originalId[i]] = static_cast<NodeId>(i);
+			}
+		}
+
+		bool Permutation::isIdentity(void) const noexcept
+		{
+			return this->_originalId.empty();
+		}
+
+		std::size_t Permutation::size(void) const noexcept
+		{
+			return this->_originalId.size();
+		}
+
+		NodeId Permutation::toOriginal(NodeId id) const noexcept
+		{
+			return this->isIdentity() ? id : this->_originalId[id];
+		}
+
+		NodeId Permutation::toReordered(NodeId id) const noexcept
+		{
+			return this->isIdentity() ? id : this->_reorderedId[id];
+		}
+
+		Permutation computeOrdering(const Graph &graph, Ordering ordering)
+		{
+			switch(ordering)
+			{
+			case Ordering::Degree:
+				return Permutation(orderByDegree(graph));
+
+			case Ordering::ReverseCuthillMcKee:
+				return Permutation(orderByReverseCuthillMcKee(graph));
+
+			default:
+				return Permutation(orderByCommunity(graph));
+			}
+		}
+
+		Graph apply(const Graph &graph, const Permutation &permutation, std::size_t threadCount)
+		{
+			if(permutation.isIdentity())
+				return graph;
+
+			const Graph::Layout &layout = graph.getLayout();
+			const std::size_t nodeCount = graph.getNodeCount(), chunkCount = (nodeCount + applyChunkSize - 1) / applyChunkSize;
+
+			if(permutation.size() != nodeCount)
+				throw std::runtime_error("Error: The node permutation does not match the graph.");
+
+			NamePool name;
+			std::vector<std::uint64_t> offset(nodeCount + 1, 0);
+			std::vector<NodeId> target(graph.getEntryCount());
+			std::vector<std::uint32_t> weight(graph.getEntryCount());
+			WorkStealingPool pool(threadCount);
+
+			name.reserve(nodeCount, layout.nameData.size());
+
+			for(std::size_t i=0;i<nodeCount;++i)
+			{
+				const NodeId id = permutation.toOriginal(static_cast<NodeId>(i));
+
+				name.add(graph.getName(id));
+				offset[i + 1] = offset[i] + graph.getLinkCount(id);
+			}
+
+			pool.parallelFor(chunkCount, [&](std::size_t chunk)
+			{
+				std::vector<std::pair<NodeId,std::uint32_t>> row;
+
+				for(std::size_t i=chunk * applyChunkSize,endI=std::min(nodeCount, (chunk + 1) * applyChunkSize);i<endI;++i)
+				{
+					const NodeId id = permutation.toOriginal(static_cast<NodeId>(i));
+
+					row.clear();
+
+					for(std::uint64_t e=layout.offset[id],endE=layout.offset[id + 1];e<endE;++e)
+						row.emplace_back(permutation.toReordered(layout.target[e]), layout.weight[e]);
+
+					std::stable_sort(row.begin(), row.end(), [](const std::pair<NodeId,std::uint32_t> &left, const std::pair<NodeId,std::uint32_t> &right) { return left.first < right.first; });
+
+					for(std::size_t k=0;k<row.size();++k)
+					{
+						target[offset[i] + k] = row[k].first;
+						weight[offset[i] + k] = row[k].second;
+					}
+				}
+			});
+
+			return Graph(std::move(name), std::move(offset), std::move(target), std::move(weight));
+		}
+	}
+}
@@ -0,0 +1,234 @@
+/*****************************************************************//**
+ * @file   resultWriter.cpp
+ * @brief  The ResultWriter function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/resultWriter.hpp"
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+
+namespace I2
+{
+	namespace
+	{
+		/**
+		 * @brief Appends a number without allocating a temporary string: fixed with the given decimals, or the shortest round-trip digits when decimals is negative.
+		 */
+		void appendNumber(std::string &text, double value, int decimals)
+		{
+			char buffer[512]; // Holds any finite double in fixed notation
+			const std::to_chars_result result = decimals < 0 ? std::to_chars(buffer, buffer + sizeof(buffer), value) : std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, decimals);
+
+			text.append(buffer, result.ptr);
+		}
+
+		void appendNumber(std::string &text, std::uint64_t value)
+		{
+			char buffer[24];
+			const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+			(void)error; // 24 characters always hold a 64-bit value
+			text.append(buffer, end);
+		}
+
+		/**
+		 * @brief Appends a name as a CSV field, quoted (with quotes doubled) only when it needs to be.
+		 */
+		void appendCSVField(std::string &text, std::string_view field)
+		{
+			if(field.find_first_of(",\"\r\n") == std::string_view::npos)
+			{
+				text.append(field);
+				return;
+			}
+
+			text.push_back('"');
+
+			for(const char c : field)
+			{
+				if(c == '"')
+					text.push_back('"');
+
+				text.push_back(c);
+			}
+
+			text.push_back('"');
+		}
+
+		/**
+		 * @brief Appends a string as a quoted JSON string.
+		 */
+		void appendJSONString(std::string &text, std::string_view value)
+		{
+			constexpr char hexDigit[] = "0123456789abcdef";
+
+			text.push_back('"');
+
+			for(const char c : value)
+			{
+				switch(c)
+				{
+				case '"':
+					text.append("\\\"");
+					break;
+
+				case '\\':
+					text.append("\\\\");
+					break;
+
+				case '\n':
+					text.append("\\n");
+					break;
+
+				case '\r':
+					text.append("\\r");
+					break;
+
+				case '\t':
+					text.append("\\t");
+					break;
+
+				default:
+					if(static_cast<unsigned char>(c) < 0x20)
+					{ // Other control characters have no short escape
+						text.append("\\u00");
+						text.push_back(hexDigit[static_cast<unsigned char>(c) >> 4]);
+						text.push_back(hexDigit[static_cast<unsigned char>(c) & 0xF]);
+					}
+					else
+						text.push_back(c); // UTF-8 passes through unchanged
+					break;
+				}
+			}
+
+			text.push_back('"');
+		}
+
+		template<typename T>
+		void appendBytes(std::string &text, const T &value)
+		{
+			text.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+	}
+
+	ResultWriter::ResultWriter(std::ostream &output, OutputFormat format, std::size_t bufferSize) : _output(&output), _format(format), _capacity(bufferSize)
+	{
+		this->_buffer.reserve(bufferSize + 1024); // Room for the row that fills the buffer, so most rows never reallocate
+	}
+
+	ResultWriter::ResultWriter(const std::string &path, OutputFormat format, std::size_t bufferSize) : _file(path, std::ofstream::binary | std::ofstream::trunc), _output(&this->_file), _format(format), _capacity(bufferSize)
+	{
+		if(!this->_file.is_open())
+			throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+
+		this->_buffer.reserve(bufferSize + 1024);
+	}
+
+	ResultWriter::~ResultWriter(void)
+	{
+		try
+		{
+			this->flush();
+		}
+		catch(...)
+		{ // Destructors must not throw: callers that need to know call flush themselves
+		}
+	}
+
+	void ResultWriter::flushIfFull(void)
+	{
+		if(this->_buffer.size() < this->_capacity)
+			return;
+
+		this->_output->write(this->_buffer.data(), static_cast<std::streamsize>(this->_buffer.size())); // One large write, rather than one per row
+		this->_buffer.clear();
+	}
+
+	void ResultWriter::beginSection(std::string_view name, std::size_t rowCount, int decimals)
+	{
+		this->_section.assign(name);
+		this->_decimals = decimals;
+
+		switch(this->_format)
+		{
+		case OutputFormat::Text:
+			if(this->_sectionCount)
+				this->_buffer.push_back('\n'); // Separate this output from the previous section
+			break;
+
+		case OutputFormat::CSV:
+			if(!this->_sectionCount)
+				this->_buffer.append("section,id,node,value\n");
+			break;
+
+		case OutputFormat::JSONLines:
+			break;
+
+		case OutputFormat::Binary:
+			appendBytes(this->_buffer, static_cast<std::uint64_t>(rowCount));
+			break;
+		}
+
+		++this->_sectionCount;
+		this->flushIfFull();
+	}
+
+	void ResultWriter::writeRow(std::string_view name, NodeId id, double value)
+	{
+		switch(this->_format)
+		{
+		case OutputFormat::Text:
+			this->_buffer.append(name);
+			this->_buffer.append(": ");
+			appendNumber(this->_buffer, value, this->_decimals);
+			this->_buffer.push_back('\n');
+			break;
+
+		case OutputFormat::CSV:
+			appendCSVField(this->_buffer, this->_section);
+			this->_buffer.push_back(',');
+			appendNumber(this->_buffer, static_cast<std::uint64_t>(id));
+			this->_buffer.push_back(',');
+			appendCSVField(this->_buffer, name);
+			this->_buffer.push_back(',');
+			appendNumber(this->_buffer, value, -1);
+			this->_buffer.push_back('\n');
+			break;
+
+		case OutputFormat::JSONLines:
+			this->_buffer.append("{\"section\":");
+			appendJSONString(this->_buffer, this->_section);
+			this->_buffer.append(",\"id\":");
+			appendNumber(this->_buffer, static_cast<std::uint64_t>(id));
+			this->_buffer.append(",\"node\":");
+			appendJSONString(this->_buffer, name);
+			this->_buffer.append(",\"value\":");
+			appendNumber(this->_buffer, value, -1);
+			this->_buffer.append("}\n");
+			break;
+
+		case OutputFormat::Binary:
+			appendBytes(this->_buffer, static_cast<std::uint32_t>(id));
+			appendBytes(this->_buffer, value);
+			break;
+		}
+
+		this->flushIfFull();
+	}
+
+	void ResultWriter::flush(void)
+	{
+		if(!this->_buffer.empty())
+		{
+			this->_output->write(this->_buffer.data(), static_cast<std::streamsize>(this->_buffer.size()));
+			this->_buffer.clear();
+		}
+
+		if(!this->_output->flush())
+			throw std::runtime_error("Error: writing results failed.");
+	}
+}
@@ -0,0 +1,556 @@
+/*****************************************************************//**
+ * @file   service.cpp
+ * @brief  The Service function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/service.hpp"
+#include "i2/nodeLoader.hpp"
+#include <json/json.h>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+	#include <poll.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
+namespace I2
+{
+	namespace
+	{
+		constexpr int pollInterval = 100; // Milliseconds between checks for a shutdown while waiting on a socket
+
+		/**
+		 * @brief Parses a request line, re-using a reader per thread.
+		 * @throw std::runtime_error if the line is not a JSON object with a string "op"
+		 */
+		Json::Value parseRequest(std::string_view line)
+		{
+			thread_local const std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+
+			Json::Value request;
+			std::string errors;
+
+			if(!reader->parse(line.data(), line.data() + line.size(), &request, &errors))
+				throw std::runtime_error("Error: Request is not valid JSON.");
+
+			if(!request.isObject() || !request["op"].isString())
+				throw std::runtime_error("Error: Request is not an object with a string 'op'.");
+
+			return request;
+		}
+
+		/**
+		 * @brief Writes a value as compact JSON, re-using a writer per thread.
+		 */
+		std::string serialise(const Json::Value &value)
+		{
+			thread_local const std::unique_ptr<Json::StreamWriter> writer([](void)
+			{
+				Json::StreamWriterBuilder writerBuilder;
+
+				writerBuilder["indentation"] = "";
+
+				return writerBuilder.newStreamWriter();
+			}());
+
+			std::ostringstream output;
+
+			writer->write(value, &output);
+
+			return output.str();
+		}
+
+		/**
+		 * @brief Starts a response, echoing the request's id when it has one.
+		 */
+		std::string beginResponse(const Json::Value &id)
+		{
+			return id.isNull() ? std::string("{") : "{\"id\":" + serialise(id) + ",";
+		}
+
+		std::string errorResponse(const Json::Value &id, const std::string &message)
+		{
+			return beginResponse(id) + "\"ok\":false,\"error\":" + serialise(Json::Value(message)) + "}";
+		}
+
+		/**
+		 * @return true for requests that change the graph (or the service), which are answered in order with the reads around them
+		 */
+		bool isWriteRequest(const Json::Value &request)
+		{
+			const std::string op = request["op"].asString();
+
+			return op == "addNode" || op == "addLink" || op == "removeLink" || op == "recompute" || op == "shutdown";
+		}
+
+		const Json::Value &requireMember(const Json::Value &request, const char *name, bool (Json::Value::*isType)(void) const, const char *typeName)
+		{
+			const Json::Value &member = request[name];
+
+			if(!(member.*isType)())
+				throw std::runtime_error(std::string("Error: Request is missing ") + typeName + " '" + name + "'.");
+
+			return member;
+		}
+
+		NodeId requireNode(const Graph &graph, const Json::Value &request, const char *name)
+		{
+			const std::string nodeName = requireMember(request, name, &Json::Value::isString, "string").asString();
+			const std::optional<NodeId> id = graph.findNode(nodeName);
+
+			if(!id)
+				throw std::runtime_error("Error: Unknown node '" + nodeName + "'.");
+
+			return *id;
+		}
+	}
+
+	/**
+	 * @class Service::Session
+	 * @brief One stream or connection: sends its responses one line at a time, and tracks its reads still in flight
+	 */
+	class Service::Session
+	{
+	private:
+		std::function<void(const std::string&)> _send;
+		std::mutex _lock;
+		std::condition_variable _idle;
+		std::size_t _inFlight = 0;
+
+	public:
+		explicit Session(std::function<void(const std::string&)> send) : _send(std::move(send))
+		{
+		}
+
+		void send(const std::string &response)
+		{
+			std::lock_guard<std::mutex> locker(this->_lock);
+
+			this->_send(response);
+		}
+
+		void beginRead(void)
+		{
+			std::lock_guard<std::mutex> locker(this->_lock);
+
+			++this->_inFlight;
+		}
+
+		void endRead(void)
+		{
+			std::lock_guard<std::mutex> locker(this->_lock);
+
+			if(!--this->_inFlight)
+				this->_idle.notify_all();
+		}
+
+		void waitIdle(void)
+		{
+			std::unique_lock<std::mutex> locker(this->_lock);
+
+			this->_idle.wait(locker, [&](void) { return !this->_inFlight; });
+		}
+	};
+
+	Service::Service(Graph graph, const ServiceOptions &options) : _graph(std::move(graph)), _options(options)
+	{
+	}
+
+	std::shared_ptr<const Service::Ranking> Service::rank(const std::shared_ptr<const VersionedGraph::Version> &version)
+	{
+		std::lock_guard<std::mutex> locker(this->_rankLock);
+
+		if(this->_ranking && this->_ranking->epoch == version->epoch)
+			return this->_ranking;
+
+		PageRankEngine engine(version->graph);
+		std::shared_ptr<const Ranking> result;
+
+		if(this->_ranking && this->_ranking->epoch < version->epoch)
+		{ // Nodes keep their IDs between versions, so the previous ranks are a close start: new nodes start from their mean
+			std::vector<double> initialRank(this->_ranking->rank);
+			double rankSum = 0.0;
+
+			for(const double rank : initialRank)
+				rankSum += rank;
+
+			initialRank.resize(version->graph.getNodeCount(), initialRank.empty() ? 1.0 / static_cast<double>(version->graph.getNodeCount()) : rankSum / static_cast<double>(initialRank.size()));
+			engine.run(this->_options.rank, initialRank);
+		}
+		else
+			engine.run(this->_options.rank);
+
+		result = std::make_shared<const Ranking>(Ranking{version->epoch, engine.getRanks(), engine.getIterationCount()});
+
+		if(!this->_ranking || this->_ranking->epoch < version->epoch) // A reader still pinning an older version is answered, but does not replace newer ranks
+			this->_ranking = result;
+
+		return result;
+	}
+
+	std::string Service::read(const Json::Value &request, std::uint64_t &epoch)
+	{
+		const std::shared_ptr<const VersionedGraph::Version> version = this->_graph.pin();
+		const Graph &graph = version->graph;
+		const std::string op = request["op"].asString();
+
+		Json::Value result;
+		std::string key = op, serialised;
+
+		epoch = version->epoch;
+
+		// Key the cache on the op and its arguments, validating them as they are read
+		if(op == "top")
+		{
+			const Json::Value &by = request.get("by", "degree"), &count = request.get("k", 10);
+
+			if(!by.isString() || (by.asString() != "degree" && by.asString() != "rank"))
+				throw std::runtime_error("Error: 'by' must be \"degree\" or \"rank\".");
+
+			if(!count.isUInt64())
+				throw std::runtime_error("Error: 'k' must be a non-negative integer.");
+
+			key += '\n' + by.asString() + '\n' + std::to_string(count.asUInt64());
+		}
+		else if(op == "degree" || op == "rank")
+			key += '\n' + requireMember(request, "node", &Json::Value::isString, "string").asString();
+		else
+			throw std::runtime_error("Error: Unknown op '" + op + "'.");
+
+		{
+			std::shared_lock<std::shared_mutex> locker(this->_cacheLock);
+
+			if(this->_cacheEpoch == epoch)
+			{
+				const auto itCache = this->_cache.find(key);
+
+				if(itCache != this->_cache.cend())
+					return itCache->second;
+			}
+		}
+
+		if(op == "top")
+		{
+			const std::size_t count = static_cast<std::size_t>(request.get("k", 10).asUInt64());
+
+			result = Json::Value(Json::arrayValue);
+
+			if(request.get("by", "degree").asString() == "degree")
+			{
+				for(const NodeId id : NodeLoader::topNodesByWeightedDegree(graph, count))
+				{
+					Json::Value &entry = result.append(Json::Value(Json::objectValue));
+
+					entry["node"] = std::string(graph.getName(id));
+					entry["degree"] = graph.getWeightedDegree(id);
+				}
+			}
+			else
+			{
+				const std::shared_ptr<const Ranking> ranking = this->rank(version);
+
+				for(const NodeId id : NodeLoader::topNodesByRank(ranking->rank, count))
+				{
+					Json::Value &entry = result.append(Json::Value(Json::objectValue));
+
+					entry["node"] = std::string(graph.getName(id));
+					entry["rank"] = ranking->rank[id];
+				}
+			}
+		}
+		else if(op == "degree")
+			result = graph.getWeightedDegree(requireNode(graph, request, "node"));
+		else
+			result = this->rank(version)->rank[requireNode(graph, request, "node")];
+
+		serialised = serialise(result);
+
+		{
+			std::unique_lock<std::shared_mutex> locker(this->_cacheLock);
+
+			if(this->_cacheEpoch < epoch)
+			{ // The graph has changed since the cached results were computed
+				this->_cache.clear();
+				this->_cacheEpoch = epoch;
+			}
+
+			if(this->_cacheEpoch == epoch)
+			{
+				if(this->_cache.size() >= this->_options.cacheCapacity)
+					this->_cache.clear();
+
+				this->_cache.emplace(std::move(key), serialised);
+			}
+		}
+
+		return serialised;
+	}
+
+	std::string Service::write(const Json::Value &request, std::uint64_t &epoch)
+	{
+		const std::string op = request["op"].asString();
+
+		if(op == "recompute")
+		{ // Ranked outside the write lock, so other writes are not held up while it runs
+			std::shared_ptr<const VersionedGraph::Version> version;
+
+			{
+				std::lock_guard<std::mutex> locker(this->_writeLock); // Every earlier write has published once the lock is taken
+
+				version = this->_graph.pin();
+			}
+
+			epoch = version->epoch;
+
+			return serialise(Json::Value(Json::UInt64(this->rank(version)->iterationCount)));
+		}
+
+		std::lock_guard<std::mutex> locker(this->_writeLock);
+
+		const std::shared_ptr<const VersionedGraph::Version> version = this->_graph.pin();
+		const Graph &graph = version->graph;
+
+		Json::Value result(true);
+
+		if(op == "addNode")
+		{
+			const std::string name = requireMember(request, "node", &Json::Value::isString, "string").asString();
+
+			if(graph.findNode(name))
+				throw std::runtime_error("Error: Node '" + name + "' already exists.");
+
+			this->_graph.addNode(name);
+		}
+		else if(op == "addLink")
+		{
+			const Json::Value &weight = request.get("weight", 1);
+
+			if(!weight.isUInt())
+				throw std::runtime_error("Error: 'weight' must be a non-negative integer.");
+
+			this->_graph.addLink(requireNode(graph, request, "source"), requireNode(graph, request, "target"), weight.asUInt());
+		}
+		else if(op == "removeLink")
+			this->_graph.removeLink(requireNode(graph, request, "source"), requireNode(graph, request, "target"));
+		else // shutdown
+			this->_stopping = true;
+
+		epoch = this->_graph.publish(); // Unchanged when nothing was staged
+
+		return serialise(result);
+	}
+
+	std::string Service::answer(const Json::Value &request)
+	{
+		const Json::Value &id = request["id"];
+
+		std::uint64_t epoch = 0;
+
+		try
+		{
+			const std::string result = isWriteRequest(request) ? this->write(request, epoch) : this->read(request, epoch);
+
+			return beginResponse(id) + "\"ok\":true,\"epoch\":" + std::to_string(epoch) + ",\"result\":" + result + "}";
+		}
+		catch(const std::exception &e)
+		{
+			return errorResponse(id, e.what());
+		}
+	}
+
+	void Service::receive(const std::shared_ptr<Session> &session, TaskPool &pool, std::string_view line)
+	{
+		Json::Value request;
+
+		if(line.find_first_not_of(" \t\r") == std::string_view::npos)
+			return; // Blank lines are ignored, so a client may keep a connection alive with them
+
+		try
+		{
+			request = parseRequest(line);
+		}
+		catch(const std::runtime_error &e)
+		{
+			session->send(errorResponse(Json::Value(), e.what()));
+			return;
+		}
+
+		if(isWriteRequest(request))
+		{ // Writes are answered in order: after the session's earlier reads, and before its later ones are read
+			session->waitIdle();
+			session->send(this->answer(request));
+			return;
+		}
+
+		session->beginRead();
+		pool.submit([this, session, request = std::move(request)](void)
+		{
+			session->send(this->answer(request));
+			session->endRead();
+		});
+	}
+
+	std::string Service::handle(std::string_view request)
+	{
+		try
+		{
+			return this->answer(parseRequest(request));
+		}
+		catch(const std::runtime_error &e)
+		{
+			return errorResponse(Json::Value(), e.what());
+		}
+	}
+
+	void Service::serve(std::istream &input, std::ostream &output)
+	{
+		const std::shared_ptr<Session> session = std::make_shared<Session>([&output](const std::string &response) { output << response << '\n' << std::flush; });
+
+		TaskPool pool(this->_options.threadCount);
+		std::string line;
+
+		this->_stopping = false;
+
+		while(!this->_stopping && std::getline(input, line))
+			this->receive(session, pool, line);
+
+		pool.wait();
+	}
+
+	void Service::serveSocket(const std::string &path)
+	{
+#ifdef _WIN32
+		(void)path;
+		throw std::runtime_error("Error: Unix domain sockets are not supported on this platform.");
+#else
+		sockaddr_un address{};
+		int listener = -1;
+
+		if(path.size() >= sizeof(address.sun_path))
+			throw std::runtime_error("Error: Socket path '" + path + "' is too long.");
+
+		address.sun_family = AF_UNIX;
+		path.copy(address.sun_path, path.size());
+		::unlink(path.c_str()); // Replace a socket left behind by a previous run
+
+		if((listener = ::socket(AF_UNIX, SOCK_STREAM, 0)) < 0 || ::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) || ::listen(listener, SOMAXCONN))
+		{
+			if(listener >= 0)
+				::close(listener);
+
+			throw std::runtime_error("Error: Listening on socket '" + path + "' failed.");
+		}
+
+		TaskPool pool(this->_options.threadCount);
+		std::vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> reader; // Each connection's thread, and whether it has finished
+
+		this->_stopping = false;
+
+		while(!this->_stopping)
+		{
+			pollfd waiting{listener, POLLIN, 0};
+
+			if(::poll(&waiting, 1, pollInterval) <= 0)
+				continue; // Timed out (or interrupted): check for a shutdown
+
+			const int connection = ::accept(listener, nullptr, nullptr);
+			const std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+
+			if(connection < 0)
+				continue;
+
+			// Join the threads of connections that have closed, so a long-running service does not accumulate them
+			for(std::size_t i=0;i<reader.size();)
+			{
+				if(*reader[i].second)
+				{
+					reader[i].first.join();
+					reader[i] = std::move(reader.back());
+					reader.pop_back();
+				}
+				else
+					++i;
+			}
+
+			// Each connection is read on its own thread, and its reads are answered on the shared pool
+			reader.emplace_back(std::thread([this, &pool, connection, finished](void)
+			{
+				const std::shared_ptr<Session> session = std::make_shared<Session>([connection](const std::string &response)
+				{
+					const std::string message = response + '\n';
+#ifdef MSG_NOSIGNAL
+					constexpr int flags = MSG_NOSIGNAL; // A client that has gone away must not take the service down with SIGPIPE
+#else
+					constexpr int flags = 0;
+#endif
+
+					for(std::size_t sent=0;sent<message.size();)
+					{
+						const ssize_t count = ::send(connection, message.data() + sent, message.size() - sent, flags);
+
+						if(count <= 0)
+							return;
+
+						sent += static_cast<std::size_t>(count);
+					}
+				});
+
+				std::string buffer;
+				char chunk[4096];
+
+				while(!this->_stopping)
+				{
+					pollfd waiting{connection, POLLIN, 0};
+
+					if(::poll(&waiting, 1, pollInterval) <= 0)
+						continue;
+
+					const ssize_t count = ::recv(connection, chunk, sizeof(chunk), 0);
+
+					if(count <= 0)
+						break; // The client closed the connection
+
+					buffer.append(chunk, static_cast<std::size_t>(count));
+
+					std::size_t begin = 0;
+
+					for(std::size_t end=buffer.find('\n');end!=std::string::npos && !this->_stopping;end=buffer.find('\n', begin))
+					{
+						this->receive(session, pool, std::string_view(buffer).substr(begin, end - begin));
+						begin = end + 1;
+					}
+
+					buffer.erase(0, begin);
+				}
+
+				session->waitIdle(); // Answer every read already received before closing
+				::close(connection);
+				*finished = true;
+			}), finished);
+		}
+
+		for(auto &entry : reader)
+			entry.first.join();
+
+		pool.wait();
+		::close(listener);
+		::unlink(path.c_str());
+#endif
+	}
+
+	std::uint64_t Service::getEpoch(void) const
+	{
+		return this->_graph.pin()->epoch;
+	}
+}
@@ -0,0 +1,446 @@
+/*****************************************************************//**
+ * @file   shardedGraph.cpp
+ * @brief  The ShardedGraph function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/shardedGraph.hpp"
+#include "i2/rankKernels.hpp"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace I2
+{
+	namespace
+	{
+		constexpr std::size_t minimumWorkingBytes = 1 << 16; // The least the budget must leave for blocks once the per-node arrays are set aside
+		constexpr std::size_t minimumShardBuffer = 256; // Entries buffered per shard file before they are appended to it
+		constexpr std::size_t noIndex = std::numeric_limits<std::size_t>::max();
+
+		/**
+		 * @brief An adjacency entry routed to a shard: a link is routed once to each of its nodes' rows.
+		 */
+		struct ShardEntry
+		{
+			NodeId row;
+			NodeId target;
+			std::uint32_t weight;
+			std::uint64_t link; // The index of the link within the edge list, so repeated links are resolved in file order
+		};
+
+		/**
+		 * @brief Creates a uniquely named subdirectory to hold the graph's files.
+		 */
+		std::filesystem::path createDirectory(const std::string &directory)
+		{
+			const std::filesystem::path base = directory.length() ? std::filesystem::path(directory) : std::filesystem::temp_directory_path();
+
+			std::random_device seed;
+
+			std::filesystem::create_directories(base);
+
+			for(std::size_t attempt=0;attempt<100;++attempt)
+			{
+				const std::filesystem::path path = base / ("i2Shards-" + std::to_string(seed()));
+
+				if(std::filesystem::create_directory(path))
+					return path;
+			}
+
+			throw std::runtime_error("Error: Unable to create a shard directory within '" + base.string() + "'.");
+		}
+
+		template<typename T>
+		void writeArray(std::ostream &output, const std::vector<T> &array)
+		{
+			output.write(reinterpret_cast<const char*>(array.data()), static_cast<std::streamsize>(array.size() * sizeof(T)));
+		}
+
+		template<typename T>
+		void readArray(std::istream &input, std::vector<T> &array, std::size_t count)
+		{
+			array.resize(count);
+			input.read(reinterpret_cast<char*>(array.data()), static_cast<std::streamsize>(count * sizeof(T)));
+		}
+
+		/**
+		 * @brief Appends the buffered entries to a shard file and empties the buffer.
+		 */
+		void appendToShard(const std::filesystem::path &path, std::vector<ShardEntry> &buffer)
+		{
+			std::ofstream output(path, std::ios::binary | std::ios::app);
+
+			writeArray(output, buffer);
+
+			if(!output)
+				throw std::runtime_error("Error: Failed to write the shard '" + path.string() + "'.");
+
+			buffer.clear();
+		}
+	}
+
+	ShardedGraph ShardedGraph::fromEdgeList(const std::string &path, const EdgeList::Options &options, const ShardOptions &shardOptions)
+	{
+		ShardedGraph graph; // Owns the directory from here on, so it is removed if sharding fails
+		std::vector<std::uint64_t> rowCount; // The entries routed to each row, before repeated links are merged
+		std::vector<NodeId> shardBegin(1, 0); // The first node of each shard, then the node count
+		std::vector<std::uint64_t> shardEntryCount;
+		std::size_t nodeCount = 0;
+
+		const bool hasNames = options.namesPath.length() > 0;
+
+		graph._namesPath = options.namesPath;
+		graph._memoryBudget = shardOptions.memoryBudget;
+
+		if(hasNames)
+		{ // The sidecar fixes the node count up front, so links can be validated as they are read
+			std::ifstream input(options.namesPath, std::ios::binary);
+			std::string name;
+
+			if(!input)
+				throw std::runtime_error("Error: opening file with path '" + options.namesPath + "' failed.");
+
+			while(std::getline(input, name))
+			{
+				if(name.empty() || name == "\r")
+					throw std::runtime_error("Node invalid: no name provided!"); // As GraphBuilder::addNode
+
+				++nodeCount;
+			}
+
+			rowCount.assign(nodeCount, 0);
+		}
+
+		// Pass 1: validate every link, and count the entries of each row
+		EdgeList::scan(path, options, [&](std::span<const EdgeList::Record> link, std::size_t first)
+		{
+			for(std::size_t i=0,linkCount=link.size();i<linkCount;++i)
+			{
+				const EdgeList::Record &l = link[i];
+
+				if((hasNames && (l.source >= nodeCount || l.target >= nodeCount)) || (!options.nodesCanLinkToSelf && l.source == l.target))
+					throw std::runtime_error(GraphBuilder::invalidLinkError(first + i));
+
+				if(!hasNames && std::max(l.source, l.target) >= rowCount.size())
+					rowCount.resize(std::size_t(std::max(l.source, l.target)) + 1);
+
+				++rowCount[l.source];
+
+				if(l.source != l.target)
+					++rowCount[l.target]; // A link to self is only stored once, as GraphBuilder does
+			}
+		});
+
+		nodeCount = rowCount.size();
+
+		const std::size_t residentBytes = nodeCount * getResidentBytesPerNode();
+
+		if(shardOptions.memoryBudget < residentBytes + minimumWorkingBytes)
+		{
+			throw std::runtime_error("Error: A memory budget of " + std::to_string(shardOptions.memoryBudget) + " bytes cannot rank " + std::to_string(nodeCount)
+				+ " nodes: at least " + std::to_string(residentBytes + minimumWorkingBytes) + " bytes are needed.");
+		}
+
+		// Half of what remains holds a shard while it is merged, and a quarter each of the two blocks held while ranking (or building)
+		const std::size_t workingBytes = shardOptions.memoryBudget - residentBytes, shardBytes = workingBytes / 2, blockBytes = workingBytes / 4;
+
+		for(std::size_t i=0,bytes=0,entries=0;i<nodeCount;++i)
+		{
+			const std::size_t rowBytes = rowCount[i] * sizeof(ShardEntry) + sizeof(std::uint64_t);
+
+			if(rowBytes > shardBytes)
+				throw std::runtime_error("Error: Node '" + std::to_string(i) + "' has too many links for a memory budget of " + std::to_string(shardOptions.memoryBudget) + " bytes.");
+
+			if(bytes + rowBytes > shardBytes)
+			{
+				shardBegin.push_back(static_cast<NodeId>(i));
+				shardEntryCount.push_back(entries);
+				bytes = entries = 0;
+			}
+
+			bytes += rowBytes;
+			entries += rowCount[i];
+
+			if(i + 1 == nodeCount)
+			{
+				shardBegin.push_back(static_cast<NodeId>(nodeCount));
+				shardEntryCount.push_back(entries);
+			}
+		}
+
+		std::vector<std::uint64_t>().swap(rowCount);
+
+		graph._directory = createDirectory(shardOptions.directory);
+
+		const std::size_t shardCount = shardEntryCount.size(), bufferEntries = std::max(minimumShardBuffer, shardBytes / sizeof(ShardEntry) / std::max<std::size_t>(shardCount, 1));
+		const auto shardPath = [&graph](std::size_t shard) { return graph._directory / ("shard" + std::to_string(shard) + ".bin"); };
+
+		std::vector<std::vector<ShardEntry>> buffer(shardCount);
+
+		const auto route = [&](const ShardEntry &entry)
+		{
+			const std::size_t shard = static_cast<std::size_t>(std::upper_bound(shardBegin.cbegin() + 1, shardBegin.cend(), entry.row) - (shardBegin.cbegin() + 1));
+
+			buffer[shard].push_back(entry);
+
+			if(buffer[shard].size() >= bufferEntries)
+				appendToShard(shardPath(shard), buffer[shard]);
+		};
+
+		// Pass 2: route each entry to the shard holding its row
+		EdgeList::scan(path, options, [&](std::span<const EdgeList::Record> link, std::size_t first)
+		{
+			for(std::size_t i=0,linkCount=link.size();i<linkCount;++i)
+			{
+				const EdgeList::Record &l = link[i];
+
+				route(ShardEntry{l.source, l.target, l.weight, first + i});
+
+				if(l.source != l.target)
+					route(ShardEntry{l.target, l.source, l.weight, first + i});
+			}
+		});
+
+		for(std::size_t shard=0;shard<shardCount;++shard)
+		{
+			if(buffer[shard].size())
+				appendToShard(shardPath(shard), buffer[shard]);
+		}
+
+		std::vector<std::vector<ShardEntry>>().swap(buffer);
+
+		std::vector<ShardEntry> entry;
+		Block block;
+		std::size_t duplicate = noIndex;
+		std::uint64_t chunkEntries = 0;
+
+		graph._weightedDegree.assign(nodeCount, 0);
+		block.offset.assign(1, 0);
+
+		const auto closeBlock = [&](NodeId end)
+		{
+			const std::filesystem::path blockPath = graph._directory / ("block" + std::to_string(graph._block.size()) + ".bin");
+
+			std::ofstream output(blockPath, std::ios::binary);
+
+			writeArray(output, block.offset);
+			writeArray(output, block.target);
+			writeArray(output, block.weight);
+
+			if(!output)
+				throw std::runtime_error("Error: Failed to write the block '" + blockPath.string() + "'.");
+
+			graph._block.push_back(BlockFile{block.begin, end, block.target.size(), blockPath});
+			graph._entryCount += block.target.size();
+
+			block.begin = end;
+			block.offset.assign(1, 0);
+			block.target.clear();
+			block.weight.clear();
+		};
+
+		// Pass 3: sort and merge each shard's rows as GraphBuilder::build does, and lay them out as blocks
+		for(std::size_t shard=0;shard<shardCount;++shard)
+		{
+			{
+				std::ifstream input(shardPath(shard), std::ios::binary);
+
+				readArray(input, entry, shardEntryCount[shard]);
+
+				if(entry.size() && !input)
+					throw std::runtime_error("Error: Failed to read the shard '" + shardPath(shard).string() + "'.");
+			}
+
+			std::filesystem::remove(shardPath(shard));
+			std::sort(entry.begin(), entry.end(), [](const ShardEntry &a, const ShardEntry &b)
+			{
+				return a.row < b.row || (a.row == b.row && (a.target < b.target || (a.target == b.target && a.link < b.link)));
+			});
+
+			std::vector<ShardEntry>::const_iterator read = entry.cbegin();
+
+			for(NodeId row=shardBegin[shard];row<shardBegin[shard + 1];++row)
+			{
+				const std::size_t rowStart = block.target.size();
+
+				std::uint32_t weightedDegree = 0; // Accumulated as Graph does
+
+				for(;read!=entry.cend() && read->row == row;++read)
+				{
+					if(block.target.size() == rowStart || block.target.back() != read->target)
+					{
+						block.target.push_back(read->target);
+						block.weight.push_back(read->weight);
+						continue;
+					}
+
+					std::uint32_t &kept = block.weight.back(); // The link pre-exists: resolve it with the duplicate policy
+
+					switch(options.duplicatePolicy)
+					{
+					case DuplicatePolicy::Reject:
+						duplicate = std::min<std::size_t>(duplicate, read->link);
+						break;
+
+					case DuplicatePolicy::KeepFirst:
+						break;
+
+					case DuplicatePolicy::SumWeights:
+						kept = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t(kept) + read->weight, std::numeric_limits<std::uint32_t>::max()));
+						break;
+
+					case DuplicatePolicy::MaxWeight:
+						kept = std::max(kept, read->weight);
+						break;
+					}
+				}
+
+				for(std::size_t e=rowStart,endE=block.target.size();e<endE;++e)
+					weightedDegree += block.weight[e];
+
+				graph._weightedDegree[row] = weightedDegree;
+				block.offset.push_back(block.target.size());
+
+				// Blocks only end where PageRankEngine ends a chunk, once they are large enough
+				if((chunkEntries += block.target.size() - rowStart + 1) >= Kernels::chunkSize || row + 1 == nodeCount)
+				{
+					chunkEntries = 0;
+
+					if(row + 1 == nodeCount || (block.offset.size() - 1) * (sizeof(std::uint64_t) + 2 * sizeof(double)) + block.target.size() * (sizeof(NodeId) + sizeof(std::uint32_t)) >= blockBytes)
+						closeBlock(row + 1);
+				}
+			}
+		}
+
+		if(duplicate != noIndex)
+			throw std::runtime_error(GraphBuilder::duplicateLinkError(duplicate));
+
+		return graph;
+	}
+
+	ShardedGraph::~ShardedGraph(void)
+	{
+		if(this->_directory.empty())
+			return;
+
+		std::error_code error;
+
+		std::filesystem::remove_all(this->_directory, error); // Best effort: a destructor cannot report failure
+	}
+
+	ShardedGraph::ShardedGraph(ShardedGraph &&other) noexcept : _directory(std::exchange(other._directory, {})), _block(std::move(other._block)), _weightedDegree(std::move(other._weightedDegree)),
+		_namesPath(std::move(other._namesPath)), _entryCount(other._entryCount), _memoryBudget(other._memoryBudget)
+	{
+	}
+
+	ShardedGraph &ShardedGraph::operator=(ShardedGraph &&other) noexcept
+	{
+		if(this != &other)
+		{
+			ShardedGraph discarded(std::move(*this)); // Removes this graph's files once the other graph's are taken
+
+			this->_directory = std::exchange(other._directory, {});
+			this->_block = std::move(other._block);
+			this->_weightedDegree = std::move(other._weightedDegree);
+			this->_namesPath = std::move(other._namesPath);
+			this->_entryCount = other._entryCount;
+			this->_memoryBudget = other._memoryBudget;
+		}
+
+		return *this;
+	}
+
+	std::size_t ShardedGraph::getNodeCount(void) const noexcept
+	{
+		return this->_weightedDegree.size();
+	}
+
+	std::uint64_t ShardedGraph::getEntryCount(void) const noexcept
+	{
+		return this->_entryCount;
+	}
+
+	std::size_t ShardedGraph::getBlockCount(void) const noexcept
+	{
+		return this->_block.size();
+	}
+
+	std::size_t ShardedGraph::getMemoryBudget(void) const noexcept
+	{
+		return this->_memoryBudget;
+	}
+
+	std::span<const std::uint32_t> ShardedGraph::getWeightedDegrees(void) const noexcept
+	{
+		return this->_weightedDegree;
+	}
+
+	void ShardedGraph::readBlock(std::size_t index, Block &block) const
+	{
+		const BlockFile &file = this->_block.at(index);
+
+		std::ifstream input(file.path, std::ios::binary);
+
+		if(!input)
+			throw std::runtime_error("Error: opening file with path '" + file.path.string() + "' failed.");
+
+		block.begin = file.begin;
+		block.end = file.end;
+		readArray(input, block.offset, std::size_t(file.end - file.begin) + 1);
+		readArray(input, block.target, file.entryCount);
+		readArray(input, block.weight, file.entryCount);
+
+		if(!input)
+			throw std::runtime_error("Error: Block '" + file.path.string() + "' is truncated.");
+	}
+
+	std::vector<std::string> ShardedGraph::getNames(std::span<const NodeId> id) const
+	{
+		std::vector<std::string> name(id.size());
+
+		if(std::any_of(id.begin(), id.end(), [this](NodeId i) { return i >= this->getNodeCount(); }))
+			throw std::runtime_error("Error: Invalid node.");
+
+		if(this->_namesPath.empty())
+		{
+			for(std::size_t i=0,idCount=id.size();i<idCount;++i)
+				name[i] = std::to_string(id[i]);
+
+			return name;
+		}
+
+		std::vector<std::size_t> order(id.size());
+		std::ifstream input(this->_namesPath, std::ios::binary);
+		std::string line;
+
+		if(!input)
+			throw std::runtime_error("Error: opening file with path '" + this->_namesPath + "' failed.");
+
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&id](std::size_t a, std::size_t b) { return id[a] < id[b]; });
+
+		// Read the sidecar once, picking out the requested lines in ID order
+		std::vector<std::size_t>::const_iterator next = order.cbegin();
+
+		for(NodeId lineIndex=0;next!=order.cend() && std::getline(input, line);++lineIndex)
+		{
+			if(!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			for(;next!=order.cend() && id[*next] == lineIndex;++next)
+				name[*next] = line;
+		}
+
+		if(next != order.cend())
+			throw std::runtime_error("Error: The names sidecar '" + this->_namesPath + "' no longer names every node.");
+
+		return name;
+	}
+}
@@ -0,0 +1,184 @@
+/*****************************************************************//**
+ * @file   snapshot.cpp
+ * @brief  The binary snapshot implementation - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/snapshot.hpp"
+#include "i2/io.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace I2
+{
+	namespace Snapshot
+	{
+		namespace
+		{
+			constexpr std::array<char, 8> magic = {'I', '2', 'G', 'R', 'A', 'P', 'H', '\0'};
+			constexpr std::uint32_t byteOrderTag = 0x01020304; // Reads back as 0x04030201 on a host with the opposite byte order
+			constexpr std::size_t alignment = 8;
+
+			/**
+			 * @brief The fixed-size header at the start of every snapshot.
+			 */
+			struct Header
+			{
+				std::array<char, 8> magic;
+				std::uint32_t version;
+				std::uint32_t byteOrder;
+				std::uint64_t nodeCount;
+				std::uint64_t entryCount;
+				std::uint64_t nameBytes;
+				std::uint64_t reserved[3];
+			};
+
+			static_assert(sizeof(Header) == 64, "The snapshot header layout must not change within a format version");
+			static_assert(sizeof(unsigned int) == sizeof(std::uint32_t), "Snapshot weights are stored as 32 bit unsigned integers");
+
+			constexpr std::size_t align(std::size_t size)
+			{
+				return (size + alignment - 1) / alignment * alignment;
+			}
+
+			/**
+			 * @return The aligned size of count elements of elementSize bytes, or a size beyond fileSize (without overflowing) if they cannot fit within it
+			 */
+			constexpr std::size_t sectionSize(std::uint64_t count, std::size_t elementSize, std::size_t fileSize)
+			{
+				return count > fileSize / elementSize ? fileSize + 1 : align(static_cast<std::size_t>(count) * elementSize);
+			}
+
+			/**
+			 * @brief The byte position of each array within a snapshot, derived from the header counts alone: the counts are untrusted, so each
+			 * section is checked against the file size before it is added, and end exceeds the file size if any section does not fit.
+			 */
+			struct Sections
+			{
+				std::size_t offset, nameOffset, target, weight, weightedDegree, nameData, end;
+
+				Sections(const Header &header, std::size_t fileSize)
+				{
+					const std::uint64_t rowCount = header.nodeCount < fileSize ? header.nodeCount + 1 : fileSize; // Every node takes more than a byte
+
+					this->offset = sizeof(Header);
+					this->nameOffset = this->offset + sectionSize(rowCount, sizeof(std::uint64_t), fileSize);
+					this->target = this->nameOffset + sectionSize(rowCount, sizeof(std::uint64_t), fileSize);
+					this->weight = this->target + sectionSize(header.entryCount, sizeof(NodeId), fileSize);
+					this->weightedDegree = this->weight + sectionSize(header.entryCount, sizeof(std::uint32_t), fileSize);
+					this->nameData = this->weightedDegree + sectionSize(header.nodeCount, sizeof(std::uint32_t), fileSize);
+					this->end = this->nameData + sectionSize(header.nameBytes, 1, fileSize); // At most seven sections of fileSize + 8 bytes, so no sum can overflow
+				}
+			};
+
+			/**
+			 * @return true if the offsets start at 0, never decrease and end at end
+			 */
+			bool isValidOffsets(std::span<const std::uint64_t> offset, std::uint64_t end) noexcept
+			{
+				return offset.front() == 0 && offset.back() == end && std::is_sorted(offset.begin(), offset.end());
+			}
+
+			/**
+			 * @brief Writes an array followed by zero padding up to the next aligned position.
+			 */
+			template<typename T>
+			void writeSection(std::ofstream &file, std::span<const T> data)
+			{
+				constexpr std::array<char, alignment> padding{};
+				const std::size_t size = data.size_bytes();
+
+				file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(size));
+				file.write(padding.data(), static_cast<std::streamsize>(align(size) - size));
+			}
+
+			/**
+			 * @return A view of count elements of type T starting at position within the mapped file
+			 */
+			template<typename T>
+			std::span<const T> viewSection(const IO::MappedFile &file, std::size_t position, std::size_t count)
+			{
+				return std::span<const T>(reinterpret_cast<const T*>(file.data() + position), count); // Positions are aligned to 8 bytes and mappings to pages
+			}
+		}
+
+		void saveToFile(const Graph &graph, std::string path)
+		{
+			const Graph::Layout &layout = graph.getLayout();
+
+			std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+			Header header{magic, formatVersion, byteOrderTag, graph.getNodeCount(), graph.getEntryCount(), layout.nameData.size(), {0, 0, 0}};
+
+			if(!file.is_open())
+				throw std::runtime_error("Error: opening file with path '" + path + "' failed.");
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			writeSection(file, layout.offset);
+			writeSection(file, layout.nameOffset);
+			writeSection(file, layout.target);
+			writeSection(file, layout.weight);
+			writeSection(file, layout.weightedDegree);
+			writeSection(file, layout.nameData);
+
+			if(!file.flush())
+				throw std::runtime_error("Error: writing snapshot with path '" + path + "' failed.");
+		}
+
+		Graph loadFromFile(std::string path, bool validate)
+		{
+			std::shared_ptr<IO::MappedFile> file = std::make_shared<IO::MappedFile>(path);
+			Header header;
+			Graph::Layout layout;
+
+			if(file->size() < sizeof(Header))
+				throw std::runtime_error("Error: '" + path + "' is not a graph snapshot.");
+
+			std::memcpy(&header, file->data(), sizeof(Header));
+
+			if(header.magic != magic)
+				throw std::runtime_error("Error: '" + path + "' is not a graph snapshot.");
+
+			if(header.byteOrder != byteOrderTag)
+				throw std::runtime_error("Error: snapshot '" + path + "' was written on a host with a different byte order.");
+
+			if(header.version != formatVersion)
+				throw std::runtime_error("Error: snapshot '" + path + "' has unsupported version " + std::to_string(header.version) + ".");
+
+			if(header.nodeCount > std::numeric_limits<NodeId>::max())
+				throw std::runtime_error("Error: snapshot '" + path + "' holds more nodes than a graph can.");
+
+			const Sections sections(header, file->size());
+
+			if(file->size() < sections.end)
+				throw std::runtime_error("Error: snapshot '" + path + "' is truncated.");
+
+			layout.offset = viewSection<std::uint64_t>(*file, sections.offset, header.nodeCount + 1);
+			layout.nameOffset = viewSection<std::uint64_t>(*file, sections.nameOffset, header.nodeCount + 1);
+			layout.target = viewSection<NodeId>(*file, sections.target, header.entryCount);
+			layout.weight = viewSection<std::uint32_t>(*file, sections.weight, header.entryCount);
+			layout.weightedDegree = viewSection<std::uint32_t>(*file, sections.weightedDegree, header.nodeCount);
+			layout.nameData = viewSection<char>(*file, sections.nameData, header.nameBytes);
+
+			// Every row and name must lie within its array, and every link must reach a node, before the graph can be read without checks: O(V + E)
+			if(validate && (!isValidOffsets(layout.offset, header.entryCount) || !isValidOffsets(layout.nameOffset, header.nameBytes)
+				|| std::any_of(layout.target.begin(), layout.target.end(), [&header](NodeId target) { return target >= header.nodeCount; })))
+				throw std::runtime_error("Error: snapshot '" + path + "' is corrupt.");
+
+			return Graph(std::move(file), layout); // The graph keeps the mapping alive
+		}
+
+		bool isSnapshotFile(std::string path)
+		{
+			std::ifstream file(path, std::ifstream::binary);
+			std::array<char, 8> start{};
+
+			return file.read(start.data(), static_cast<std::streamsize>(start.size())) && start == magic;
+		}
+	}
+}
@@ -0,0 +1,197 @@
+/*****************************************************************//**
+ * @file   stats.cpp
+ * @brief  The telemetry recorder and process measurement function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/stats.hpp"
+#include <json/json.h>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+namespace I2
+{
+	namespace Stats
+	{
+		namespace
+		{
+			std::atomic<std::size_t> enabledRecorderCount = 0; // Allocations are only counted while at least one recorder is enabled
+			std::atomic<std::uint64_t> allocationCount = 0;
+		}
+
+		Recorder::ScopedPhase::ScopedPhase(Recorder *recorder, std::string_view name) : _recorder(recorder), _index(0), _cpuStart(0.0), _allocationStart(0)
+		{
+			if(!this->_recorder)
+				return;
+
+			this->_index = this->_recorder->_report.phase.size();
+			this->_recorder->_report.phase.push_back(Phase{std::string(name)});
+			this->_allocationStart = getAllocationCount();
+			this->_cpuStart = getCPUSeconds();
+			this->_wallStart = std::chrono::steady_clock::now(); // Started last and stopped first, so the phase excludes the bookkeeping
+		}
+
+		Recorder::ScopedPhase::~ScopedPhase(void)
+		{
+			if(!this->_recorder)
+				return;
+
+			const std::chrono::steady_clock::time_point wallEnd = std::chrono::steady_clock::now();
+
+			Phase &phase = this->_recorder->_report.phase[this->_index];
+
+			phase.wallSeconds = std::chrono::duration<double>(wallEnd - this->_wallStart).count();
+			phase.cpuSeconds = getCPUSeconds() - this->_cpuStart;
+			phase.allocationCount = getAllocationCount() - this->_allocationStart;
+		}
+
+		Recorder::Recorder(bool enabled) : _enabled(enabled)
+		{
+			if(this->_enabled)
+				enabledRecorderCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Recorder::~Recorder(void)
+		{
+			if(this->_enabled)
+				enabledRecorderCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		bool Recorder::isEnabled(void) const noexcept
+		{
+			return this->_enabled;
+		}
+
+		Recorder::ScopedPhase Recorder::time(std::string_view name)
+		{
+			return ScopedPhase(this->_enabled ? this : nullptr, name);
+		}
+
+		void Recorder::recordRanking(std::size_t iterationCount, std::span<const Kernels::Residual> residual)
+		{
+			if(!this->_enabled)
+				return;
+
+			this->_report.iterationCount = iterationCount;
+			this->_report.residual.assign(residual.begin(), residual.end());
+		}
+
+		void Recorder::recordAdjacency(std::size_t adjacencyBytes)
+		{
+			if(!this->_enabled)
+				return;
+
+			this->_report.adjacencyBytes = adjacencyBytes;
+		}
+
+		const Report &Recorder::finish(void)
+		{
+			if(this->_enabled)
+				this->_report.peakRSS = getPeakRSS();
+
+			return this->_report;
+		}
+
+		void noteAllocation(void) noexcept
+		{
+			if(enabledRecorderCount.load(std::memory_order_relaxed))
+				allocationCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::uint64_t getAllocationCount(void) noexcept
+		{
+			return allocationCount.load(std::memory_order_relaxed);
+		}
+
+		double getCPUSeconds(void) noexcept
+		{
+#ifdef _WIN32
+			FILETIME creation, exit, kernel, user;
+
+			if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+				return 0.0;
+
+			// FILETIME counts 100 nanosecond intervals
+			return (static_cast<double>((static_cast<std::uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime)
+				+ static_cast<double>((static_cast<std::uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime)) * 1e-7;
+#else
+			struct rusage usage;
+
+			if(getrusage(RUSAGE_SELF, &usage))
+				return 0.0;
+
+			return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+		}
+
+		std::size_t getPeakRSS(void) noexcept
+		{
+#ifdef _WIN32
+			PROCESS_MEMORY_COUNTERS counters;
+
+			if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+				return counters.PeakWorkingSetSize;
+
+			return 0;
+#else
+			struct rusage usage;
+
+			if(getrusage(RUSAGE_SELF, &usage))
+				return 0;
+
+#if defined(__APPLE__)
+			return static_cast<std::size_t>(usage.ru_maxrss); // Reported in bytes
+#else
+			return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // Reported in kilobytes
+#endif
+#endif
+		}
+
+		void writeJSON(const Report &report, std::ostream &output)
+		{
+			Json::Value root(Json::objectValue), phases(Json::arrayValue), residuals(Json::arrayValue);
+			Json::StreamWriterBuilder writerBuilder;
+
+			for(const Phase &phase : report.phase)
+			{
+				Json::Value &entry = phases.append(Json::Value(Json::objectValue));
+
+				entry["name"] = phase.name;
+				entry["wallSeconds"] = phase.wallSeconds;
+				entry["cpuSeconds"] = phase.cpuSeconds;
+				entry["allocations"] = Json::UInt64(phase.allocationCount);
+			}
+
+			for(const Kernels::Residual &residual : report.residual)
+			{
+				Json::Value &entry = residuals.append(Json::Value(Json::objectValue));
+
+				entry["l1"] = residual.l1;
+				entry["lInf"] = residual.lInf;
+			}
+
+			root["phases"] = std::move(phases);
+			root["iterations"] = Json::UInt64(report.iterationCount);
+			root["residuals"] = std::move(residuals);
+			root["adjacencyBytes"] = Json::UInt64(report.adjacencyBytes);
+			root["peakRSSBytes"] = Json::UInt64(report.peakRSS);
+
+			writerBuilder["indentation"] = ""; // One line, so a report can be appended to a log
+			std::unique_ptr<Json::StreamWriter>(writerBuilder.newStreamWriter())->write(root, &output);
+			output << std::endl;
+		}
+	}
+}
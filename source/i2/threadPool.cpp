@@ -0,0 +1,282 @@
+/*****************************************************************//**
+ * @file   threadPool.cpp
+ * @brief  The WorkStealingPool and TaskPool function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/threadPool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace I2
+{
+	WorkStealingPool::WorkStealingPool(std::size_t threadCount)
+	{
+		if(!threadCount)
+			threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+		for(std::size_t i=0;i<threadCount;++i)
+			this->_share.push_back(std::make_unique<Share>());
+
+		this->_worker.reserve(threadCount - 1);
+
+		for(std::size_t i=1;i<threadCount;++i)
+			this->_worker.emplace_back(&WorkStealingPool::workerLoop, this, i);
+	}
+
+	WorkStealingPool::~WorkStealingPool(void)
+	{
+		{ // Provide a separate scope so the lock releases prior to joining
+			std::unique_lock<std::mutex> locker(this->_lock);
+			this->_stopping = true;
+		}
+
+		this->_wake.notify_all();
+
+		for(std::thread &worker : this->_worker)
+			worker.join();
+	}
+
+	std::size_t WorkStealingPool::getThreadCount(void) const noexcept
+	{
+		return this->_share.size();
+	}
+
+	void WorkStealingPool::workerLoop(std::size_t index)
+	{
+		std::size_t generation = 0;
+
+		while(true)
+		{
+			{ // Wait for the next loop (or shutdown)
+				std::unique_lock<std::mutex> locker(this->_lock);
+				this->_wake.wait(locker, [&](void) { return this->_stopping || this->_generation != generation; });
+
+				if(this->_stopping)
+					return;
+
+				generation = this->_generation;
+			}
+
+			this->runShare(index);
+
+			{ // Report completion: the last thread to finish wakes the caller
+				std::unique_lock<std::mutex> locker(this->_lock);
+
+				if(!--this->_running)
+					this->_done.notify_one();
+			}
+		}
+	}
+
+	void WorkStealingPool::runShare(std::size_t index)
+	{
+		Share &share = *this->_share[index];
+
+		do
+		{
+			while(true)
+			{
+				std::size_t task = 0;
+
+				{ // Take the next task from the front of our own share
+					std::unique_lock<std::mutex> locker(share.lock);
+
+					if(share.begin == share.end)
+						break;
+
+					task = share.begin++;
+				}
+
+				try
+				{
+					this->_function(this->_context, task);
+				}
+				catch(...)
+				{
+					std::unique_lock<std::mutex> locker(this->_lock);
+
+					if(!this->_error)
+						this->_error = std::current_exception();
+				}
+			}
+		}
+		while(this->steal(index)); // Our share is exhausted: keep stealing until every share is
+	}
+
+	bool WorkStealingPool::steal(std::size_t index)
+	{
+		const std::size_t threadCount = this->_share.size();
+
+		Share &share = *this->_share[index];
+		std::size_t victim = index, remaining = 0;
+
+		// Pick the share with the most remaining tasks (sizes are only a hint, and are re-checked under the victim's lock)
+		for(std::size_t i=0;i<threadCount;++i)
+		{
+			std::unique_lock<std::mutex> locker(this->_share[i]->lock);
+			const std::size_t size = this->_share[i]->end - this->_share[i]->begin;
+
+			if(i != index && size > remaining)
+			{
+				victim = i;
+				remaining = size;
+			}
+		}
+
+		if(victim == index)
+			return false;
+
+		std::size_t begin = 0, end = 0;
+
+		{ // Take the back half of the victim's remaining tasks
+			std::unique_lock<std::mutex> locker(this->_share[victim]->lock);
+			Share &from = *this->_share[victim];
+			const std::size_t size = from.end - from.begin;
+
+			if(!size)
+				return true; // The victim finished in the meantime: look again
+
+			end = from.end;
+			begin = from.end - (size + 1) / 2;
+			from.end = begin;
+		}
+
+		std::unique_lock<std::mutex> locker(share.lock);
+		share.begin = begin;
+		share.end = end;
+
+		return true;
+	}
+
+	void WorkStealingPool::run(std::size_t taskCount, TaskFunction function, void *context)
+	{
+		const std::size_t threadCount = this->_share.size();
+
+		std::exception_ptr error;
+
+		if(!taskCount)
+			return;
+
+		{ // Hand each thread an equal contiguous share and wake the workers
+			std::unique_lock<std::mutex> locker(this->_lock);
+
+			for(std::size_t i=0;i<threadCount;++i)
+			{
+				std::unique_lock<std::mutex> shareLocker(this->_share[i]->lock);
+				this->_share[i]->begin = taskCount * i / threadCount;
+				this->_share[i]->end = taskCount * (i + 1) / threadCount;
+			}
+
+			this->_function = function;
+			this->_context = context;
+			this->_error = nullptr;
+			this->_running = threadCount - 1;
+			++this->_generation;
+		}
+
+		this->_wake.notify_all();
+		this->runShare(0); // The calling thread works too
+
+		{ // Wait for the workers to drain every share
+			std::unique_lock<std::mutex> locker(this->_lock);
+			this->_done.wait(locker, [this](void) { return this->_running == 0; });
+			error = std::exchange(this->_error, nullptr);
+		}
+
+		if(error)
+			std::rethrow_exception(error);
+	}
+
+	TaskPool::TaskPool(std::size_t threadCount)
+	{
+		if(!threadCount)
+			threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+		this->_worker.reserve(threadCount);
+
+		for(std::size_t i=0;i<threadCount;++i)
+			this->_worker.emplace_back(&TaskPool::workerLoop, this);
+	}
+
+	TaskPool::~TaskPool(void)
+	{
+		{ // Provide a separate scope so the lock releases prior to joining
+			std::unique_lock<std::mutex> locker(this->_lock);
+			this->_stopping = true;
+		}
+
+		this->_wake.notify_all();
+
+		for(std::thread &worker : this->_worker)
+			worker.join();
+	}
+
+	std::size_t TaskPool::getThreadCount(void) const noexcept
+	{
+		return this->_worker.size();
+	}
+
+	void TaskPool::workerLoop(void)
+	{
+		while(true)
+		{
+			std::function<void(void)> task;
+
+			{ // Wait for a task (or shutdown, once the queue has drained)
+				std::unique_lock<std::mutex> locker(this->_lock);
+				this->_wake.wait(locker, [&](void) { return this->_stopping || !this->_task.empty(); });
+
+				if(this->_task.empty())
+					return;
+
+				task = std::move(this->_task.front());
+				this->_task.pop_front();
+				++this->_running;
+			}
+
+			try
+			{
+				task();
+			}
+			catch(...)
+			{
+				std::unique_lock<std::mutex> locker(this->_lock);
+
+				if(!this->_error)
+					this->_error = std::current_exception();
+			}
+
+			std::unique_lock<std::mutex> locker(this->_lock);
+
+			if(!--this->_running && this->_task.empty())
+				this->_idle.notify_all();
+		}
+	}
+
+	void TaskPool::submit(std::function<void(void)> task)
+	{
+		{
+			std::unique_lock<std::mutex> locker(this->_lock);
+			this->_task.push_back(std::move(task));
+		}
+
+		this->_wake.notify_one();
+	}
+
+	void TaskPool::wait(void)
+	{
+		std::exception_ptr error;
+
+		{
+			std::unique_lock<std::mutex> locker(this->_lock);
+			this->_idle.wait(locker, [&](void) { return !this->_running && this->_task.empty(); });
+			error = std::exchange(this->_error, nullptr);
+		}
+
+		if(error)
+			std::rethrow_exception(error);
+	}
+}
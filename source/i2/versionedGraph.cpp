@@ -0,0 +1,174 @@
+/*****************************************************************//**
+ * @file   versionedGraph.cpp
+ * @brief  The VersionedGraph function definitions - source file separated from header for security
+ *
+ * @author Mike Orr
+ * @date   April 2025
+ *********************************************************************/
+
+#include "i2/versionedGraph.hpp"
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace I2
+{
+	VersionedGraph::VersionedGraph(Graph initial, bool nodesCanLinkToSelf) : _liveCount(std::make_shared<std::atomic<std::size_t>>(0)), _nodesCanLinkToSelf(nodesCanLinkToSelf), _nodeCount(initial.getNodeCount())
+	{
+		this->_latest.store(this->makeVersion(std::move(initial), 0));
+	}
+
+	std::shared_ptr<const VersionedGraph::Version> VersionedGraph::makeVersion(Graph graph, std::uint64_t epoch) const
+	{
+		std::shared_ptr<std::atomic<std::size_t>> liveCount = this->_liveCount;
+
+		liveCount->fetch_add(1);
+
+		// The deleter runs when the last holder (the versioned graph or a reader) lets go, on whichever thread that is
+		return std::shared_ptr<const Version>(new Version{std::move(graph), epoch}, [liveCount](const Version *version)
+		{
+			delete version;
+			liveCount->fetch_sub(1);
+		});
+	}
+
+	std::shared_ptr<const VersionedGraph::Version> VersionedGraph::pin(void) const
+	{
+		return this->_latest.load();
+	}
+
+	NodeId VersionedGraph::addNode(std::string_view name)
+	{
+		if(!name.length())
+			throw std::runtime_error("Node invalid: no name provided!"); // Consistent with the Node constructor
+
+		std::lock_guard<std::mutex> locker(this->_stageLock);
+
+		this->_stagedName.emplace_back(name);
+
+		return static_cast<NodeId>(this->_nodeCount++);
+	}
+
+	void VersionedGraph::addLink(NodeId source, NodeId target, unsigned int weight)
+	{
+		std::lock_guard<std::mutex> locker(this->_stageLock);
+
+		if(source >= this->_nodeCount || target >= this->_nodeCount || (source == target && !this->_nodesCanLinkToSelf))
+			throw std::runtime_error("Error: Invalid link.");
+
+		this->_stagedChange.push_back(Change{source, target, weight, false});
+	}
+
+	void VersionedGraph::removeLink(NodeId source, NodeId target)
+	{
+		std::lock_guard<std::mutex> locker(this->_stageLock);
+
+		if(source < this->_nodeCount && target < this->_nodeCount) // A link to an unknown node cannot exist
+			this->_stagedChange.push_back(Change{source, target, 0, true});
+	}
+
+	std::size_t VersionedGraph::getPendingCount(void) const
+	{
+		std::lock_guard<std::mutex> locker(this->_stageLock);
+
+		return this->_stagedName.size() + this->_stagedChange.size();
+	}
+
+	std::uint64_t VersionedGraph::publish(void)
+	{
+		std::lock_guard<std::mutex> publishLocker(this->_publishLock);
+
+		const std::shared_ptr<const Version> base = this->_latest.load();
+		const Graph::Layout &layout = base->graph.getLayout();
+		const std::size_t baseCount = base->graph.getNodeCount();
+
+		std::vector<std::string> stagedName;
+		std::vector<Change> stagedChange;
+		std::unordered_map<NodeId, std::map<NodeId, std::uint32_t>> editedRow; // Only the rows a change touches, ordered by target as in a Graph
+		NamePool name;
+		std::vector<std::uint64_t> offset(1, 0);
+		std::vector<NodeId> target;
+		std::vector<std::uint32_t> weight;
+
+		{ // Take the staged changes, so writers can keep staging while the version is built
+			std::lock_guard<std::mutex> locker(this->_stageLock);
+
+			stagedName.swap(this->_stagedName);
+			stagedChange.swap(this->_stagedChange);
+		}
+
+		if(stagedName.empty() && stagedChange.empty())
+			return base->epoch;
+
+		const std::size_t nodeCount = baseCount + stagedName.size();
+
+		// Copies a row out of the base version the first time a change touches it
+		auto rowOf = [&](NodeId id) -> std::map<NodeId, std::uint32_t> &
+		{
+			auto [itRow, inserted] = editedRow.try_emplace(id);
+
+			if(inserted && id < baseCount)
+			{
+				for(std::size_t e=layout.offset[id],endE=layout.offset[id + 1];e<endE;++e)
+					itRow->second.emplace_hint(itRow->second.end(), layout.target[e], layout.weight[e]);
+			}
+
+			return itRow->second;
+		};
+
+		for(const Change &change : stagedChange)
+		{
+			if(change.remove)
+			{
+				rowOf(change.source).erase(change.target);
+				rowOf(change.target).erase(change.source);
+			}
+			else
+			{ // Both directions are always present together, so either both inserts happen or neither does
+				rowOf(change.source).emplace(change.target, change.weight);
+				rowOf(change.target).emplace(change.source, change.weight);
+			}
+		}
+
+		// Lay the new version out: untouched rows are copied straight from the base version
+		name.reserve(nodeCount, layout.nameData.size());
+		offset.reserve(nodeCount + 1);
+		target.reserve(layout.target.size() + stagedChange.size() * 2);
+		weight.reserve(layout.weight.size() + stagedChange.size() * 2);
+
+		for(std::size_t i=0;i<nodeCount;++i)
+		{
+			const auto itRow = editedRow.find(static_cast<NodeId>(i));
+
+			name.add(i < baseCount ? base->graph.getName(static_cast<NodeId>(i)) : std::string_view(stagedName[i - baseCount]));
+
+			if(itRow != editedRow.cend())
+			{
+				for(std::map<NodeId,std::uint32_t>::const_iterator itL=itRow->second.cbegin(),endL=itRow->second.cend();itL!=endL;++itL)
+				{
+					target.push_back(itL->first);
+					weight.push_back(itL->second);
+				}
+			}
+			else if(i < baseCount)
+			{
+				target.insert(target.end(), layout.target.begin() + layout.offset[i], layout.target.begin() + layout.offset[i + 1]);
+				weight.insert(weight.end(), layout.weight.begin() + layout.offset[i], layout.weight.begin() + layout.offset[i + 1]);
+			}
+
+			offset.push_back(target.size());
+		}
+
+		const std::shared_ptr<const Version> next = this->makeVersion(Graph(std::move(name), std::move(offset), std::move(target), std::move(weight)), base->epoch + 1);
+
+		this->_latest.store(next); // Readers pin this from now on: base is reclaimed once the last reader pinning it lets go
+
+		return next->epoch;
+	}
+
+	std::size_t VersionedGraph::getLiveVersionCount(void) const noexcept
+	{
+		return this->_liveCount->load();
+	}
+}
@@ -7,9 +7,20 @@
  *********************************************************************/
 
 #include <i2/nodeLoader.hpp>
+#include <i2/snapshot.hpp>
+#include <i2/compressedGraph.hpp>
+#include <i2/edgeList.hpp>
+#include <i2/pageRank.hpp>
+#include <i2/reorder.hpp>
+#include <i2/resultWriter.hpp>
+#include <i2/service.hpp>
+#include <i2/shardedGraph.hpp>
+#include <i2/stats.hpp>
 #include <boost/program_options.hpp>
+#include <fstream>
 #include <iostream>
-#include <iomanip>
+#include <memory>
+#include <optional>
 
 namespace po = boost::program_options;
 
@@ -21,19 +32,49 @@ namespace po = boost::program_options;
  */
 int main(int argC, char **argV)
 {
-	std::vector<std::shared_ptr<I2::Node>> nodeList;
-	std::vector<std::pair<std::shared_ptr<I2::Node>,double>> pageRank;
+	I2::Graph graph;
+	std::vector<I2::NodeId> nodeOrder;
+	std::vector<double> pageRank;
+	std::vector<I2::NodeId> seedId;
+	std::vector<std::string> seedName;
 	po::options_description allOptions("Menu"), generalOptions("General"), processOptions("Process"), rankOptions("Rank");
-	std::string path = "";
+	std::string path = "", snapshotPath = "", namesPath = "", duplicates = "first", statsPath = "", stop = "max", accelerate = "none", warmStartPath = "", saveRanksPath = "", servePath = "", format = "text", outputPath = "", shardPath = "", reorder = "";
+	I2::DuplicatePolicy duplicatePolicy = I2::DuplicatePolicy::KeepFirst;
+	I2::PageRankOptions rankSettings;
+	I2::OutputFormat outputFormat = I2::OutputFormat::Text;
+	std::optional<I2::Reorder::Ordering> ordering;
+	I2::Reorder::Permutation permutation; // Maps the IDs of a reordered graph back to those of the input: the identity unless --reorder is passed
+	std::size_t threadCount = 1, relatedCount = 10, topCount = 0, memoryBudget = 0;
 
 	generalOptions.add_options() // Build out the CLI menu options
-		("help,h", "Display the help content.");
+		("help,h", "Display the help content.")
+		("stats", po::value<std::string>(&statsPath)->implicit_value("-"),"Reports the wall time, CPU time and allocations of each phase, the PageRank iterations and residuals, and the peak memory as JSON: to stderr, or to the specified file.");
 
 	processOptions.add_options()
-		("process,p", po::value<std::string>(&path),"Processes the specified JSON Node file and outputs the weighted results.");
+		("process,p", po::value<std::string>(&path),"Processes the specified JSON Node file (or binary snapshot, or .csv/.tsv/.txt/.edges text or .bin binary edge list) and outputs the weighted results.")
+		("names", po::value<std::string>(&namesPath),"Names the nodes of an edge list from the specified file, one name per line: otherwise nodes are named by ID.")
+		("duplicates", po::value<std::string>(&duplicates)->default_value("first"),"How links listed more than once are resolved: 'reject' (fail), 'first' (keep the first weight), 'sum' (sum the weights) or 'max' (keep the largest weight).")
+		("snapshot,s", po::value<std::string>(&snapshotPath),"Saves the processed graph as a binary snapshot at the specified path: pass the snapshot to --process for near-instant loading.")
+		("format", po::value<std::string>(&format)->default_value("text"),"How the results are output: 'text' (name: value lines), 'csv', 'jsonl' (one JSON object per line) or 'binary' (per section, a uint64 count then packed uint32 ID and float64 value records).")
+		("output,o", po::value<std::string>(&outputPath),"Writes the results to the specified file rather than stdout.")
+		("reorder", po::value<std::string>(&reorder),"Relabels the nodes after loading so that linked nodes sit close together in memory, speeding up ranking: 'degree' (most linked first), 'rcm' (reverse Cuthill-McKee) or 'community' (Rabbit-style communities). Results keep the input IDs and names, though ranks can differ in their last bits as each row is summed in a new order.")
+		("top,n", po::value<std::size_t>(&topCount)->default_value(0),"Only outputs the N highest weighted (and ranked) nodes: 0 outputs every node. The order matches the full output.")
+		("memory-budget", po::value<std::size_t>(&memoryBudget),"Ranks an edge list too large for memory within the specified budget (in MiB): the links are sharded into blocks on disk and streamed through memory in each PageRank iteration, giving the same results.")
+		("shard-dir", po::value<std::string>(&shardPath),"The directory --memory-budget writes its blocks to (removed afterwards): the system temporary directory by default.")
+		("serve", po::value<std::string>(&servePath)->implicit_value("-"),"Keeps the processed graph in memory and answers newline-delimited JSON requests (top, degree, rank, addNode, addLink, removeLink, recompute, shutdown): on stdin/stdout, or on the Unix domain socket at the specified path.");
 
 	rankOptions.add_options()
-		("rank,r","PageRank the nodes and output the PageRank results.");
+		("rank,r","PageRank the nodes and output the PageRank results.")
+		("threads,t", po::value<std::size_t>(&threadCount)->default_value(1),"The number of threads to load the input and PageRank on (0 uses every hardware thread): results are identical for any thread count.")
+		("tolerance", po::value<double>(&rankSettings.tolerance)->default_value(rankSettings.tolerance),"PageRank stops once the residual chosen by --stop is no more than this.")
+		("stop", po::value<std::string>(&stop)->default_value("max"),"How PageRank convergence is measured: 'max' (the largest rank change) or 'l1' (the sum of the rank changes).")
+		("max-iterations", po::value<std::size_t>(&rankSettings.maxIterations)->default_value(0),"PageRank stops after this many iterations even if not converged: 0 for no limit.")
+		("accelerate", po::value<std::string>(&accelerate)->default_value("none"),"How PageRank convergence is accelerated: 'none', 'extrapolate' (jump ahead once the changes shrink geometrically) or 'gauss-seidel' (gather from ranks already updated).")
+		("compress","Ranks a delta and varint encoded copy of the adjacency rows: the results are identical, but each PageRank iteration reads far fewer bytes.")
+		("warm-start", po::value<std::string>(&warmStartPath),"Starts PageRank from the ranks saved by --save-ranks, matched by node name: a previous day's ranks converge in far fewer iterations.")
+		("save-ranks", po::value<std::string>(&saveRanksPath),"Saves the full-precision PageRank results at the specified path, for a later --warm-start.")
+		("personalize,P", po::value<std::vector<std::string>>(&seedName)->multitoken(),"Outputs the nodes most related to the named seed node(s), using personalized PageRank: only the neighbourhood of the seeds is visited.")
+		("related,k", po::value<std::size_t>(&relatedCount)->default_value(10),"The number of related nodes output by --personalize (0 outputs every node reached).");
 
 	allOptions.add(generalOptions).add(processOptions).add(rankOptions);
 
@@ -50,25 +91,277 @@ int main(int argC, char **argV)
 			return 0;
 		}
 
+		if(duplicates == "reject")
+			duplicatePolicy = I2::DuplicatePolicy::Reject;
+		else if(duplicates == "sum")
+			duplicatePolicy = I2::DuplicatePolicy::SumWeights;
+		else if(duplicates == "max")
+			duplicatePolicy = I2::DuplicatePolicy::MaxWeight;
+		else if(duplicates != "first")
+			throw po::error("unknown duplicate policy '" + duplicates + "'");
+
+		if(stop == "l1")
+			rankSettings.stoppingRule = I2::StoppingRule::L1;
+		else if(stop != "max")
+			throw po::error("unknown stopping rule '" + stop + "'");
+
+		if(accelerate == "extrapolate")
+			rankSettings.acceleration = I2::Acceleration::Extrapolation;
+		else if(accelerate == "gauss-seidel")
+			rankSettings.acceleration = I2::Acceleration::GaussSeidel;
+		else if(accelerate != "none")
+			throw po::error("unknown acceleration '" + accelerate + "'");
+
+		if(format == "csv")
+			outputFormat = I2::OutputFormat::CSV;
+		else if(format == "jsonl")
+			outputFormat = I2::OutputFormat::JSONLines;
+		else if(format == "binary")
+			outputFormat = I2::OutputFormat::Binary;
+		else if(format != "text")
+			throw po::error("unknown output format '" + format + "'");
+
+		if(reorder == "degree")
+			ordering = I2::Reorder::Ordering::Degree;
+		else if(reorder == "rcm")
+			ordering = I2::Reorder::Ordering::ReverseCuthillMcKee;
+		else if(reorder == "community")
+			ordering = I2::Reorder::Ordering::Community;
+		else if(reorder.length())
+			throw po::error("unknown ordering '" + reorder + "'");
+
+		if(ordering && varMap.count("serve"))
+			throw po::error("--reorder cannot be combined with --serve");
+
+		rankSettings.threadCount = threadCount;
+
+		if(varMap.count("memory-budget"))
+		{
+			if(I2::EdgeList::detectFormat(path) == I2::EdgeList::Format::None)
+				throw po::error("--memory-budget needs an edge list");
+
+			for(const char *option : {"snapshot", "serve", "personalize", "warm-start", "save-ranks", "compress", "reorder"})
+			{
+				if(varMap.count(option))
+					throw po::error(std::string("--") + option + " cannot be combined with --memory-budget");
+			}
+		}
+
 		if(varMap.count("process"))
 		{
-			nodeList = std::move(I2::NodeLoader::loadNodesFromFile(path)); // Utilise the I2 library to load nodes and associate nodes linked to weights
-			std::sort(nodeList.begin(),nodeList.end(),I2::nodeCompareGT); // Sort into descending order (by weighted degree)
+			I2::Stats::Recorder recorder(varMap.count("stats") > 0);
+
+			// Every result is formatted into one large buffer, rather than flushed line by line: opened first, so a bad path fails before loading
+			std::unique_ptr<I2::ResultWriter> writer = outputPath.length() ? std::make_unique<I2::ResultWriter>(outputPath,outputFormat) : std::make_unique<I2::ResultWriter>(std::cout,outputFormat);
+
+			const auto reportStats = [&]()
+			{
+				if(!recorder.isEnabled())
+					return;
+
+				if(statsPath == "-")
+					I2::Stats::writeJSON(recorder.finish(),std::cerr);
+				else
+				{
+					std::ofstream statsFile(statsPath);
+
+					if(!statsFile)
+						throw std::runtime_error("Unable to write the stats to '" + statsPath + "'.");
+
+					I2::Stats::writeJSON(recorder.finish(),statsFile);
+				}
+			};
+
+			if(memoryBudget)
+			{ // Rank from disk: only the per-node arrays and the blocks in use are held in memory
+				std::optional<I2::ShardedGraph> shardedGraph;
+				std::vector<std::string> name;
+
+				{
+					const I2::Stats::Recorder::ScopedPhase phase = recorder.time("load");
+
+					shardedGraph.emplace(I2::ShardedGraph::fromEdgeList(path,I2::EdgeList::Options{.namesPath = namesPath, .duplicatePolicy = duplicatePolicy},I2::ShardOptions{.memoryBudget = memoryBudget << 20, .directory = shardPath}));
+				}
+
+				{
+					const I2::Stats::Recorder::ScopedPhase phase = recorder.time("sortDegree");
+
+					nodeOrder = I2::NodeLoader::topNodesByWeightedDegree(shardedGraph->getWeightedDegrees(),topCount);
+				}
+
+				name = shardedGraph->getNames(nodeOrder);
+				writer->beginSection("degree",nodeOrder.size(),0);
+
+				for(std::size_t i=0;i<nodeOrder.size();++i)
+					writer->writeRow(name[i],nodeOrder[i],shardedGraph->getWeightedDegrees()[nodeOrder[i]]);
+
+				if(varMap.count("rank"))
+				{
+					I2::OutOfCorePageRank engine(*shardedGraph); // Only used within the rank phase, but its rank array is kept until the output is written
+
+					{
+						const I2::Stats::Recorder::ScopedPhase phase = recorder.time("rank");
+
+						rankSettings.recordResiduals = recorder.isEnabled();
+						engine.run(rankSettings);
+						recorder.recordRanking(engine.getIterationCount(),engine.getResidualHistory());
+
+						if(!engine.hasConverged())
+							std::cerr << "Warning: PageRank stopped after " << engine.getIterationCount() << " iterations without converging." << std::endl;
+					}
+
+					{
+						const I2::Stats::Recorder::ScopedPhase phase = recorder.time("sortRank");
+
+						nodeOrder = I2::NodeLoader::topNodesByRank(engine.getRanks(),topCount);
+					}
+
+					name = shardedGraph->getNames(nodeOrder);
+					writer->beginSection("rank",nodeOrder.size(),2);
+
+					for(std::size_t i=0;i<nodeOrder.size();++i)
+						writer->writeRow(name[i],nodeOrder[i],engine.getRanks()[nodeOrder[i]]);
+				}
+
+				writer->flush();
+				reportStats();
+
+				return 0;
+			}
+
+			{
+				const I2::Stats::Recorder::ScopedPhase phase = recorder.time("load");
+
+				switch(I2::EdgeList::detectFormat(path)) // Utilise the I2 library to load the nodes and links into a read-optimised graph
+				{
+				case I2::EdgeList::Format::Text:
+					graph = I2::EdgeList::loadText(path,I2::EdgeList::Options{.namesPath = namesPath, .duplicatePolicy = duplicatePolicy, .threadCount = threadCount});
+					break;
+
+				case I2::EdgeList::Format::Binary:
+					graph = I2::EdgeList::loadBinary(path,I2::EdgeList::Options{.namesPath = namesPath, .duplicatePolicy = duplicatePolicy, .threadCount = threadCount});
+					break;
 
-			for(std::vector<std::shared_ptr<I2::Node>>::const_iterator itN=nodeList.cbegin(),endN=nodeList.cend();itN!=endN;++itN)
-				std::cout << **itN; // Output each node: should be highest weighted degree first
+				default:
+					graph = I2::NodeLoader::loadGraphFromFile(path,false,duplicatePolicy,threadCount);
+					break;
+				}
+			}
+
+			if(snapshotPath.length())
+			{
+				const I2::Stats::Recorder::ScopedPhase phase = recorder.time("snapshot");
+
+				I2::Snapshot::saveToFile(graph,snapshotPath);
+			}
+
+			if(varMap.count("serve"))
+			{ // Answer requests against the loaded graph instead of producing the one-off output
+				I2::Service service(graph,I2::ServiceOptions{.rank = rankSettings, .threadCount = threadCount});
+
+				if(servePath == "-")
+					service.serve(std::cin,std::cout);
+				else
+					service.serveSocket(servePath);
+
+				return 0;
+			}
+
+			if(ordering)
+			{ // Relabel the nodes for locality: the snapshot above keeps the input order
+				const I2::Stats::Recorder::ScopedPhase phase = recorder.time("reorder");
+
+				permutation = I2::Reorder::computeOrdering(graph,*ordering);
+				graph = I2::Reorder::apply(graph,permutation,threadCount);
+			}
+
+			{
+				const I2::Stats::Recorder::ScopedPhase phase = recorder.time("sortDegree");
+
+				nodeOrder = I2::NodeLoader::topNodesByWeightedDegree(permutation.restore(graph.getLayout().weightedDegree),topCount); // Select into descending order (by weighted degree): ties keep their input order
+			}
+
+			writer->beginSection("degree",nodeOrder.size(),0);
+
+			for(std::vector<I2::NodeId>::const_iterator itN=nodeOrder.cbegin(),endN=nodeOrder.cend();itN!=endN;++itN)
+				writer->writeRow(graph.getName(permutation.toReordered(*itN)),*itN,graph.getWeightedDegree(permutation.toReordered(*itN))); // Output each node: should be highest weighted degree first
 
 			if(varMap.count("rank"))
 			{
-				std::cout << std::endl; // Separte this output from the above output
-				pageRank = I2::NodeLoader::computePageRank(nodeList); // Determine the rankings
+				I2::CompressedGraph compressedGraph;
+
+				if(varMap.count("compress"))
+				{
+					const I2::Stats::Recorder::ScopedPhase phase = recorder.time("compress");
+
+					compressedGraph = I2::CompressedGraph(graph,threadCount);
+				}
+
+				recorder.recordAdjacency(varMap.count("compress") ? compressedGraph.getAdjacencyBytes() : I2::CompressedGraph::getAdjacencyBytes(graph));
 
-				std::sort(pageRank.begin(),pageRank.end(),I2::NodeLoader::pageRankComparatorGT); // Sort the rankings, descending
+				{
+					const I2::Stats::Recorder::ScopedPhase phase = recorder.time("rank");
+					I2::PageRankEngine engine = varMap.count("compress") ? I2::PageRankEngine(compressedGraph) : I2::PageRankEngine(graph);
+
+					rankSettings.recordResiduals = recorder.isEnabled();
+
+					if(warmStartPath.length())
+						pageRank = engine.run(rankSettings,I2::NodeLoader::loadRanksFromFile(graph,warmStartPath)); // Resume from the saved rankings
+					else
+						pageRank = engine.run(rankSettings); // Determine the rankings
+
+					recorder.recordRanking(engine.getIterationCount(),engine.getResidualHistory());
+
+					if(!engine.hasConverged())
+						std::cerr << "Warning: PageRank stopped after " << engine.getIterationCount() << " iterations without converging." << std::endl;
+				}
+
+				if(saveRanksPath.length())
+					I2::NodeLoader::saveRanksToFile(graph,pageRank,saveRanksPath);
+
+				{
+					const I2::Stats::Recorder::ScopedPhase phase = recorder.time("sortRank");
+
+					nodeOrder = I2::NodeLoader::topNodesByRank(permutation.restore(pageRank),topCount); // Select the rankings, descending, by input ID
+				}
 
 				// Output the PageRank results
-				for(std::vector<std::pair<std::shared_ptr<I2::Node>,double>>::const_iterator itR=pageRank.cbegin(),endR=pageRank.cend();itR!=endR;++itR)
-					std::cout << itR->first->getName() << ": " << std::fixed << std::setprecision(2) << itR->second << std::endl;
+				writer->beginSection("rank",nodeOrder.size(),2);
+
+				for(std::vector<I2::NodeId>::const_iterator itR=nodeOrder.cbegin(),endR=nodeOrder.cend();itR!=endR;++itR)
+					writer->writeRow(graph.getName(permutation.toReordered(*itR)),*itR,pageRank[permutation.toReordered(*itR)]);
+			}
+
+			if(varMap.count("personalize"))
+			{
+				std::vector<std::pair<I2::NodeId,double>> related;
+
+				for(const std::string &name : seedName)
+				{
+					const std::optional<I2::NodeId> id = graph.findNode(name);
+
+					if(!id)
+						throw std::runtime_error("Unknown seed node '" + name + "'.");
+
+					seedId.push_back(*id);
+				}
+
+				{
+					const I2::Stats::Recorder::ScopedPhase phase = recorder.time("personalize");
+
+					related = I2::NodeLoader::computePersonalizedPageRank(graph,seedId,I2::PersonalizedPageRankOptions{.topK = relatedCount});
+				}
+
+				// Output the related nodes, most related first
+				writer->beginSection("related",related.size(),6);
+
+				for(const std::pair<I2::NodeId,double> &entry : related)
+					writer->writeRow(graph.getName(entry.first),permutation.toOriginal(entry.first),entry.second);
 			}
+
+			writer->flush(); // Report any write error, which the destructor cannot
+
+			reportStats();
 		}
 	}
 	catch(const po::error &e)
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <i2/compressedGraph.hpp>
+#include <i2/generator.hpp>
+#include <i2/node.hpp>
+#include <i2/pageRank.hpp>
+#include <algorithm>
+
+namespace
+{
+    void expectSameRows(const I2::CompressedGraph &actual, const I2::Graph &expected)
+    {
+        ASSERT_EQ(actual.getNodeCount(),expected.getNodeCount());
+        EXPECT_EQ(actual.getEntryCount(),expected.getEntryCount());
+        EXPECT_TRUE(std::ranges::equal(actual.getWeightedDegrees(),expected.getLayout().weightedDegree));
+
+        for(I2::NodeId i=0;i<expected.getNodeCount();++i)
+        {
+            std::vector<I2::NodeId> target;
+            std::vector<std::uint32_t> weight;
+
+            actual.forEachLink(i,[&](I2::NodeId linkedNode, std::uint32_t linkWeight)
+            {
+                target.push_back(linkedNode);
+                weight.push_back(linkWeight);
+            });
+
+            EXPECT_EQ(actual.getLinkCount(i),expected.getLinkCount(i));
+            EXPECT_TRUE(std::ranges::equal(target,expected.getNeighbours(i)));
+            EXPECT_TRUE(std::ranges::equal(weight,expected.getWeights(i)));
+            EXPECT_EQ(actual.getName(i),expected.getName(i));
+        }
+    }
+}
+
+TEST(i2CompressedGraphTest, RowsDecodeToTheGraphRows)
+{
+    const I2::Generator::Options options{.model = I2::Generator::Model::RMAT, .nodeCount = 5000, .linkCount = 40000};
+    const I2::Graph weighted = I2::Generator::generateGraph(options), unweighted = I2::Generator::generateGraph(I2::Generator::Options{.nodeCount = 5000, .linkCount = 40000, .maxWeight = 1});
+
+    const I2::CompressedGraph compressedWeighted(weighted,3), compressedUnweighted(unweighted);
+
+    expectSameRows(compressedWeighted,weighted);
+    expectSameRows(compressedUnweighted,unweighted);
+    EXPECT_EQ(compressedWeighted.getWeightWidth(),1);
+    EXPECT_EQ(compressedUnweighted.getWeightWidth(),0);
+    EXPECT_LT(compressedWeighted.getAdjacencyBytes(),I2::CompressedGraph::getAdjacencyBytes(weighted) / 2);
+    EXPECT_LT(compressedUnweighted.getAdjacencyBytes(),I2::CompressedGraph::getAdjacencyBytes(unweighted) / 3);
+    EXPECT_THROW((void)compressedWeighted.getName(5000),std::out_of_range);
+
+    // Unsorted rows, wide weights and long jumps between IDs round-trip too
+    std::vector<std::shared_ptr<I2::Node>> nodeList;
+
+    for(int i=0;i<300;++i)
+        nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+    nodeList[0]->addLink(nodeList[299],70000);
+    nodeList[0]->addLink(nodeList[5],300);
+    nodeList[0]->addLink(nodeList[150],1);
+    nodeList[200]->addLink(nodeList[7],2);
+
+    const I2::Graph unsorted = I2::Graph::fromNodes(nodeList);
+
+    expectSameRows(I2::CompressedGraph(unsorted),unsorted);
+    EXPECT_EQ(I2::CompressedGraph(unsorted).getWeightWidth(),4);
+    EXPECT_EQ(I2::CompressedGraph().getNodeCount(),0);
+}
+
+TEST(i2CompressedGraphTest, RanksMatchTheUncompressedEngine)
+{
+    const I2::Graph graph = I2::Generator::generateGraph(I2::Generator::Options{.model = I2::Generator::Model::BarabasiAlbert, .nodeCount = 20000, .linkCount = 100000, .maxWeight = 1000});
+
+    I2::PageRankEngine engine(graph), compressedEngine{I2::CompressedGraph(graph)};
+
+    for(const I2::Acceleration acceleration : {I2::Acceleration::None, I2::Acceleration::Extrapolation, I2::Acceleration::GaussSeidel})
+    {
+        const I2::PageRankOptions options{.tolerance = 1e-8, .acceleration = acceleration};
+        const std::vector<double> expectedRank = engine.run(options);
+
+        EXPECT_EQ(compressedEngine.run(options),expectedRank); // Bit-identical
+        EXPECT_EQ(compressedEngine.getIterationCount(),engine.getIterationCount());
+        EXPECT_EQ(compressedEngine.run(I2::PageRankOptions{.tolerance = 1e-8, .threadCount = 3, .acceleration = acceleration}),expectedRank);
+    }
+
+    EXPECT_TRUE(I2::PageRankEngine(I2::CompressedGraph()).run().empty());
+}
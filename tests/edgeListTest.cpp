@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <i2/edgeList.hpp>
+#include <i2/generator.hpp>
+#include <i2/nodeLoader.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    /**
+     * @return A path within the temporary directory, unique to the calling test
+     */
+    std::string edgeListTestPath(const std::string &extension)
+    {
+        return (std::filesystem::temp_directory_path() / (std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) + extension)).string();
+    }
+
+    void writeFile(const std::string &path, const std::string &content)
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+
+        output << content;
+    }
+
+    std::string loadError(const std::string &path, const I2::EdgeList::Options &options)
+    {
+        try
+        {
+            (void)I2::EdgeList::loadText(path,options);
+        }
+        catch(const std::runtime_error &e)
+        {
+            return e.what();
+        }
+
+        return "";
+    }
+
+    void expectSameGraph(const I2::Graph &actual, const I2::Graph &expected)
+    {
+        ASSERT_EQ(actual.getNodeCount(),expected.getNodeCount());
+        ASSERT_EQ(actual.getEntryCount(),expected.getEntryCount());
+
+        for(I2::NodeId i=0;i<actual.getNodeCount();++i)
+        {
+            EXPECT_EQ(actual.getName(i),expected.getName(i));
+            EXPECT_TRUE(std::ranges::equal(actual.getNeighbours(i),expected.getNeighbours(i)));
+            EXPECT_TRUE(std::ranges::equal(actual.getWeights(i),expected.getWeights(i)));
+        }
+    }
+}
+
+TEST(i2EdgeListTest, ChunkedTextMatchesGeneratedGraph)
+{
+    // Large enough to be split into several chunks, with repeated links (the first weight must win whichever chunk it lands in)
+    const I2::Generator::Options options{.model = I2::Generator::Model::RMAT, .nodeCount = 2000, .linkCount = 400000};
+    const std::string path = edgeListTestPath(".csv"), namesPath = edgeListTestPath(".names");
+    std::vector<I2::Generator::Link> link;
+    std::string text = "# generated\r\nsource,target,weight\r\n";
+    std::ofstream names(namesPath, std::ios::binary | std::ios::trunc);
+
+    I2::Generator::writeNames(options,names);
+    names.close();
+
+    for(std::uint64_t block=0;block<I2::Generator::getBlockCount(options);++block)
+    {
+        I2::Generator::generateBlock(options,block,link);
+
+        for(const I2::Generator::Link &l : link)
+            text += std::to_string(l.source) + "," + std::to_string(l.target) + "," + std::to_string(l.weight) + "\r\n";
+    }
+
+    writeFile(path,text);
+
+    const I2::Graph expected = I2::Generator::generateGraph(options);
+
+    for(std::size_t threadCount : {1,4})
+        expectSameGraph(I2::EdgeList::loadText(path,I2::EdgeList::Options{.namesPath = namesPath, .threadCount = threadCount}),expected);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(namesPath);
+}
+
+TEST(i2EdgeListTest, BinaryMatchesGeneratedGraph)
+{
+    const I2::Generator::Options options{.model = I2::Generator::Model::BarabasiAlbert, .nodeCount = 5000, .linkCount = 150000, .selfLinkRatio = 0.01};
+    const std::string path = edgeListTestPath(".bin"), namesPath = edgeListTestPath(".names");
+    std::ofstream output(path, std::ios::binary | std::ios::trunc), names(namesPath, std::ios::binary | std::ios::trunc);
+
+    I2::Generator::writeBinary(options,output);
+    I2::Generator::writeNames(options,names);
+    output.close();
+    names.close();
+
+    EXPECT_EQ(I2::EdgeList::detectFormat(path),I2::EdgeList::Format::Binary);
+    expectSameGraph(I2::EdgeList::loadBinary(path,I2::EdgeList::Options{.namesPath = namesPath, .nodesCanLinkToSelf = true, .threadCount = 3}),I2::Generator::generateGraph(options));
+    EXPECT_THROW((void)I2::EdgeList::loadBinary(path,I2::EdgeList::Options{.namesPath = namesPath}),std::runtime_error); // Self-links are rejected by default
+
+    writeFile(path,std::string(I2::EdgeList::recordSize + 1,'\0'));
+    EXPECT_THROW((void)I2::EdgeList::loadBinary(path),std::runtime_error); // Not a whole number of records
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(namesPath);
+}
+
+TEST(i2EdgeListTest, DelimitersAndDefaultWeight)
+{
+    const std::string path = edgeListTestPath(".tsv");
+    I2::Graph graph;
+
+    for(const std::string &text : {std::string("0\t1\t4\n1\t2\n"),std::string("0  1 4\n\n% comment\n1 2\n"),std::string("a;b;w\n0;1;4\n1;2\n")})
+    {
+        writeFile(path,text);
+        ASSERT_NO_THROW(graph = I2::EdgeList::loadText(path,I2::EdgeList::Options{.delimiter = text.find(';') != std::string::npos ? ';' : '\0'}));
+        ASSERT_EQ(graph.getNodeCount(),3);
+        EXPECT_EQ(graph.getName(2),"2"); // Named by ID without a sidecar
+        EXPECT_EQ(graph.getWeightedDegree(0),4);
+        EXPECT_EQ(graph.getWeightedDegree(1),5); // The second link has the default weight of 1
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(i2EdgeListTest, InvalidLinksMatchJSONValidation)
+{
+    const std::string path = edgeListTestPath(".csv"), namesPath = edgeListTestPath(".names");
+
+    writeFile(namesPath,"Node1\nNode2\nNode3\n");
+
+    writeFile(path,"0,1,1\n1,3,1\n2,x,1\n");
+    EXPECT_EQ(loadError(path,I2::EdgeList::Options{.namesPath = namesPath}),"Invalid link at index '1'."); // Node 3 does not exist: reported before the malformed link
+
+    writeFile(path,"0,1,1\n1,2,1,7\n");
+    EXPECT_EQ(loadError(path,I2::EdgeList::Options{.namesPath = namesPath}),"Invalid link at index '1'."); // Too many fields
+
+    writeFile(path,"0,1,1\n2,2,1\n");
+    EXPECT_EQ(loadError(path,I2::EdgeList::Options{.namesPath = namesPath}),"Invalid link at index '1'."); // Links to self are not allowed by default
+    EXPECT_EQ(loadError(path,I2::EdgeList::Options{.namesPath = namesPath, .nodesCanLinkToSelf = true}),"");
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(namesPath);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <i2/generator.hpp>
+#include <i2/nodeLoader.hpp>
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    std::string generateJSON(const I2::Generator::Options &options)
+    {
+        std::ostringstream output;
+
+        I2::Generator::writeJSON(options,output);
+
+        return output.str();
+    }
+}
+
+TEST(i2GeneratorTest, OutputIsIndependentOfThreadCount)
+{
+    for(I2::Generator::Model model : {I2::Generator::Model::ErdosRenyi,I2::Generator::Model::BarabasiAlbert,I2::Generator::Model::RMAT})
+    {
+        I2::Generator::Options options{.model = model, .nodeCount = 5000, .linkCount = 3 * I2::Generator::blockSize + 17, .seed = 42};
+        const std::string expected = generateJSON(options);
+
+        options.threadCount = 4;
+        EXPECT_EQ(generateJSON(options),expected); // Blocks are generated out of order, but written in order
+
+        options.seed = 43;
+        EXPECT_NE(generateJSON(options),expected);
+    }
+}
+
+TEST(i2GeneratorTest, StreamedJSONMatchesGeneratedGraph)
+{
+    const I2::Generator::Options options{.model = I2::Generator::Model::RMAT, .nodeCount = 3000, .linkCount = 20000, .weightDistribution = I2::Generator::WeightDistribution::PowerLaw, .threadCount = 2};
+    std::istringstream input(generateJSON(options));
+    I2::Graph streamed = I2::NodeLoader::constructGraphFromStream(input), generated = I2::Generator::generateGraph(options);
+
+    ASSERT_EQ(streamed.getNodeCount(),options.nodeCount);
+    ASSERT_EQ(streamed.getEntryCount(),generated.getEntryCount());
+
+    for(I2::NodeId i=0;i<streamed.getNodeCount();++i)
+    {
+        EXPECT_EQ(streamed.getName(i),generated.getName(i));
+        EXPECT_TRUE(std::ranges::equal(streamed.getNeighbours(i),generated.getNeighbours(i)));
+        EXPECT_TRUE(std::ranges::equal(streamed.getWeights(i),generated.getWeights(i)));
+    }
+}
+
+TEST(i2GeneratorTest, LinksRespectOptions)
+{
+    std::vector<I2::Generator::Link> link;
+
+    for(I2::Generator::Model model : {I2::Generator::Model::ErdosRenyi,I2::Generator::Model::BarabasiAlbert,I2::Generator::Model::RMAT})
+    {
+        for(double selfLinkRatio : {0.0,0.25,1.0})
+        {
+            const I2::Generator::Options options{.model = model, .nodeCount = 1000, .linkCount = 10000, .weightDistribution = I2::Generator::WeightDistribution::PowerLaw,
+                .minWeight = 2, .maxWeight = 9, .selfLinkRatio = selfLinkRatio};
+            std::size_t selfLinkCount = 0, lowWeightCount = 0;
+
+            I2::Generator::generateBlock(options,0,link);
+            ASSERT_EQ(link.size(),options.linkCount);
+
+            for(const I2::Generator::Link &l : link)
+            {
+                EXPECT_LT(l.source,options.nodeCount);
+                EXPECT_LT(l.target,options.nodeCount);
+                EXPECT_GE(l.weight,options.minWeight);
+                EXPECT_LE(l.weight,options.maxWeight);
+                selfLinkCount += l.source == l.target;
+                lowWeightCount += l.weight == options.minWeight;
+            }
+
+            EXPECT_NEAR(static_cast<double>(selfLinkCount) / link.size(),selfLinkRatio,0.02);
+            EXPECT_GT(lowWeightCount,link.size() / 4); // Power law weights favour the minimum
+        }
+    }
+}
+
+TEST(i2GeneratorTest, BarabasiAlbertHasHubs)
+{
+    I2::Generator::Options options{.nodeCount = 10000, .linkCount = 40000};
+    I2::Graph uniform, scaleFree;
+    unsigned int uniformMax = 0, scaleFreeMax = 0;
+
+    uniform = I2::Generator::generateGraph(options);
+    options.model = I2::Generator::Model::BarabasiAlbert;
+    scaleFree = I2::Generator::generateGraph(options);
+
+    for(I2::NodeId i=0;i<options.nodeCount;++i)
+    {
+        uniformMax = std::max(uniformMax,uniform.getLinkCount(i));
+        scaleFreeMax = std::max(scaleFreeMax,scaleFree.getLinkCount(i));
+    }
+
+    EXPECT_GT(scaleFreeMax,5 * uniformMax); // Preferential attachment concentrates links on early nodes
+}
+
+TEST(i2GeneratorTest, InvalidOptionsAreRejected)
+{
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.nodeCount = 0}),std::runtime_error);
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.nodeCount = 1}),std::runtime_error); // Could only link to itself
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.minWeight = 5, .maxWeight = 4}),std::runtime_error);
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.selfLinkRatio = 1.5}),std::runtime_error);
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.rmatA = 0.6, .rmatB = 0.3, .rmatC = 0.3}),std::runtime_error);
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.model = I2::Generator::Model::RMAT, .nodeCount = 5, .linkCount = 3, .rmatA = 0.0, .rmatB = 0.0, .rmatC = 0.5}),std::runtime_error);
+    EXPECT_THROW(I2::Generator::validate(I2::Generator::Options{.model = I2::Generator::Model::RMAT, .rmatA = 0.5, .rmatB = 0.0, .rmatC = 0.0}),std::runtime_error);
+    EXPECT_NO_THROW(I2::Generator::validate(I2::Generator::Options{.model = I2::Generator::Model::RMAT, .nodeCount = 4, .rmatA = 0.0, .rmatB = 0.5, .rmatC = 0.0}));
+    EXPECT_NO_THROW(I2::Generator::validate(I2::Generator::Options{.nodeCount = 1, .selfLinkRatio = 1.0}));
+}
+
+TEST(i2GeneratorTest, DegenerateRMATProbabilitiesFallBackToUniform)
+{
+    std::vector<I2::Generator::Link> link;
+
+    // Every draw lands on node 7, outside the graph: each link must still end, on a uniformly drawn node
+    for(double selfLinkRatio : {0.0,1.0})
+    {
+        const I2::Generator::Options options{.model = I2::Generator::Model::RMAT, .nodeCount = 5, .linkCount = 3, .selfLinkRatio = selfLinkRatio, .rmatA = 0.0, .rmatB = 0.0, .rmatC = 0.5};
+
+        I2::Generator::generateBlock(options,0,link);
+        ASSERT_EQ(link.size(),options.linkCount);
+
+        for(const I2::Generator::Link &l : link)
+        {
+            EXPECT_LT(l.source,options.nodeCount);
+            EXPECT_LT(l.target,options.nodeCount);
+            EXPECT_EQ(l.source == l.target,selfLinkRatio == 1.0);
+        }
+    }
+}
@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include <i2/nodeLoader.hpp>
+#include <i2/io.hpp>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+// Consts used in multiple test functions
+const std::string GRAPH_DATA_PATH = "../resources/data.json";
+
+TEST(i2GraphTest, WeightedDegreesMatchNodeApi)
+{
+    I2::Graph graph;
+    std::vector<std::shared_ptr<I2::Node>> nodeList;
+
+    EXPECT_NO_THROW(graph = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH)); // Should load fine without issues
+    EXPECT_NO_THROW(nodeList = I2::NodeLoader::loadNodesFromFile(GRAPH_DATA_PATH));
+    ASSERT_EQ(graph.getNodeCount(),nodeList.size());
+
+    for(I2::NodeId i=0;i<graph.getNodeCount();++i)
+    { // Node IDs follow the order of the JSON 'nodes' array, as does the node list
+        EXPECT_EQ(graph.getName(i),nodeList[i]->getName());
+        EXPECT_EQ(graph.getWeightedDegree(i),nodeList[i]->getWeightedDegree());
+        EXPECT_EQ(graph.getLinkCount(i),nodeList[i]->getLinkCount());
+    }
+}
+
+TEST(i2GraphTest, PageRankMatchesNodeApi)
+{
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH);
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> expectedRank = I2::NodeLoader::computePageRank(I2::NodeLoader::loadNodesFromFile(GRAPH_DATA_PATH));
+    std::vector<double> pageRank = I2::NodeLoader::computePageRank(graph);
+
+    ASSERT_EQ(pageRank.size(),expectedRank.size());
+
+    // Compare by name, as the node list result is unordered
+    for(I2::NodeId i=0;i<graph.getNodeCount();++i)
+    {
+        const auto itRank = std::find_if(expectedRank.cbegin(),expectedRank.cend(),[&](const auto &r) { return r.first->getName() == graph.getName(i); });
+
+        ASSERT_NE(itRank,expectedRank.cend());
+        EXPECT_DOUBLE_EQ(pageRank[i],itRank->second);
+    }
+}
+
+TEST(i2GraphTest, DuplicateLinkKeepsFirstWeight)
+{
+    I2::GraphBuilder builder;
+    I2::Graph graph;
+
+    const I2::NodeId node1 = builder.addNode("Node1"), node2 = builder.addNode("Node2");
+
+    builder.addLink(node1,node2,2);
+    builder.addLink(node2,node1,5); // The same undirected link: should be ignored, as with Node::addLink
+
+    graph = builder.build();
+
+    EXPECT_EQ(graph.getLinkCount(node1),1);
+    EXPECT_EQ(graph.getLinkCount(node2),1);
+    EXPECT_EQ(graph.getWeightedDegree(node1),2);
+    EXPECT_EQ(graph.getWeightedDegree(node2),2);
+}
+
+TEST(i2GraphTest, ErrorIsThrownWhenBuildingInvalidLink)
+{
+    I2::GraphBuilder builder;
+    std::string error = "";
+
+    builder.addNode("Node1");
+    builder.addNode("Node2");
+    builder.addLink(0,1,1);
+    builder.addLink(1,2,1); // Node 2 does not exist
+
+    try
+    {
+        (void)builder.build();
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Invalid link at index '1'."); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+}
+
+TEST(i2GraphTest, StreamedGraphMatchesDocumentGraph)
+{
+    Json::Value data;
+    I2::Graph streamed, document;
+
+    ASSERT_TRUE(I2::IO::loadJSONFromFile(GRAPH_DATA_PATH,data));
+    EXPECT_NO_THROW(document = I2::NodeLoader::constructGraphFromJSON(data));
+    EXPECT_NO_THROW(streamed = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH)); // Streams the file rather than building a Json::Value
+    ASSERT_EQ(streamed.getNodeCount(),document.getNodeCount());
+    ASSERT_EQ(streamed.getEntryCount(),document.getEntryCount());
+
+    for(I2::NodeId i=0;i<streamed.getNodeCount();++i)
+    {
+        EXPECT_EQ(streamed.getName(i),document.getName(i));
+        EXPECT_EQ(streamed.getWeightedDegree(i),document.getWeightedDegree(i));
+        EXPECT_TRUE(std::ranges::equal(streamed.getNeighbours(i),document.getNeighbours(i)));
+    }
+}
+
+TEST(i2GraphTest, StreamReportsLowestInvalidLinkIndex)
+{
+    // Link 1 references a missing node and link 2 is malformed: the links precede the nodes, so link 1 can only be rejected once the nodes are known
+    std::istringstream input(R"({"links":[{"source":0,"target":1,"value":1},{"source":0,"target":5,"value":1},{"source":"0","target":1,"value":1}],)"
+                             R"("nodes":[{"name":"Node1"},{"name":"Node2"}]})");
+    std::string error = "";
+
+    try
+    {
+        (void)I2::NodeLoader::constructGraphFromStream(input);
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Invalid link at index '1'."); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+}
+
+TEST(i2GraphTest, StreamDecodesEscapedNames)
+{
+    std::istringstream input(R"({"nodes":[{"name":"Caf\u00e9 \"Musain\"","extra":[1,{"name":2}]}],"links":[]})");
+    I2::Graph graph;
+
+    EXPECT_NO_THROW(graph = I2::NodeLoader::constructGraphFromStream(input));
+    ASSERT_EQ(graph.getNodeCount(),1);
+    EXPECT_EQ(graph.getName(0),"Caf\xC3\xA9 \"Musain\"");
+}
+
+TEST(i2GraphTest, TopNodesMatchFullSort)
+{
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH);
+    std::vector<double> pageRank = I2::NodeLoader::computePageRank(graph);
+    std::vector<I2::NodeId> degreeOrder(graph.getNodeCount()), rankOrder;
+
+    // The full orders: stable, so ties (data.json has many) keep their NodeId order
+    std::iota(degreeOrder.begin(),degreeOrder.end(),0);
+    rankOrder = degreeOrder;
+    std::stable_sort(degreeOrder.begin(),degreeOrder.end(),[&graph](I2::NodeId a, I2::NodeId b) { return graph.getWeightedDegree(a) > graph.getWeightedDegree(b); });
+    std::stable_sort(rankOrder.begin(),rankOrder.end(),[&pageRank](I2::NodeId a, I2::NodeId b) { return pageRank[a] > pageRank[b]; });
+
+    EXPECT_EQ(I2::NodeLoader::topNodesByWeightedDegree(graph,0),degreeOrder);
+    EXPECT_EQ(I2::NodeLoader::topNodesByRank(pageRank,0),rankOrder);
+
+    for(std::size_t count : {1,5,42,43,44,76,77,1000})
+    {
+        const std::size_t expectedCount = std::min<std::size_t>(count,graph.getNodeCount());
+
+        EXPECT_EQ(I2::NodeLoader::topNodesByWeightedDegree(graph,count),std::vector<I2::NodeId>(degreeOrder.cbegin(),degreeOrder.cbegin() + expectedCount));
+        EXPECT_EQ(I2::NodeLoader::topNodesByRank(pageRank,count),std::vector<I2::NodeId>(rankOrder.cbegin(),rankOrder.cbegin() + expectedCount));
+    }
+}
+
+TEST(i2GraphTest, DuplicatePolicyResolvesRepeatedLinks)
+{
+    const std::vector<std::pair<I2::DuplicatePolicy,unsigned int>> expectedWeight = {{I2::DuplicatePolicy::KeepFirst,2},{I2::DuplicatePolicy::SumWeights,10},{I2::DuplicatePolicy::MaxWeight,5}};
+
+    for(const auto &[policy,weight] : expectedWeight)
+    {
+        I2::GraphBuilder builder(true,policy);
+        I2::Graph graph;
+
+        const I2::NodeId node1 = builder.addNode("Node1"), node2 = builder.addNode("Node2");
+
+        builder.addLink(node1,node2,2);
+        builder.addLink(node2,node1,5); // The same undirected link, received in the other direction
+        builder.addLink(node1,node2,3);
+        builder.addLink(node2,node2,4);
+        builder.addLink(node2,node2,1); // A repeated self-link
+
+        EXPECT_NO_THROW(graph = builder.build());
+        ASSERT_EQ(graph.getLinkCount(node1),1);
+        ASSERT_EQ(graph.getLinkCount(node2),2);
+        EXPECT_EQ(graph.getWeights(node1)[0],weight);
+        EXPECT_EQ(graph.getWeights(node2)[0],weight); // Rows are ordered by target: node1 then node2
+        EXPECT_EQ(graph.getWeights(node2)[1],policy == I2::DuplicatePolicy::SumWeights ? 5u : 4u);
+    }
+}
+
+TEST(i2GraphTest, ErrorIsThrownWhenRejectingDuplicateLink)
+{
+    I2::GraphBuilder builder(false,I2::DuplicatePolicy::Reject);
+    std::string error = "";
+
+    builder.addNode("Node1");
+    builder.addNode("Node2");
+    builder.addNode("Node3");
+    builder.addLink(0,1,1);
+    builder.addLink(1,2,1);
+    builder.addLink(2,1,1); // Repeats link 1
+    builder.addLink(1,0,1); // Repeats link 0, but comes later
+
+    try
+    {
+        (void)builder.build(4);
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Duplicate link at index '2'."); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+}
+
+TEST(i2GraphTest, ParallelBuildMatchesSingleThreadBuild)
+{
+    constexpr I2::NodeId nodeCount = 500;
+    I2::Graph graph[2];
+
+    for(std::size_t i=0;i<2;++i)
+    {
+        I2::GraphBuilder builder(false,I2::DuplicatePolicy::SumWeights);
+        std::uint64_t state = 42;
+
+        for(I2::NodeId id=0;id<nodeCount;++id)
+            builder.addNode("Node" + std::to_string(id));
+
+        for(std::size_t link=0;link<200000;++link)
+        { // Dense enough that most links are repeated several times, in both directions
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            const I2::NodeId source = static_cast<I2::NodeId>((state >> 33) % nodeCount), target = static_cast<I2::NodeId>((state >> 13) % nodeCount);
+
+            if(source != target)
+                builder.addLink(source,target,static_cast<unsigned int>(link % 7) + 1);
+        }
+
+        graph[i] = builder.build(i == 0 ? 1 : 4);
+    }
+
+    ASSERT_EQ(graph[0].getEntryCount(),graph[1].getEntryCount());
+
+    for(I2::NodeId id=0;id<nodeCount;++id)
+    {
+        EXPECT_TRUE(std::ranges::equal(graph[0].getNeighbours(id),graph[1].getNeighbours(id)));
+        EXPECT_TRUE(std::ranges::equal(graph[0].getWeights(id),graph[1].getWeights(id)));
+        EXPECT_EQ(graph[0].getWeightedDegree(id),graph[1].getWeightedDegree(id));
+    }
+}
+
+TEST(i2GraphTest, ThreadedFileLoadMatchesSingleThreadLoad)
+{
+    const I2::Graph expected = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH);
+    const I2::Graph graph = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH,false,I2::DuplicatePolicy::KeepFirst,4);
+
+    ASSERT_EQ(graph.getNodeCount(),expected.getNodeCount());
+    ASSERT_EQ(graph.getEntryCount(),expected.getEntryCount());
+
+    for(I2::NodeId id=0;id<graph.getNodeCount();++id)
+    {
+        EXPECT_EQ(graph.getName(id),expected.getName(id));
+        EXPECT_TRUE(std::ranges::equal(graph.getNeighbours(id),expected.getNeighbours(id)));
+        EXPECT_TRUE(std::ranges::equal(graph.getWeights(id),expected.getWeights(id)));
+    }
+}
+
+TEST(i2GraphTest, NamePoolFindsFirstOfEachName)
+{
+    I2::NamePool pool;
+
+    for(std::size_t i=0;i<1000;++i) // Enough names to grow the index several times
+        EXPECT_EQ(pool.add("Node" + std::to_string(i)),i);
+
+    EXPECT_EQ(pool.add("Node7"),1000); // A repeated name still receives its own ID
+    ASSERT_EQ(pool.size(),1001);
+
+    for(std::size_t i=0;i<1000;++i)
+    {
+        EXPECT_EQ(pool.get(static_cast<I2::NodeId>(i)),"Node" + std::to_string(i));
+        EXPECT_EQ(pool.find("Node" + std::to_string(i)),i);
+    }
+
+    EXPECT_EQ(pool.get(1000),"Node7");
+    EXPECT_FALSE(pool.find("Node1000"));
+    EXPECT_FALSE(pool.find(""));
+}
+
+TEST(i2GraphTest, FindNodeMatchesNames)
+{
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(GRAPH_DATA_PATH), copy;
+
+    for(I2::NodeId i=0;i<graph.getNodeCount();++i)
+        EXPECT_EQ(graph.findNode(graph.getName(i)),i);
+
+    EXPECT_EQ(graph.findNode("Valjean"),11);
+    EXPECT_FALSE(graph.findNode("Valjea"));
+    EXPECT_FALSE(I2::Graph().findNode("Valjean"));
+
+    copy = graph; // Copies share the index along with the arrays
+    graph = I2::Graph();
+    EXPECT_EQ(copy.findNode("Valjean"),11);
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include <i2/nodeLoader.hpp>
+#include <i2/graphDelta.hpp>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory_resource>
+#include <thread>
 
 // Consts used in multiple test functions
 const std::string ERROR_INVALID_NODE = "Error: Invalid node.";
@@ -161,6 +166,50 @@ TEST(i2GroupUnitTest, NodeWeightedDegreeIsAccurateWhenCopied)
         EXPECT_EQ(nodeList[i]->getWeightedDegree(),EXPECTED_WEIGHT[i]);
 }
 
+/**
+ * @brief Counts the bytes requested of it, passing every request on to the heap.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocatedBytes = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        allocatedBytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes,alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p,bytes,alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(i2GroupUnitTest, NodesAreAllocatedFromArena)
+{
+    CountingResource upstream;
+    std::pmr::monotonic_buffer_resource arena(&upstream); // Declared before the nodes, so it outlives them
+    std::vector<std::shared_ptr<I2::Node>> expected = I2::NodeLoader::loadNodesFromFile(DATA_PATH), nodeList;
+
+    EXPECT_NO_THROW(nodeList = I2::NodeLoader::loadNodesFromFile(DATA_PATH,false,&arena));
+    ASSERT_EQ(nodeList.size(),expected.size());
+    EXPECT_GT(upstream.allocatedBytes,nodeList.size() * sizeof(I2::Node)); // The nodes, their names and their links all came from the arena
+
+    for(std::size_t i=0;i<nodeList.size();++i)
+    {
+        EXPECT_EQ(nodeList[i]->getName(),expected[i]->getName());
+        EXPECT_EQ(nodeList[i]->getWeightedDegree(),expected[i]->getWeightedDegree());
+        EXPECT_EQ(nodeList[i]->getLinkCount(),expected[i]->getLinkCount());
+    }
+}
+
 TEST(i2GroupUnitTest, LinkIsRemovedSuccessfully)
 {
     // Ensure link was successfully removed: ensure getLinkCount == previousLinkCount - 1, and ensure new weighted degree is as expected
@@ -225,6 +274,243 @@ TEST(i2GroupUnitTest, AddingDuplicateLinkFails)
     EXPECT_EQ(node1->getLinkCount(),expectedLinkCount); // Ensure the link count remains the same
 }
 
+TEST(i2GroupUnitTest, ForEachLinkSeesConsistentLinksDuringWrites)
+{
+    constexpr unsigned int linkCount = 2000;
+
+    std::shared_ptr<I2::Node> hub = std::make_shared<I2::Node>("Hub");
+    std::vector<std::shared_ptr<I2::Node>> nodeList;
+
+    for(unsigned int i=0;i<linkCount;++i)
+        nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+    std::thread writer([&]() {
+        for(unsigned int i=0;i<linkCount;++i)
+            hub->addLink(nodeList[i],i + 1);
+    });
+
+    unsigned int visitedCount = 0;
+
+    while(visitedCount < linkCount)
+    {
+        unsigned int count = 0, weightSum = 0, expectedSum = 0;
+
+        hub->forEachLink([&](const std::shared_ptr<I2::Node> &, unsigned int weight) {
+            ++count;
+            weightSum += weight;
+        });
+
+        // The links are added in weight order, so a consistent visit holds exactly the weights 1..count
+        for(unsigned int w=1;w<=count;++w)
+            expectedSum += w;
+
+        ASSERT_EQ(weightSum,expectedSum);
+        ASSERT_GE(count,visitedCount); // Links are only ever added
+        visitedCount = count;
+    }
+
+    writer.join();
+    EXPECT_EQ(hub->getWeightedDegree(),linkCount * (linkCount + 1) / 2);
+}
+
+TEST(i2GroupUnitTest, GraphDeltaAppliesBatchToBothEnds)
+{
+    std::shared_ptr<I2::Node> node1 = std::make_shared<I2::Node>("Node1"), node2 = std::make_shared<I2::Node>("Node2"), node3 = std::make_shared<I2::Node>("Node3");
+    I2::GraphDelta delta;
+
+    node1->addLink(node2,4);
+    node2->addLink(node1,4);
+
+    delta.addLink(node1,node3,2);
+    delta.addLink(node3,node1,9); // Already staged: keeps the first weight
+    delta.updateLink(node1,node2,6);
+    delta.removeLink(node2,node3); // Never linked: ignored
+    delta.addLink(node2,node3,1);
+    EXPECT_EQ(delta.size(),5);
+    EXPECT_EQ(delta.apply(),6); // 1-3 and 2-3 in both directions, plus the update of 1-2 in both directions
+    EXPECT_EQ(delta.size(),0);
+
+    EXPECT_EQ(node1->getWeightedDegree(),8);
+    EXPECT_EQ(node2->getWeightedDegree(),7);
+    EXPECT_EQ(node3->getWeightedDegree(),3);
+    EXPECT_EQ(node3->getLinks().at(node1),2);
+
+    delta.removeLink(node3,node1);
+    delta.removeLink(node1,node2);
+    EXPECT_EQ(delta.apply(),4);
+
+    EXPECT_EQ(node1->getLinkCount(),0);
+    EXPECT_EQ(node1->getWeightedDegree(),0);
+    EXPECT_EQ(node2->getWeightedDegree(),1);
+    EXPECT_EQ(node3->getWeightedDegree(),1);
+    EXPECT_THROW(delta.addLink(node1,nullptr,1),std::runtime_error);
+}
+
+TEST(i2GroupUnitTest, GraphDeltaKeepsNodesAliveWhileNotifying)
+{
+    // Counts the removals reported for a node, which may be destroyed once they are delivered
+    struct RemovalCounter : public I2::LinkObserver
+    {
+        std::string name;
+        unsigned int count = 0;
+
+        void onLinkAdded(I2::Node &, const std::shared_ptr<I2::Node> &, unsigned int) override
+        {
+        }
+
+        void onLinkRemoved(I2::Node &node, const std::shared_ptr<I2::Node> &, unsigned int) override
+        {
+            name = node.getName(); // Reads the node, which must still be alive
+            ++count;
+        }
+    } counter;
+
+    std::shared_ptr<I2::Node> node1 = std::make_shared<I2::Node>("Node1"), node2 = std::make_shared<I2::Node>("Node2");
+    const std::weak_ptr<I2::Node> watch = node1;
+    I2::GraphDelta delta;
+
+    node1->addLink(node2,1);
+    node2->addLink(node1,1);
+    node1->subscribe(&counter);
+    delta.removeLink(node1,node2);
+    node1.reset(); // Only the delta and node2's link now own node1
+
+    EXPECT_EQ(delta.apply(),2);
+    EXPECT_EQ(counter.count,1);
+    EXPECT_EQ(counter.name,"Node1");
+    EXPECT_TRUE(watch.expired()); // Released once its notification was delivered
+    EXPECT_EQ(delta.size(),0);
+}
+
+TEST(i2GroupUnitTest, ConcurrentGraphDeltasDoNotDeadlock)
+{
+    constexpr std::size_t nodeCount = 64, threadCount = 8, roundCount = 200;
+
+    std::vector<std::shared_ptr<I2::Node>> nodeList;
+    std::vector<std::thread> thread;
+
+    for(std::size_t i=0;i<nodeCount;++i)
+        nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+    for(std::size_t t=0;t<threadCount;++t)
+    {
+        thread.emplace_back([&,t]() {
+            for(std::size_t round=0;round<roundCount;++round)
+            {
+                I2::GraphDelta delta;
+
+                // Every thread touches every node, in a different order, so the batches overlap heavily
+                for(std::size_t i=0;i<nodeCount;++i)
+                    delta.addLink(nodeList[(i * (t + 1) + round) % nodeCount],nodeList[(i * (t + 1) + round + t + 1) % nodeCount],1);
+
+                delta.apply();
+            }
+        });
+    }
+
+    for(std::thread &t : thread)
+        t.join();
+
+    // Every link is held in both directions, and each weighted degree matches its links
+    for(const std::shared_ptr<I2::Node> &node : nodeList)
+    {
+        unsigned int weightedDegree = 0;
+
+        node->forEachLink([&](const std::shared_ptr<I2::Node> &link, unsigned int weight) {
+            EXPECT_EQ(link->getLinks().count(node),1);
+            weightedDegree += weight;
+        });
+
+        EXPECT_EQ(node->getWeightedDegree(),weightedDegree);
+    }
+}
+
+namespace
+{
+    /**
+     * @brief Checks that no notification reaches it once it has been destroyed
+     */
+    class CheckedObserver : public I2::LinkObserver
+    {
+    private:
+        std::shared_ptr<I2::Node> _node;
+        std::atomic<unsigned int> &_notificationCount;
+        std::atomic<bool> _alive = true;
+
+        void check(void)
+        {
+            ++this->_notificationCount;
+            std::this_thread::sleep_for(std::chrono::microseconds(50)); // Widen the window for the destructor to race the notification
+            EXPECT_TRUE(this->_alive.load());
+        }
+
+    public:
+        CheckedObserver(std::shared_ptr<I2::Node> node, std::atomic<unsigned int> &notificationCount) : _node(std::move(node)), _notificationCount(notificationCount)
+        {
+            this->_node->subscribe(this);
+        }
+
+        ~CheckedObserver(void) override
+        {
+            this->_node->unsubscribe(this);
+            this->_alive = false;
+        }
+
+        void onLinkAdded(I2::Node &, const std::shared_ptr<I2::Node> &, unsigned int) override
+        {
+            this->check();
+        }
+
+        void onLinkRemoved(I2::Node &, const std::shared_ptr<I2::Node> &, unsigned int) override
+        {
+            this->check();
+        }
+    };
+}
+
+TEST(i2GroupUnitTest, ObserversCanBeDestroyedWhileNodesChange)
+{
+    constexpr unsigned int roundCount = 200;
+
+    std::shared_ptr<I2::Node> hub = std::make_shared<I2::Node>("Hub"), leaf = std::make_shared<I2::Node>("Leaf"), other = std::make_shared<I2::Node>("Other");
+    std::atomic<bool> isDone = false;
+    std::atomic<unsigned int> notificationCount = 0;
+
+    // Edit the hub through both Node and GraphDelta while observers come and go
+    std::thread writer([&]() {
+        while(!isDone)
+        {
+            hub->addLink(leaf,1);
+            hub->removeLink(leaf);
+
+            I2::GraphDelta delta;
+
+            delta.addLink(hub,other,2);
+            delta.apply();
+            delta.removeLink(hub,other);
+            delta.apply();
+        }
+    });
+
+    for(unsigned int round=0;round<roundCount;++round)
+    {
+        {
+            CheckedObserver observer1(hub,notificationCount), observer2(hub,notificationCount);
+
+            // Destroy the observers once notifications are reaching them, so a destructor is likely to run during one
+            for(const unsigned int seen=notificationCount;notificationCount==seen;)
+                std::this_thread::yield();
+        }
+
+        I2::IncrementalPageRank ranking({hub,leaf,other});
+
+        EXPECT_EQ(ranking.getRanks().size(),3);
+    }
+
+    isDone = true;
+    writer.join();
+}
+
 TEST(i2GroupUnitTest, PageRankIsComputedAccurately)
 {
     const std::vector<double> expectedPageRank = {1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,1000.0,952.29049010436199,868.28242387053172,661.11305916305912,486.29723171565269,452.74087579087569,441.90544078097997,425.00194805194803,338.07012987012985,244.446907539867,231.8201298701299,228.15851370851368,198.70324675324676,198.10800865800866,170.00194805194806,169.9347269716194,169.57868810484649,166.16736158578263,136.94639249639252,121.43051948051948,120.96055910039254,97.224170274170277,85.001948051948048,85.001948051948048,85.001948051948048,85.001948051948048,85.001948051948048,85.001948051948048,53.126948051948055,51.405450022957972,23.613059163059162,23.613059163059162,23.613059163059162,23.613059163059162,23.613059163059162};
@@ -246,6 +532,27 @@ TEST(i2GroupUnitTest, PageRankIsComputedAccurately)
         EXPECT_DOUBLE_EQ(pageRank[i].second,expectedPageRank[i]); // Ensure each rank matches the expected rank
 }
 
+TEST(i2GroupUnitTest, TopPageRanksMatchSortedRanks)
+{
+    std::vector<std::shared_ptr<I2::Node>> nodeList = I2::NodeLoader::loadNodesFromFile(DATA_PATH);
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> pageRank = I2::NodeLoader::computePageRank(nodeList), topRank;
+    std::vector<std::shared_ptr<I2::Node>> topNode;
+
+    topRank = I2::NodeLoader::topPageRanks(pageRank,50); // Selected before sorting, as the input is unsorted
+    topNode = I2::NodeLoader::topNodes(nodeList,10);
+    std::stable_sort(pageRank.begin(),pageRank.end(),I2::NodeLoader::pageRankComparatorGT); // Sort the rankings, descending
+    std::stable_sort(nodeList.begin(),nodeList.end(),I2::nodeCompareGT);
+
+    ASSERT_EQ(topRank.size(),50);
+    ASSERT_EQ(topNode.size(),10);
+
+    for(int i=0;i<50;++i)
+        EXPECT_EQ(topRank[i],pageRank[i]); // Same node and rank, including the order of tied ranks
+
+    for(int i=0;i<10;++i)
+        EXPECT_EQ(topNode[i],nodeList[i]);
+}
+
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
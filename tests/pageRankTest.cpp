@@ -0,0 +1,419 @@
+#include <gtest/gtest.h>
+#include <i2/generator.hpp>
+#include <i2/graphDelta.hpp>
+#include <i2/nodeLoader.hpp>
+#include <i2/pageRank.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+// Consts used in multiple test functions
+const std::string RANK_DATA_PATH = "../resources/data.json";
+
+TEST(i2PageRankTest, EngineRunsAreRepeatable)
+{
+    I2::PageRankEngine engine(I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH));
+    std::vector<double> firstRun;
+    std::size_t firstIterationCount = 0;
+
+    firstRun = engine.run(); // Copy, as the engine's buffers are re-used by the next run
+    firstIterationCount = engine.getIterationCount();
+
+    EXPECT_GT(firstIterationCount,0);
+    EXPECT_EQ(engine.run(),firstRun); // Each run restarts from an equal distribution of rank, so must reproduce the same result
+    EXPECT_EQ(engine.getIterationCount(),firstIterationCount);
+}
+
+TEST(i2PageRankTest, ResidualHistoryFollowsEachIteration)
+{
+    I2::PageRankEngine engine(I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH));
+    const I2::PageRankOptions options{.tolerance = 1e-6, .recordResiduals = true};
+
+    engine.run(options);
+
+    const std::vector<I2::Kernels::Residual> &history = engine.getResidualHistory();
+
+    ASSERT_EQ(history.size(),engine.getIterationCount());
+    EXPECT_EQ(history.back().lInf,engine.getResidual().lInf);
+    EXPECT_LE(history.back().lInf,options.tolerance);
+    EXPECT_GT(history.front().lInf,options.tolerance);
+
+    engine.run(); // Not recorded by default
+    EXPECT_TRUE(engine.getResidualHistory().empty());
+}
+
+TEST(i2PageRankTest, NodeListRanksFollowNodeListOrder)
+{
+    std::vector<std::shared_ptr<I2::Node>> nodeList = I2::NodeLoader::loadNodesFromFile(RANK_DATA_PATH);
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> pageRank = I2::NodeLoader::computePageRank(nodeList);
+    std::vector<double> graphRank = I2::NodeLoader::computePageRank(I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH));
+
+    ASSERT_EQ(pageRank.size(),nodeList.size());
+
+    for(std::size_t i=0;i<nodeList.size();++i)
+    { // The shared_ptr overload runs the same dense engine, so each node keeps its list position and its rank
+        EXPECT_EQ(pageRank[i].first,nodeList[i]);
+        EXPECT_DOUBLE_EQ(pageRank[i].second,graphRank[i]);
+    }
+}
+
+TEST(i2PageRankTest, OneWayLinksAreRankedAsLinked)
+{
+    // Node API links are directional: only node1 lists node2, so only node1 gathers rank from node2
+    std::shared_ptr<I2::Node> node1 = std::make_shared<I2::Node>("Node1"), node2 = std::make_shared<I2::Node>("Node2");
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> pageRank;
+
+    node1->addLink(node2,1);
+    pageRank = I2::NodeLoader::computePageRank({node1,node2},0.85,1e-9);
+
+    ASSERT_EQ(pageRank.size(),2);
+    EXPECT_DOUBLE_EQ(pageRank[1].second,0.15 / 2.0); // Teleport only
+    EXPECT_DOUBLE_EQ(pageRank[0].second,0.15 / 2.0 + 0.85 * pageRank[1].second);
+}
+
+TEST(i2PageRankTest, ThreadedRanksMatchSingleThreaded)
+{
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH);
+    std::vector<double> expectedRank = I2::NodeLoader::computePageRank(graph,I2::PageRankOptions{.tolerance = 1e-6});
+
+    for(std::size_t threadCount : {2,3,8})
+    {
+        for(int run=0;run<3;++run) // Repeat to shake out any scheduling dependence
+            EXPECT_EQ(I2::NodeLoader::computePageRank(graph,I2::PageRankOptions{.tolerance = 1e-6, .threadCount = threadCount}),expectedRank); // Bit-identical, not just close
+    }
+}
+
+TEST(i2PageRankTest, StoppingRulesAndIterationLimit)
+{
+    I2::PageRankEngine engine(I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH));
+    std::size_t maxNormIterationCount = 0;
+
+    engine.run(I2::PageRankOptions{.tolerance = 1e-6});
+    maxNormIterationCount = engine.getIterationCount();
+    EXPECT_TRUE(engine.hasConverged());
+
+    engine.run(I2::PageRankOptions{.tolerance = 1e-6, .stoppingRule = I2::StoppingRule::L1});
+    EXPECT_TRUE(engine.hasConverged());
+    EXPECT_LE(engine.getResidual().l1,1e-6);
+    EXPECT_GE(engine.getIterationCount(),maxNormIterationCount); // The l1 norm is never below the max norm
+
+    engine.run(I2::PageRankOptions{.tolerance = 1e-6, .maxIterations = 3});
+    EXPECT_EQ(engine.getIterationCount(),3);
+    EXPECT_FALSE(engine.hasConverged());
+}
+
+TEST(i2PageRankTest, AcceleratedRanksMatchPlainRanks)
+{
+    I2::PageRankEngine engine(I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH));
+    const std::vector<double> expectedRank = engine.run(I2::PageRankOptions{.tolerance = 1e-10});
+    const std::size_t plainIterationCount = engine.getIterationCount();
+
+    for(const I2::Acceleration acceleration : {I2::Acceleration::Extrapolation, I2::Acceleration::GaussSeidel})
+    {
+        const std::vector<double> &rank = engine.run(I2::PageRankOptions{.tolerance = 1e-10, .acceleration = acceleration});
+
+        EXPECT_TRUE(engine.hasConverged());
+        EXPECT_LE(engine.getIterationCount(),plainIterationCount);
+
+        for(std::size_t i=0;i<rank.size();++i)
+            EXPECT_NEAR(rank[i],expectedRank[i],1e-7) << "Node " << i;
+    }
+
+    EXPECT_LT(engine.getIterationCount(),plainIterationCount * 3 / 4); // Gauss-Seidel, as the sample graph fits within one chunk
+}
+
+TEST(i2PageRankTest, AcceleratedRanksMatchAcrossThreadCounts)
+{
+    // Large enough to span many chunks, so chunks are swept (and extrapolated) by different threads
+    const I2::Graph graph = I2::Generator::generateGraph(I2::Generator::Options{.model = I2::Generator::Model::BarabasiAlbert, .nodeCount = 20000, .linkCount = 100000});
+
+    for(const I2::Acceleration acceleration : {I2::Acceleration::Extrapolation, I2::Acceleration::GaussSeidel})
+    {
+        const std::vector<double> expectedRank = I2::NodeLoader::computePageRank(graph,I2::PageRankOptions{.tolerance = 1e-8, .acceleration = acceleration});
+
+        EXPECT_EQ(I2::NodeLoader::computePageRank(graph,I2::PageRankOptions{.tolerance = 1e-8, .threadCount = 3, .acceleration = acceleration}),expectedRank); // Bit-identical
+    }
+}
+
+TEST(i2PageRankTest, SavedRanksWarmStartTheNextRun)
+{
+    const std::string rankPath = (std::filesystem::temp_directory_path() / "SavedRanksWarmStartTheNextRun.tsv").string();
+    const I2::Graph graph = I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH);
+    I2::PageRankEngine engine(graph);
+    I2::GraphBuilder builder;
+    const std::vector<double> savedRank = engine.run(I2::PageRankOptions{.tolerance = 1e-8});
+
+    I2::NodeLoader::saveRanksToFile(graph,savedRank,rankPath);
+
+    EXPECT_EQ(I2::NodeLoader::loadRanksFromFile(graph,rankPath),savedRank); // Saved exactly
+    engine.run(I2::PageRankOptions{.tolerance = 1e-8},I2::NodeLoader::loadRanksFromFile(graph,rankPath));
+    EXPECT_EQ(engine.getIterationCount(),1);
+
+    // A later graph, with a new node and without the first: ranks follow the names, and the new node starts from the mean
+    for(I2::NodeId i=1;i<graph.getNodeCount();++i)
+        builder.addNode(graph.getName(i));
+
+    builder.addNode("Added");
+
+    const I2::Graph laterGraph = builder.build();
+    const std::vector<double> warmRank = I2::NodeLoader::loadRanksFromFile(laterGraph,rankPath);
+    double meanRank = 0.0;
+
+    for(I2::NodeId i=1;i<graph.getNodeCount();++i)
+    {
+        EXPECT_EQ(warmRank[i - 1],savedRank[i]);
+        meanRank += savedRank[i] / static_cast<double>(graph.getNodeCount() - 1);
+    }
+
+    EXPECT_NEAR(warmRank.back(),meanRank,1e-9);
+
+    std::ofstream(rankPath,std::ofstream::app) << "Broken line\n";
+    EXPECT_THROW((void)I2::NodeLoader::loadRanksFromFile(graph,rankPath),std::runtime_error);
+    std::filesystem::remove(rankPath);
+}
+
+TEST(i2PageRankTest, IncrementalRanksMatchFullRecompute)
+{
+    std::vector<std::shared_ptr<I2::Node>> nodeList = I2::NodeLoader::loadNodesFromFile(RANK_DATA_PATH);
+    I2::IncrementalPageRank ranking(nodeList,I2::PageRankOptions{.tolerance = 1e-6});
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> expectedRank, pageRank;
+
+    // Link two nodes (in both directions, as the loader does) and unlink one of the first node's neighbours
+    nodeList[0]->addLink(nodeList[5],3);
+    nodeList[5]->addLink(nodeList[0],3);
+
+    std::shared_ptr<I2::Node> unlinked = nodeList[1]->getLinks().begin()->first;
+
+    nodeList[1]->removeLink(unlinked);
+    unlinked->removeLink(nodeList[1]);
+
+    EXPECT_GT(ranking.getPendingCount(),0);
+    EXPECT_GT(ranking.update(),0);
+    EXPECT_EQ(ranking.getPendingCount(),0);
+    EXPECT_EQ(ranking.update(),0); // Nothing changed since
+
+    expectedRank = I2::NodeLoader::computePageRank(nodeList,0.85,1e-6);
+    pageRank = ranking.getRanks();
+    ASSERT_EQ(pageRank.size(),expectedRank.size());
+
+    for(std::size_t i=0;i<pageRank.size();++i)
+    {
+        EXPECT_EQ(pageRank[i].first,nodeList[i]);
+        EXPECT_NEAR(pageRank[i].second,expectedRank[i].second,1e-3); // Each local step stops within the tolerance
+    }
+
+    EXPECT_GT(ranking.refresh(),0);
+    pageRank = ranking.getRanks();
+
+    for(std::size_t i=0;i<pageRank.size();++i)
+        EXPECT_NEAR(pageRank[i].second,expectedRank[i].second,1e-5); // Both runs stop within the same tolerance of the same ranks
+}
+
+TEST(i2PageRankTest, IncrementalRanksFollowGraphDelta)
+{
+    std::vector<std::shared_ptr<I2::Node>> nodeList = I2::NodeLoader::loadNodesFromFile(RANK_DATA_PATH);
+    I2::IncrementalPageRank ranking(nodeList,I2::PageRankOptions{.tolerance = 1e-6});
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> expectedRank, pageRank;
+    I2::GraphDelta delta;
+
+    // The same kinds of edit as above, as one batch: each is reported to the observers once per direction
+    delta.addLink(nodeList[0],nodeList[5],3);
+    delta.removeLink(nodeList[1],nodeList[1]->getLinks().begin()->first);
+    delta.updateLink(nodeList[11],nodeList[0],9);
+    EXPECT_GT(delta.apply(),0);
+
+    EXPECT_GT(ranking.getPendingCount(),0);
+    EXPECT_GT(ranking.refresh(),0);
+
+    expectedRank = I2::NodeLoader::computePageRank(nodeList,0.85,1e-6);
+    pageRank = ranking.getRanks();
+    ASSERT_EQ(pageRank.size(),expectedRank.size());
+
+    for(std::size_t i=0;i<pageRank.size();++i)
+        EXPECT_NEAR(pageRank[i].second,expectedRank[i].second,1e-5);
+}
+
+TEST(i2PageRankTest, IncrementalEditOnlyTouchesAffectedNodes)
+{
+    // Two separate chains: editing one must not re-evaluate (or change the ranks of) the other
+    std::vector<std::shared_ptr<I2::Node>> nodeList;
+
+    for(int i=0;i<6;++i)
+        nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+    for(int i : {0,1,3,4})
+    {
+        nodeList[i]->addLink(nodeList[i + 1],1);
+        nodeList[i + 1]->addLink(nodeList[i],1);
+    }
+
+    I2::IncrementalPageRank ranking(nodeList,I2::PageRankOptions{.tolerance = 1e-9});
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> before = ranking.getRanks(), after;
+
+    nodeList[0]->addLink(nodeList[2],2);
+    nodeList[2]->addLink(nodeList[0],2);
+
+    EXPECT_EQ(ranking.getPendingCount(),3);
+    EXPECT_GT(ranking.update(),0);
+    after = ranking.getRanks();
+
+    for(int i : {3,4,5})
+        EXPECT_EQ(after[i].second,before[i].second);
+
+    EXPECT_NE(after[1].second,before[1].second);
+    EXPECT_THROW((void)ranking.getRank(std::make_shared<I2::Node>("Other")),std::out_of_range);
+}
+
+TEST(i2PageRankTest, PersonalizedRanksMatchPowerIteration)
+{
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH);
+    const std::vector<I2::NodeId> seeds = {3,7};
+    std::vector<double> expectedScore(graph.getNodeCount(), 0.0), nextScore;
+    std::vector<std::pair<I2::NodeId,double>> related;
+
+    // Reference: iterate the random walk with restarts to the seeds over the whole graph
+    for(int iteration=0;iteration<500;++iteration)
+    {
+        nextScore.assign(graph.getNodeCount(), 0.0);
+
+        for(I2::NodeId seed : seeds)
+            nextScore[seed] += 0.15 / seeds.size();
+
+        for(I2::NodeId i=0;i<graph.getNodeCount();++i)
+        {
+            for(std::size_t e=0;e<graph.getLinkCount(i);++e)
+                nextScore[graph.getNeighbours(i)[e]] += 0.85 * expectedScore[i] * graph.getWeights(i)[e] / graph.getWeightedDegree(i);
+        }
+
+        expectedScore.swap(nextScore);
+    }
+
+    related = I2::NodeLoader::computePersonalizedPageRank(graph,seeds,I2::PersonalizedPageRankOptions{.tolerance = 1e-9, .topK = 0});
+
+    for(std::size_t i=1;i<related.size();++i)
+        EXPECT_GE(related[i - 1].second,related[i].second); // Highest first
+
+    for(const std::pair<I2::NodeId,double> &score : related)
+        EXPECT_NEAR(score.second,expectedScore[score.first],1e-6);
+
+    EXPECT_EQ(I2::NodeLoader::computePersonalizedPageRank(graph,seeds).size(),10); // Top 10 by default
+    EXPECT_THROW((void)I2::NodeLoader::computePersonalizedPageRank(graph,{static_cast<I2::NodeId>(graph.getNodeCount())}),std::out_of_range);
+}
+
+TEST(i2PageRankTest, PersonalizedRankStaysLocal)
+{
+    // Two separate triangles: a query seeded in one must never reach the other
+    std::vector<std::shared_ptr<I2::Node>> nodeList;
+    std::vector<std::pair<std::shared_ptr<I2::Node>,double>> related;
+
+    for(int i=0;i<6;++i)
+        nodeList.push_back(std::make_shared<I2::Node>("Node" + std::to_string(i)));
+
+    for(int i : {0,3})
+    {
+        for(int j=0;j<3;++j)
+        {
+            nodeList[i + j]->addLink(nodeList[i + (j + 1) % 3],1);
+            nodeList[i + (j + 1) % 3]->addLink(nodeList[i + j],1);
+        }
+    }
+
+    related = I2::NodeLoader::computePersonalizedPageRank(nodeList,{nodeList[0]});
+
+    ASSERT_EQ(related.size(),3);
+    EXPECT_EQ(related[0].first,nodeList[0]); // The seed is the most related to itself
+
+    for(std::size_t i=1;i<related.size();++i)
+    {
+        EXPECT_TRUE(related[i].first == nodeList[1] || related[i].first == nodeList[2]);
+        EXPECT_NEAR(related[i].second,related[1].second,1e-3); // Symmetric neighbours: equal to within the push tolerance
+    }
+}
+
+TEST(i2PageRankTest, PoolRunsEveryTaskOnce)
+{
+    I2::WorkStealingPool pool(4);
+    std::vector<int> taskRuns(10000, 0);
+
+    ASSERT_EQ(pool.getThreadCount(),4);
+    pool.parallelFor(taskRuns.size(),[&taskRuns](std::size_t i) { ++taskRuns[i]; }); // Each index is only ever written by the thread running it
+
+    EXPECT_TRUE(std::all_of(taskRuns.cbegin(),taskRuns.cend(),[](int runs) { return runs == 1; }));
+}
+
+TEST(i2PageRankTest, PoolRethrowsTaskError)
+{
+    I2::WorkStealingPool pool(3);
+    std::string error = "";
+
+    try
+    {
+        pool.parallelFor(100,[](std::size_t i) { if(i == 42) throw std::runtime_error("Task failed"); });
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Task failed"); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+}
+
+TEST(i2PageRankTest, EveryInstructionSetRanksIdentically)
+{
+    const I2::Kernels::InstructionSet supported = I2::Kernels::getSupportedInstructionSet();
+
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(RANK_DATA_PATH);
+    std::vector<double> expectedRank;
+
+    I2::Kernels::setInstructionSet(I2::Kernels::InstructionSet::Scalar);
+    expectedRank = I2::NodeLoader::computePageRank(graph,I2::PageRankOptions{.tolerance = 1e-6});
+
+    for(I2::Kernels::InstructionSet instructionSet : {I2::Kernels::InstructionSet::AVX2,I2::Kernels::InstructionSet::AVX512})
+    {
+        if(I2::Kernels::setInstructionSet(instructionSet) != instructionSet)
+            continue; // Not supported by this host
+
+        EXPECT_EQ(I2::NodeLoader::computePageRank(graph,I2::PageRankOptions{.tolerance = 1e-6}),expectedRank) << I2::Kernels::getInstructionSetName(instructionSet);
+    }
+
+    EXPECT_EQ(I2::Kernels::setInstructionSet(supported),supported); // Restore the default dispatch for the remaining tests
+}
+
+TEST(i2PageRankTest, DampenKernelsMatchScalar)
+{
+    const std::size_t count = 37; // Not a multiple of any vector width, so the remainder path is covered
+    const I2::Kernels::InstructionSet supported = I2::Kernels::getSupportedInstructionSet();
+
+    std::vector<double> rank(count), sum(count), normaliser(count), expectedRank, expectedContribution(count);
+    I2::Kernels::Residual expectedResidual;
+
+    for(std::size_t i=0;i<count;++i)
+    {
+        rank[i] = static_cast<double>(i) * 0.37;
+        sum[i] = static_cast<double>((i * 7919) % 101) * 1.3;
+        normaliser[i] = 1.0 / static_cast<double>(i % 5 + 1);
+    }
+
+    I2::Kernels::setInstructionSet(I2::Kernels::InstructionSet::Scalar);
+    expectedRank = sum;
+    expectedResidual = I2::Kernels::dampen(rank.data(),expectedRank.data(),expectedContribution.data(),normaliser.data(),count,0.01,0.85,100.0);
+
+    for(I2::Kernels::InstructionSet instructionSet : {I2::Kernels::InstructionSet::AVX2,I2::Kernels::InstructionSet::AVX512})
+    {
+        std::vector<double> nextRank = sum, contribution(count);
+        I2::Kernels::Residual residual;
+
+        if(I2::Kernels::setInstructionSet(instructionSet) != instructionSet)
+            continue; // Not supported by this host
+
+        residual = I2::Kernels::dampen(rank.data(),nextRank.data(),contribution.data(),normaliser.data(),count,0.01,0.85,100.0);
+
+        EXPECT_EQ(nextRank,expectedRank);
+        EXPECT_EQ(contribution,expectedContribution);
+        EXPECT_EQ(residual.lInf,expectedResidual.lInf);
+        EXPECT_DOUBLE_EQ(residual.l1,expectedResidual.l1); // Summed per lane, so may round differently
+    }
+
+    I2::Kernels::setInstructionSet(supported);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <i2/generator.hpp>
+#include <i2/pageRank.hpp>
+#include <i2/reorder.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace
+{
+    /**
+     * @return A graph built from the links, with the nodes numbered in a shuffled order
+     */
+    I2::Graph shuffledGraph(std::size_t nodeCount, const std::vector<std::pair<std::size_t,std::size_t>> &link, std::vector<I2::NodeId> &id)
+    {
+        I2::GraphBuilder builder;
+        std::vector<std::size_t> node(nodeCount);
+
+        std::iota(node.begin(),node.end(),0);
+        std::shuffle(node.begin(),node.end(),std::mt19937(7));
+        id.resize(nodeCount);
+
+        for(std::size_t i=0;i<nodeCount;++i)
+            id[node[i]] = builder.addNode("Node" + std::to_string(node[i]));
+
+        for(const std::pair<std::size_t,std::size_t> &entry : link)
+            builder.addLink(id[entry.first],id[entry.second],1);
+
+        return builder.build();
+    }
+
+    /**
+     * @return The largest distance between the IDs of two linked nodes
+     */
+    std::size_t bandwidth(const I2::Graph &graph)
+    {
+        std::size_t result = 0;
+
+        for(I2::NodeId i=0;i<graph.getNodeCount();++i)
+        {
+            for(const I2::NodeId target : graph.getNeighbours(i))
+                result = std::max<std::size_t>(result,target > i ? target - i : i - target);
+        }
+
+        return result;
+    }
+}
+
+TEST(i2ReorderTest, ReorderingsKeepEveryLink)
+{
+    const I2::Graph graph = I2::Generator::generateGraph(I2::Generator::Options{.model = I2::Generator::Model::RMAT, .nodeCount = 2000, .linkCount = 10000});
+
+    I2::PageRankEngine engine(graph);
+
+    const std::vector<double> expectedRank = engine.run(I2::PageRankOptions{.tolerance = 1e-10});
+
+    for(const I2::Reorder::Ordering ordering : {I2::Reorder::Ordering::Degree, I2::Reorder::Ordering::ReverseCuthillMcKee, I2::Reorder::Ordering::Community})
+    {
+        const I2::Reorder::Permutation permutation = I2::Reorder::computeOrdering(graph,ordering);
+        const I2::Graph reordered = I2::Reorder::apply(graph,permutation,3);
+
+        ASSERT_EQ(reordered.getNodeCount(),graph.getNodeCount());
+        ASSERT_EQ(reordered.getEntryCount(),graph.getEntryCount());
+
+        for(I2::NodeId i=0;i<reordered.getNodeCount();++i)
+        {
+            const I2::NodeId original = permutation.toOriginal(i);
+
+            std::vector<std::pair<I2::NodeId,std::uint32_t>> expectedRow, row;
+
+            for(std::size_t e=0;e<graph.getLinkCount(original);++e)
+                expectedRow.emplace_back(graph.getNeighbours(original)[e],graph.getWeights(original)[e]);
+
+            for(std::size_t e=0;e<reordered.getLinkCount(i);++e)
+                row.emplace_back(permutation.toOriginal(reordered.getNeighbours(i)[e]),reordered.getWeights(i)[e]);
+
+            std::sort(row.begin(),row.end());
+            EXPECT_EQ(row,expectedRow);
+            EXPECT_TRUE(std::ranges::is_sorted(reordered.getNeighbours(i)));
+            EXPECT_EQ(reordered.getName(i),graph.getName(original));
+            EXPECT_EQ(reordered.getWeightedDegree(i),graph.getWeightedDegree(original));
+            EXPECT_EQ(permutation.toReordered(original),i);
+        }
+
+        // Ranks only differ by the order each row is summed in
+        I2::PageRankEngine reorderedEngine(reordered);
+
+        const std::vector<double> rank = permutation.restore(reorderedEngine.run(I2::PageRankOptions{.tolerance = 1e-10}));
+
+        for(std::size_t i=0;i<rank.size();++i)
+            EXPECT_NEAR(rank[i],expectedRank[i],1e-9);
+    }
+
+    const I2::Reorder::Permutation degreeOrder = I2::Reorder::computeOrdering(graph,I2::Reorder::Ordering::Degree);
+
+    for(I2::NodeId i=1;i<graph.getNodeCount();++i)
+        EXPECT_GE(graph.getLinkCount(degreeOrder.toOriginal(i - 1)),graph.getLinkCount(degreeOrder.toOriginal(i)));
+}
+
+TEST(i2ReorderTest, OrderingsPlaceLinkedNodesTogether)
+{
+    constexpr std::size_t side = 30, cliqueCount = 20, cliqueSize = 10;
+
+    std::vector<std::pair<std::size_t,std::size_t>> gridLink, cliqueLink;
+    std::vector<I2::NodeId> gridId, cliqueId;
+
+    for(std::size_t y=0;y<side;++y)
+    {
+        for(std::size_t x=0;x<side;++x)
+        {
+            if(x + 1 < side)
+                gridLink.emplace_back(y * side + x,y * side + x + 1);
+
+            if(y + 1 < side)
+                gridLink.emplace_back(y * side + x,(y + 1) * side + x);
+        }
+    }
+
+    for(std::size_t c=0;c<cliqueCount;++c)
+    {
+        for(std::size_t i=0;i<cliqueSize;++i)
+        {
+            for(std::size_t j=i + 1;j<cliqueSize;++j)
+                cliqueLink.emplace_back(c * cliqueSize + i,c * cliqueSize + j);
+        }
+
+        cliqueLink.emplace_back(c * cliqueSize,((c + 1) % cliqueCount) * cliqueSize + 1); // A ring of single links between the cliques
+    }
+
+    // Reverse Cuthill-McKee narrows a shuffled grid to a band about as wide as the grid
+    const I2::Graph grid = shuffledGraph(side * side,gridLink,gridId);
+
+    EXPECT_GT(bandwidth(grid),side * side / 2);
+    EXPECT_LT(bandwidth(I2::Reorder::apply(grid,I2::Reorder::computeOrdering(grid,I2::Reorder::Ordering::ReverseCuthillMcKee))),2 * side);
+
+    // Community ordering numbers each clique contiguously
+    const I2::Graph cliques = shuffledGraph(cliqueCount * cliqueSize,cliqueLink,cliqueId);
+    const I2::Reorder::Permutation permutation = I2::Reorder::computeOrdering(cliques,I2::Reorder::Ordering::Community);
+
+    for(std::size_t c=0;c<cliqueCount;++c)
+    {
+        std::vector<I2::NodeId> member;
+
+        for(std::size_t i=0;i<cliqueSize;++i)
+            member.push_back(permutation.toReordered(cliqueId[c * cliqueSize + i]));
+
+        EXPECT_EQ(std::ranges::max(member) - std::ranges::min(member),cliqueSize - 1);
+    }
+}
+
+TEST(i2ReorderTest, PermutationsMapBothWays)
+{
+    const I2::Reorder::Permutation permutation(std::vector<I2::NodeId>{2,0,1}), identity;
+
+    EXPECT_EQ(permutation.toOriginal(0),2);
+    EXPECT_EQ(permutation.toReordered(2),0);
+    EXPECT_EQ(permutation.restore(std::vector<double>{10.0,20.0,30.0}),(std::vector<double>{20.0,30.0,10.0}));
+    EXPECT_TRUE(identity.isIdentity());
+    EXPECT_EQ(identity.toOriginal(5),5);
+    EXPECT_EQ(identity.restore(std::vector<double>{1.0,2.0}),(std::vector<double>{1.0,2.0}));
+
+    EXPECT_THROW(I2::Reorder::Permutation(std::vector<I2::NodeId>{0,0,1}),std::runtime_error);
+    EXPECT_THROW(I2::Reorder::Permutation(std::vector<I2::NodeId>{0,3}),std::runtime_error);
+    EXPECT_THROW((void)I2::Reorder::apply(I2::Graph(),permutation),std::runtime_error);
+}
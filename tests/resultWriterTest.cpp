@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <i2/resultWriter.hpp>
+#include <json/json.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+TEST(i2ResultWriterTest, TextMatchesTheStreamedLayout)
+{
+    std::stringstream output;
+
+    {
+        I2::ResultWriter writer(output);
+
+        writer.beginSection("degree",2,0);
+        writer.writeRow("Valjean",11,158.0);
+        writer.writeRow("Myriel",0,31.0);
+        writer.beginSection("rank",2,2);
+        writer.writeRow("Valjean",11,3.14159);
+        writer.writeRow("Myriel",0,0.005);
+    }
+
+    EXPECT_EQ(output.str(),"Valjean: 158\nMyriel: 31\n\nValjean: 3.14\nMyriel: 0.01\n");
+}
+
+TEST(i2ResultWriterTest, CSVAndJSONLinesQuoteNamesAndRoundTripValues)
+{
+    std::stringstream csv, jsonLines;
+    const double value = 0.1 + 0.2; // Not representable in fewer than 17 digits
+
+    {
+        I2::ResultWriter csvWriter(csv,I2::OutputFormat::CSV), jsonWriter(jsonLines,I2::OutputFormat::JSONLines);
+
+        csvWriter.beginSection("rank",2);
+        csvWriter.writeRow("Plain",0,value);
+        csvWriter.writeRow("Say \"hi\", then\nleave",1,2.0);
+        jsonWriter.beginSection("rank",1);
+        jsonWriter.writeRow("Say \"hi\"\\\n",1,value);
+    }
+
+    EXPECT_EQ(csv.str(),"section,id,node,value\nrank,0,Plain,0.30000000000000004\nrank,1,\"Say \"\"hi\"\", then\nleave\",2\n");
+
+    Json::Value root;
+    Json::CharReaderBuilder readerBuilder;
+    std::string errors;
+
+    ASSERT_TRUE(Json::parseFromStream(readerBuilder,jsonLines,&root,&errors)) << errors;
+    EXPECT_EQ(root["section"].asString(),"rank");
+    EXPECT_EQ(root["id"].asUInt(),1);
+    EXPECT_EQ(root["node"].asString(),"Say \"hi\"\\\n");
+    EXPECT_EQ(root["value"].asDouble(),value);
+}
+
+TEST(i2ResultWriterTest, BinaryPacksCountsAndRecords)
+{
+    std::stringstream output;
+
+    {
+        I2::ResultWriter writer(output,I2::OutputFormat::Binary,16); // A tiny buffer, so rows straddle several writes
+
+        writer.beginSection("degree",3);
+        writer.writeRow("a",7,1.0);
+        writer.writeRow("b",8,2.5);
+        writer.writeRow("c",9,-4.0);
+    }
+
+    const std::string bytes = output.str();
+
+    ASSERT_EQ(bytes.size(),sizeof(std::uint64_t) + 3 * (sizeof(std::uint32_t) + sizeof(double)));
+
+    std::uint64_t count;
+    std::uint32_t id;
+    double value;
+
+    std::memcpy(&count,bytes.data(),sizeof(count));
+    EXPECT_EQ(count,3);
+
+    std::memcpy(&id,bytes.data() + 8 + 12,sizeof(id));
+    std::memcpy(&value,bytes.data() + 8 + 12 + 4,sizeof(value));
+    EXPECT_EQ(id,8);
+    EXPECT_EQ(value,2.5);
+}
+
+TEST(i2ResultWriterTest, WritesToFiles)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "i2ResultWriterTest.txt";
+
+    {
+        I2::ResultWriter writer(path.string());
+
+        writer.beginSection("degree",1);
+        writer.writeRow("Myriel",0,31.0);
+        writer.flush();
+    }
+
+    std::ifstream file(path);
+
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>()),"Myriel: 31\n");
+
+    file.close();
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(I2::ResultWriter((std::filesystem::temp_directory_path() / "missing" / "results.txt").string()),std::runtime_error);
+}
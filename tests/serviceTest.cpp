@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <i2/nodeLoader.hpp>
+#include <i2/service.hpp>
+#include <json/json.h>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Consts used in multiple test functions
+const std::string SERVICE_DATA_PATH = "../resources/data.json";
+
+/**
+ * @return The response parsed back into JSON
+ */
+Json::Value parseResponse(const std::string &response)
+{
+    Json::Value root;
+    Json::CharReaderBuilder readerBuilder;
+    std::string errors;
+    std::istringstream input(response);
+
+    EXPECT_TRUE(Json::parseFromStream(readerBuilder,input,&root,&errors)) << errors;
+
+    return root;
+}
+
+TEST(i2ServiceTest, QueriesMatchTheLibrary)
+{
+    const I2::Graph graph = I2::NodeLoader::loadGraphFromFile(SERVICE_DATA_PATH);
+    const std::vector<double> pageRank = I2::NodeLoader::computePageRank(graph,I2::PageRankOptions());
+    const std::vector<I2::NodeId> topDegree = I2::NodeLoader::topNodesByWeightedDegree(graph,3), topRank = I2::NodeLoader::topNodesByRank(pageRank,3);
+    I2::Service service(graph,I2::ServiceOptions{.rank = {}, .threadCount = 2});
+
+    const Json::Value degreeResponse = parseResponse(service.handle(R"({"op":"top","by":"degree","k":3,"id":7})"));
+    const Json::Value rankResponse = parseResponse(service.handle(R"({"op":"top","by":"rank","k":3})"));
+
+    EXPECT_EQ(degreeResponse["id"].asInt(),7);
+    EXPECT_TRUE(degreeResponse["ok"].asBool());
+    EXPECT_EQ(degreeResponse["epoch"].asUInt64(),0);
+    ASSERT_EQ(degreeResponse["result"].size(),3);
+    ASSERT_EQ(rankResponse["result"].size(),3);
+
+    for(Json::ArrayIndex i=0;i<3;++i)
+    {
+        EXPECT_EQ(degreeResponse["result"][i]["node"].asString(),graph.getName(topDegree[i]));
+        EXPECT_EQ(degreeResponse["result"][i]["degree"].asUInt(),graph.getWeightedDegree(topDegree[i]));
+        EXPECT_EQ(rankResponse["result"][i]["node"].asString(),graph.getName(topRank[i]));
+        EXPECT_EQ(rankResponse["result"][i]["rank"].asDouble(),pageRank[topRank[i]]);
+    }
+
+    EXPECT_EQ(parseResponse(service.handle(R"({"op":"degree","node":"Valjean"})"))["result"].asUInt(),graph.getWeightedDegree(*graph.findNode("Valjean")));
+    EXPECT_EQ(parseResponse(service.handle(R"({"op":"rank","node":"Napoleon"})"))["result"].asDouble(),pageRank[*graph.findNode("Napoleon")]);
+    EXPECT_EQ(service.handle(R"({"op":"top","by":"degree","k":3,"id":7})"),service.handle(R"({"op":"top","by":"degree","k":3,"id":7})")); // Cached
+}
+
+TEST(i2ServiceTest, WritesPublishNewVersions)
+{
+    const I2::Graph graph = I2::NodeLoader::loadGraphFromFile(SERVICE_DATA_PATH);
+    const std::uint32_t napoleonDegree = graph.getWeightedDegree(*graph.findNode("Napoleon"));
+    I2::Service service(graph);
+
+    EXPECT_EQ(parseResponse(service.handle(R"({"op":"degree","node":"Napoleon"})"))["result"].asUInt(),napoleonDegree); // Cached at epoch 0
+    EXPECT_TRUE(parseResponse(service.handle(R"({"op":"addNode","node":"Added"})"))["ok"].asBool());
+
+    const Json::Value linkResponse = parseResponse(service.handle(R"({"op":"addLink","source":"Napoleon","target":"Added","weight":5})"));
+
+    EXPECT_TRUE(linkResponse["ok"].asBool());
+    EXPECT_EQ(linkResponse["epoch"].asUInt64(),2);
+    EXPECT_EQ(service.getEpoch(),2);
+    EXPECT_EQ(parseResponse(service.handle(R"({"op":"degree","node":"Napoleon"})"))["result"].asUInt(),napoleonDegree + 5); // Not the cached result
+    EXPECT_EQ(parseResponse(service.handle(R"({"op":"degree","node":"Added"})"))["result"].asUInt(),5);
+    EXPECT_GT(parseResponse(service.handle(R"({"op":"recompute"})"))["result"].asUInt64(),0);
+
+    EXPECT_TRUE(parseResponse(service.handle(R"({"op":"removeLink","source":"Added","target":"Napoleon"})"))["ok"].asBool());
+    EXPECT_EQ(parseResponse(service.handle(R"({"op":"degree","node":"Napoleon"})"))["result"].asUInt(),napoleonDegree);
+}
+
+TEST(i2ServiceTest, ErrorsAreReported)
+{
+    I2::Service service(I2::NodeLoader::loadGraphFromFile(SERVICE_DATA_PATH));
+
+    for(const char *request : {"not json", R"({"id":1})", R"({"op":"fly"})", R"({"op":"rank","node":"Nobody"})", R"({"op":"top","k":-1})", R"({"op":"addNode","node":"Valjean"})", R"({"op":"addLink","source":"Valjean","target":"Valjean"})"})
+    {
+        const Json::Value response = parseResponse(service.handle(request));
+
+        EXPECT_FALSE(response["ok"].asBool()) << request;
+        EXPECT_EQ(response["error"].asString().rfind("Error: ",0),0) << request;
+    }
+
+    EXPECT_EQ(service.getEpoch(),0);
+}
+
+TEST(i2ServiceTest, StreamAnswersEveryRequestAndSeesItsOwnWrites)
+{
+    I2::Service service(I2::NodeLoader::loadGraphFromFile(SERVICE_DATA_PATH),I2::ServiceOptions{.rank = {}, .threadCount = 4});
+    std::stringstream input, output;
+    std::map<int,Json::Value> response;
+    std::string line;
+
+    for(int i=0;i<50;++i)
+        input << R"({"op":"top","by":"rank","k":5,"id":)" << i << "}\n";
+
+    input << R"({"op":"addLink","source":"Napoleon","target":"Valjean","weight":9,"id":50})" << "\n\n"; // Blank lines are ignored
+    input << R"({"op":"degree","node":"Napoleon","id":51})" << "\n";
+    input << R"({"op":"shutdown","id":52})" << "\n";
+    input << R"({"op":"degree","node":"Napoleon","id":53})" << "\n"; // Not read: the service has shut down
+
+    service.serve(input,output);
+
+    while(std::getline(output,line))
+    {
+        const Json::Value parsed = parseResponse(line);
+
+        response[parsed["id"].asInt()] = parsed;
+    }
+
+    ASSERT_EQ(response.size(),53);
+    EXPECT_EQ(response[0]["result"],response[49]["result"]);
+    EXPECT_EQ(response[49]["epoch"].asUInt64(),0);
+    EXPECT_EQ(response[51]["epoch"].asUInt64(),1);
+    EXPECT_EQ(response[51]["result"].asUInt(),10); // Napoleon's single link of weight 1, plus the new link
+}
+
+#ifndef _WIN32
+TEST(i2ServiceTest, SocketAnswersRequests)
+{
+    const std::string socketPath = (std::filesystem::temp_directory_path() / "i2ServiceTest.sock").string();
+    I2::Service service(I2::NodeLoader::loadGraphFromFile(SERVICE_DATA_PATH),I2::ServiceOptions{.rank = {}, .threadCount = 2});
+    std::thread server([&](void) { service.serveSocket(socketPath); });
+    sockaddr_un address{};
+    int client = -1;
+    std::string received;
+    char buffer[4096];
+
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path,socketPath.size());
+
+    for(int attempt=0;attempt<100;++attempt) // Wait for the server to start listening
+    {
+        client = ::socket(AF_UNIX,SOCK_STREAM,0);
+
+        if(!::connect(client,reinterpret_cast<const sockaddr*>(&address),sizeof(address)))
+            break;
+
+        ::close(client);
+        client = -1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_GE(client,0);
+
+    const std::string request = R"({"op":"degree","node":"Valjean","id":1})" "\n" R"({"op":"shutdown","id":2})" "\n";
+
+    ASSERT_EQ(::send(client,request.data(),request.size(),0),static_cast<ssize_t>(request.size()));
+
+    for(ssize_t count=0;(count = ::recv(client,buffer,sizeof(buffer),0)) > 0;) // The server closes the connection once it has shut down
+        received.append(buffer,static_cast<std::size_t>(count));
+
+    ::close(client);
+    server.join();
+
+    std::istringstream lines(received);
+    std::string line;
+
+    ASSERT_TRUE(std::getline(lines,line));
+    EXPECT_EQ(parseResponse(line)["result"].asUInt(),158);
+    ASSERT_TRUE(std::getline(lines,line));
+    EXPECT_EQ(parseResponse(line)["id"].asInt(),2);
+    EXPECT_FALSE(std::filesystem::exists(socketPath));
+}
+#endif
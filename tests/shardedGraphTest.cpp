@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <i2/edgeList.hpp>
+#include <i2/generator.hpp>
+#include <i2/pageRank.hpp>
+#include <i2/shardedGraph.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    /**
+     * @return A path within the temporary directory, unique to the calling test
+     */
+    std::string shardedGraphTestPath(const std::string &extension)
+    {
+        return (std::filesystem::temp_directory_path() / (std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) + extension)).string();
+    }
+
+    void writeFile(const std::string &path, const std::string &content)
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+
+        output << content;
+    }
+
+    void expectSameRows(const I2::ShardedGraph &actual, const I2::Graph &expected)
+    {
+        I2::ShardedGraph::Block block;
+        I2::NodeId nextNode = 0;
+
+        ASSERT_EQ(actual.getNodeCount(),expected.getNodeCount());
+        ASSERT_EQ(actual.getEntryCount(),expected.getEntryCount());
+        EXPECT_TRUE(std::ranges::equal(actual.getWeightedDegrees(),expected.getLayout().weightedDegree));
+
+        for(std::size_t b=0;b<actual.getBlockCount();++b)
+        {
+            actual.readBlock(b,block);
+            ASSERT_EQ(block.begin,nextNode);
+
+            for(I2::NodeId i=block.begin;i<block.end;++i)
+            {
+                const std::uint64_t begin = block.offset[i - block.begin], end = block.offset[i - block.begin + 1];
+
+                EXPECT_TRUE(std::ranges::equal(std::span(block.target).subspan(begin,end - begin),expected.getNeighbours(i)));
+                EXPECT_TRUE(std::ranges::equal(std::span(block.weight).subspan(begin,end - begin),expected.getWeights(i)));
+            }
+
+            nextNode = block.end;
+        }
+
+        EXPECT_EQ(nextNode,expected.getNodeCount());
+    }
+
+    std::string shardError(const std::string &path, const I2::EdgeList::Options &options, const I2::ShardOptions &shardOptions = I2::ShardOptions())
+    {
+        try
+        {
+            (void)I2::ShardedGraph::fromEdgeList(path,options,shardOptions);
+        }
+        catch(const std::runtime_error &e)
+        {
+            return e.what();
+        }
+
+        return "";
+    }
+}
+
+TEST(i2ShardedGraphTest, OutOfCoreRanksMatchTheInMemoryEngine)
+{
+    const std::string path = shardedGraphTestPath(".bin");
+    const I2::Generator::Options generatorOptions{.model = I2::Generator::Model::BarabasiAlbert, .nodeCount = 20000, .linkCount = 100000};
+
+    {
+        std::ofstream output(path,std::ios::binary | std::ios::trunc);
+
+        I2::Generator::writeBinary(generatorOptions,output);
+    }
+
+    const I2::Graph graph = I2::EdgeList::loadBinary(path);
+    const I2::ShardedGraph shardedGraph = I2::ShardedGraph::fromEdgeList(path,I2::EdgeList::Options(),I2::ShardOptions{.memoryBudget = 1 << 20}); // Forces many blocks
+
+    EXPECT_GT(shardedGraph.getBlockCount(),4);
+    expectSameRows(shardedGraph,graph);
+
+    for(const I2::StoppingRule stoppingRule : {I2::StoppingRule::MaxNorm, I2::StoppingRule::L1})
+    {
+        const I2::PageRankOptions options{.tolerance = 1e-8, .recordResiduals = true, .stoppingRule = stoppingRule};
+
+        I2::PageRankEngine engine(graph);
+        I2::OutOfCorePageRank outOfCore(shardedGraph);
+
+        const std::vector<double> expectedRank = engine.run(options);
+
+        EXPECT_EQ(outOfCore.run(options),expectedRank); // Bit-identical
+        EXPECT_EQ(outOfCore.getIterationCount(),engine.getIterationCount());
+        EXPECT_EQ(outOfCore.getResidualHistory().back().l1,engine.getResidualHistory().back().l1);
+        EXPECT_TRUE(outOfCore.hasConverged());
+
+        EXPECT_EQ(outOfCore.run(I2::PageRankOptions{.tolerance = 1e-8, .threadCount = 3, .stoppingRule = stoppingRule}),expectedRank);
+        EXPECT_EQ(outOfCore.run(options,expectedRank),engine.run(options,expectedRank)); // Warm started from the answer
+        EXPECT_EQ(outOfCore.getIterationCount(),1);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(i2ShardedGraphTest, TextEdgeListsFollowTheLoaderRules)
+{
+    const std::string path = shardedGraphTestPath(".csv"), namesPath = shardedGraphTestPath(".names");
+    std::vector<I2::NodeId> id{3,0,3};
+
+    writeFile(namesPath,"Alpha\nBeta\r\nGamma\nDelta\n");
+    writeFile(path,"source,target,weight\n0,1,2\n# comment\n1,0,5\n2,3,1\n3,2,4\n0,3");
+
+    for(const I2::DuplicatePolicy policy : {I2::DuplicatePolicy::KeepFirst, I2::DuplicatePolicy::SumWeights, I2::DuplicatePolicy::MaxWeight})
+    {
+        const I2::EdgeList::Options options{.namesPath = namesPath, .duplicatePolicy = policy};
+        const I2::ShardedGraph shardedGraph = I2::ShardedGraph::fromEdgeList(path,options);
+
+        expectSameRows(shardedGraph,I2::EdgeList::loadText(path,options));
+        EXPECT_EQ(shardedGraph.getNames(id),(std::vector<std::string>{"Delta","Alpha","Delta"}));
+    }
+
+    EXPECT_EQ(I2::ShardedGraph::fromEdgeList(path).getNames(id),(std::vector<std::string>{"3","0","3"})); // Named by ID without a sidecar
+
+    // Errors match the in-memory loader's
+    EXPECT_EQ(shardError(path,I2::EdgeList::Options{.duplicatePolicy = I2::DuplicatePolicy::Reject}),"Duplicate link at index '1'.");
+
+    writeFile(path,"0,1,1\n1,4,1\n2,x,1\n");
+    EXPECT_EQ(shardError(path,I2::EdgeList::Options{.namesPath = namesPath}),"Invalid link at index '1'."); // Node 4 does not exist: reported before the malformed link
+    EXPECT_EQ(shardError(path,I2::EdgeList::Options()),"Invalid link at index '2'.");
+
+    writeFile(path,"0,1,1\n");
+    EXPECT_NE(shardError(path,I2::EdgeList::Options(),I2::ShardOptions{.memoryBudget = 1024}),""); // Too small to rank
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(namesPath);
+}
+
+TEST(i2ShardedGraphTest, FilesAreRemovedWithTheGraph)
+{
+    const std::string path = shardedGraphTestPath(".csv"), directory = shardedGraphTestPath("");
+
+    writeFile(path,"0,1,1\n1,2,1\n");
+    std::filesystem::create_directory(directory);
+
+    {
+        I2::ShardedGraph shardedGraph = I2::ShardedGraph::fromEdgeList(path,I2::EdgeList::Options(),I2::ShardOptions{.directory = directory});
+        const I2::ShardedGraph movedGraph = std::move(shardedGraph);
+
+        EXPECT_EQ(movedGraph.getBlockCount(),1);
+        EXPECT_FALSE(std::filesystem::is_empty(directory));
+        EXPECT_THROW((void)I2::OutOfCorePageRank(movedGraph).run(I2::PageRankOptions{.acceleration = I2::Acceleration::GaussSeidel}),std::runtime_error);
+    }
+
+    EXPECT_TRUE(std::filesystem::is_empty(directory));
+
+    std::filesystem::remove(directory);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <i2/nodeLoader.hpp>
+#include <i2/snapshot.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+// Consts used in multiple test functions
+const std::string SNAPSHOT_DATA_PATH = "../resources/data.json";
+
+/**
+ * @return A path within the temporary directory, unique to the calling test
+ */
+std::string snapshotTestPath(void)
+{
+    return (std::filesystem::temp_directory_path() / (std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) + ".i2graph")).string();
+}
+
+TEST(i2SnapshotTest, RoundTripMatchesLoadedGraph)
+{
+    const std::string snapshotPath = snapshotTestPath();
+
+    I2::Graph graph = I2::NodeLoader::loadGraphFromFile(SNAPSHOT_DATA_PATH), mapped;
+
+    ASSERT_NO_THROW(I2::Snapshot::saveToFile(graph,snapshotPath));
+    ASSERT_TRUE(I2::Snapshot::isSnapshotFile(snapshotPath));
+    ASSERT_FALSE(I2::Snapshot::isSnapshotFile(SNAPSHOT_DATA_PATH));
+    ASSERT_NO_THROW(mapped = I2::Snapshot::loadFromFile(snapshotPath));
+
+    ASSERT_EQ(mapped.getNodeCount(),graph.getNodeCount());
+    ASSERT_EQ(mapped.getEntryCount(),graph.getEntryCount());
+
+    for(I2::NodeId i=0;i<graph.getNodeCount();++i)
+    {
+        EXPECT_EQ(mapped.getName(i),graph.getName(i));
+        EXPECT_EQ(mapped.getWeightedDegree(i),graph.getWeightedDegree(i));
+        EXPECT_TRUE(std::ranges::equal(mapped.getNeighbours(i),graph.getNeighbours(i)));
+        EXPECT_TRUE(std::ranges::equal(mapped.getWeights(i),graph.getWeights(i)));
+        EXPECT_EQ(mapped.findNode(graph.getName(i)),i); // The mapped graph indexes its names on first use
+    }
+
+    EXPECT_EQ(I2::NodeLoader::computePageRank(mapped),I2::NodeLoader::computePageRank(graph)); // Identical arrays must rank identically
+
+    mapped = I2::Graph(); // Release the mapping before removing the file
+    std::filesystem::remove(snapshotPath);
+}
+
+TEST(i2SnapshotTest, LoaderDetectsSnapshotFormat)
+{
+    const std::string snapshotPath = snapshotTestPath();
+
+    std::vector<std::shared_ptr<I2::Node>> expected = I2::NodeLoader::loadNodesFromFile(SNAPSHOT_DATA_PATH), nodeList;
+
+    I2::Snapshot::saveToFile(I2::NodeLoader::loadGraphFromFile(SNAPSHOT_DATA_PATH),snapshotPath);
+    EXPECT_NO_THROW(nodeList = I2::NodeLoader::loadNodesFromFile(snapshotPath)); // Should be detected as a snapshot rather than parsed as JSON
+    ASSERT_EQ(nodeList.size(),expected.size());
+
+    for(std::size_t i=0;i<nodeList.size();++i)
+    {
+        EXPECT_EQ(nodeList[i]->getName(),expected[i]->getName());
+        EXPECT_EQ(nodeList[i]->getWeightedDegree(),expected[i]->getWeightedDegree());
+    }
+
+    std::filesystem::remove(snapshotPath);
+}
+
+TEST(i2SnapshotTest, ErrorIsThrownWhenSnapshotIsTruncated)
+{
+    const std::string snapshotPath = snapshotTestPath();
+    std::string error = "";
+
+    I2::Snapshot::saveToFile(I2::NodeLoader::loadGraphFromFile(SNAPSHOT_DATA_PATH),snapshotPath);
+    std::filesystem::resize_file(snapshotPath,std::filesystem::file_size(snapshotPath) / 2);
+
+    try
+    {
+        (void)I2::Snapshot::loadFromFile(snapshotPath);
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Error: snapshot '" + snapshotPath + "' is truncated."); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+    std::filesystem::remove(snapshotPath);
+}
+
+TEST(i2SnapshotTest, ErrorIsThrownWhenHeaderCountIsOversized)
+{
+    const std::string snapshotPath = snapshotTestPath();
+    const std::uint64_t nodeCount = 1000, entryCount = std::uint64_t(1) << 62; // Entry sizes wrap to small values if multiplied unchecked
+    std::string error = "";
+
+    I2::Snapshot::saveToFile(I2::NodeLoader::loadGraphFromFile(SNAPSHOT_DATA_PATH),snapshotPath);
+
+    { // Overwrite the node and entry counts, which follow the magic, version and byte order
+        std::fstream file(snapshotPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(16);
+        file.write(reinterpret_cast<const char*>(&nodeCount),sizeof(nodeCount));
+        file.write(reinterpret_cast<const char*>(&entryCount),sizeof(entryCount));
+    }
+
+    try
+    {
+        (void)I2::Snapshot::loadFromFile(snapshotPath);
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Error: snapshot '" + snapshotPath + "' is truncated."); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+    std::filesystem::remove(snapshotPath);
+}
+
+TEST(i2SnapshotTest, ErrorIsThrownWhenArraysAreCorrupt)
+{
+    const std::string snapshotPath = snapshotTestPath();
+    const I2::Graph graph = I2::NodeLoader::loadGraphFromFile(SNAPSHOT_DATA_PATH);
+    const std::uint64_t badOffset = graph.getEntryCount() + 1;
+    const I2::NodeId badTarget = static_cast<I2::NodeId>(graph.getNodeCount());
+    const std::streamoff targetPosition = 64 + 2 * static_cast<std::streamoff>((graph.getNodeCount() + 1) * sizeof(std::uint64_t)); // After the header and both offset arrays, whose sizes are already aligned
+
+    // An offset past the last entry, then a target past the last node
+    for(const std::pair<std::streamoff,std::string> &corruption : {std::make_pair(std::streamoff(64 + 8),std::string(reinterpret_cast<const char*>(&badOffset),sizeof(badOffset))),
+                                                                  std::make_pair(targetPosition,std::string(reinterpret_cast<const char*>(&badTarget),sizeof(badTarget)))})
+    {
+        std::string error = "";
+
+        I2::Snapshot::saveToFile(graph,snapshotPath);
+
+        {
+            std::fstream file(snapshotPath, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(corruption.first);
+            file.write(corruption.second.data(),static_cast<std::streamsize>(corruption.second.size()));
+        }
+
+        EXPECT_NO_THROW((void)I2::Snapshot::loadFromFile(snapshotPath)); // The arrays are only read when validating
+
+        try
+        {
+            (void)I2::Snapshot::loadFromFile(snapshotPath,true);
+        }
+        catch(const std::runtime_error &e)
+        {
+            error = e.what();
+        }
+
+        EXPECT_EQ(error,"Error: snapshot '" + snapshotPath + "' is corrupt.");
+        std::filesystem::remove(snapshotPath);
+    }
+}
+
+TEST(i2SnapshotTest, ErrorIsThrownWhenVersionIsUnsupported)
+{
+    const std::string snapshotPath = snapshotTestPath();
+    const std::uint32_t futureVersion = I2::Snapshot::formatVersion + 1;
+    std::string error = "";
+
+    I2::Snapshot::saveToFile(I2::NodeLoader::loadGraphFromFile(SNAPSHOT_DATA_PATH),snapshotPath);
+
+    { // Overwrite the version, which follows the 8 magic bytes
+        std::fstream file(snapshotPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8);
+        file.write(reinterpret_cast<const char*>(&futureVersion),sizeof(futureVersion));
+    }
+
+    try
+    {
+        (void)I2::Snapshot::loadFromFile(snapshotPath);
+    }
+    catch(const std::runtime_error &e)
+    {
+        error = e.what();
+    }
+
+    EXPECT_EQ(error,"Error: snapshot '" + snapshotPath + "' has unsupported version " + std::to_string(futureVersion) + "."); // Testing outside of the catch, because if the error is not thrown then the catch will not be executed
+    std::filesystem::remove(snapshotPath);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <i2/stats.hpp>
+#include <json/json.h>
+#include <memory>
+#include <sstream>
+
+TEST(i2StatsTest, RecorderTimesPhasesInOrder)
+{
+    I2::Stats::Recorder recorder;
+    const std::vector<I2::Kernels::Residual> residual{{2.0, 0.5}, {0.1, 0.01}};
+
+    {
+        const I2::Stats::Recorder::ScopedPhase phase = recorder.time("first");
+        const double cpuStart = I2::Stats::getCPUSeconds();
+
+        while(I2::Stats::getCPUSeconds() == cpuStart); // Spin until the CPU clock ticks, so the phase has a measurable cost
+    }
+
+    {
+        const I2::Stats::Recorder::ScopedPhase phase = recorder.time("second");
+    }
+
+    recorder.recordRanking(residual.size(),residual);
+
+    const I2::Stats::Report &report = recorder.finish();
+
+    ASSERT_EQ(report.phase.size(),2);
+    EXPECT_EQ(report.phase[0].name,"first");
+    EXPECT_EQ(report.phase[1].name,"second");
+    EXPECT_GT(report.phase[0].wallSeconds,0.0);
+    EXPECT_GT(report.phase[0].cpuSeconds,0.0);
+    EXPECT_EQ(report.iterationCount,2);
+    EXPECT_EQ(report.residual.size(),2);
+    EXPECT_GT(report.peakRSS,0);
+}
+
+TEST(i2StatsTest, DisabledRecorderRecordsNothing)
+{
+    I2::Stats::Recorder recorder(false);
+    const std::vector<I2::Kernels::Residual> residual{{1.0, 1.0}};
+
+    {
+        const I2::Stats::Recorder::ScopedPhase phase = recorder.time("ignored");
+    }
+
+    recorder.recordRanking(residual.size(),residual);
+
+    const I2::Stats::Report &report = recorder.finish();
+
+    EXPECT_TRUE(report.phase.empty());
+    EXPECT_EQ(report.iterationCount,0);
+    EXPECT_TRUE(report.residual.empty());
+    EXPECT_EQ(report.peakRSS,0);
+}
+
+TEST(i2StatsTest, ReportIsWrittenAsJSON)
+{
+    I2::Stats::Report report;
+    std::stringstream output;
+    Json::Value root;
+    Json::CharReaderBuilder readerBuilder;
+    std::string errors;
+
+    report.phase.push_back(I2::Stats::Phase{"load", 1.5, 1.25, 42});
+    report.iterationCount = 1;
+    report.residual.push_back(I2::Kernels::Residual{0.5, 0.25});
+    report.peakRSS = 1024;
+
+    I2::Stats::writeJSON(report,output);
+
+    ASSERT_TRUE(Json::parseFromStream(readerBuilder,output,&root,&errors)) << errors;
+    ASSERT_EQ(root["phases"].size(),1);
+    EXPECT_EQ(root["phases"][0]["name"].asString(),"load");
+    EXPECT_EQ(root["phases"][0]["wallSeconds"].asDouble(),1.5);
+    EXPECT_EQ(root["phases"][0]["cpuSeconds"].asDouble(),1.25);
+    EXPECT_EQ(root["phases"][0]["allocations"].asUInt64(),42);
+    EXPECT_EQ(root["iterations"].asUInt64(),1);
+    EXPECT_EQ(root["residuals"][0]["l1"].asDouble(),0.5);
+    EXPECT_EQ(root["residuals"][0]["lInf"].asDouble(),0.25);
+    EXPECT_EQ(root["peakRSSBytes"].asUInt64(),1024);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <i2/versionedGraph.hpp>
+#include <i2/nodeLoader.hpp>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+// Consts used in multiple test functions
+const std::string VERSION_DATA_PATH = "../resources/data.json";
+
+TEST(i2VersionedGraphTest, PublishedVersionMatchesBuiltGraph)
+{
+    I2::VersionedGraph versions(I2::NodeLoader::loadGraphFromFile(VERSION_DATA_PATH));
+    I2::GraphBuilder builder;
+    const I2::Graph original = versions.pin()->graph;
+
+    // The expected result: the original links, less 0-1, plus 2-5 and a link to a new node
+    for(I2::NodeId i=0;i<original.getNodeCount();++i)
+    {
+        builder.addNode(original.getName(i));
+
+        for(std::size_t e=0;e<original.getLinkCount(i);++e)
+        {
+            const I2::NodeId neighbour = original.getNeighbours(i)[e];
+
+            if(i < neighbour && !(i == 0 && neighbour == 1))
+                builder.addLink(i,neighbour,original.getWeights(i)[e]);
+        }
+    }
+
+    const I2::NodeId added = builder.addNode("Added");
+
+    builder.addLink(2,5,3);
+    builder.addLink(added,11,2);
+
+    EXPECT_EQ(versions.addNode("Added"),added);
+    versions.addLink(0,1,100); // Already linked: keeps its weight, then is removed below
+    versions.removeLink(1,0);
+    versions.addLink(2,5,3);
+    versions.addLink(5,2,7); // Now a duplicate: keeps the first weight
+    versions.addLink(added,11,2);
+    versions.removeLink(3,4); // Never linked: ignored
+    EXPECT_EQ(versions.getPendingCount(),7);
+    EXPECT_EQ(versions.pin()->graph.getNodeCount(),original.getNodeCount()); // Nothing is visible until published
+
+    EXPECT_EQ(versions.publish(),1);
+    EXPECT_EQ(versions.getPendingCount(),0);
+    EXPECT_EQ(versions.publish(),1); // Nothing staged: no new version
+
+    const std::shared_ptr<const I2::VersionedGraph::Version> version = versions.pin();
+    const I2::Graph expected = builder.build();
+
+    ASSERT_EQ(version->graph.getNodeCount(),expected.getNodeCount());
+    ASSERT_EQ(version->graph.getEntryCount(),expected.getEntryCount());
+    EXPECT_EQ(version->graph.findNode("Added"),added);
+
+    for(I2::NodeId i=0;i<expected.getNodeCount();++i)
+    {
+        EXPECT_EQ(version->graph.getName(i),expected.getName(i));
+        EXPECT_TRUE(std::ranges::equal(version->graph.getNeighbours(i),expected.getNeighbours(i)));
+        EXPECT_TRUE(std::ranges::equal(version->graph.getWeights(i),expected.getWeights(i)));
+        EXPECT_EQ(version->graph.getWeightedDegree(i),expected.getWeightedDegree(i));
+    }
+}
+
+TEST(i2VersionedGraphTest, PinnedVersionsAreReclaimedOnRelease)
+{
+    I2::VersionedGraph versions;
+    std::shared_ptr<const I2::VersionedGraph::Version> pinned;
+
+    versions.addNode("Node1");
+    versions.addNode("Node2");
+    versions.publish();
+
+    pinned = versions.pin(); // Epoch 1: one node pair, unlinked
+    EXPECT_EQ(versions.getLiveVersionCount(),1); // Epoch 0 was not pinned, so was reclaimed on publish
+
+    versions.addLink(0,1,4);
+    versions.publish();
+
+    EXPECT_EQ(versions.getLiveVersionCount(),2);
+    EXPECT_EQ(pinned->epoch,1);
+    EXPECT_EQ(pinned->graph.getEntryCount(),0); // The pinned version is unchanged
+    EXPECT_EQ(versions.pin()->graph.getEntryCount(),2);
+
+    pinned.reset();
+    EXPECT_EQ(versions.getLiveVersionCount(),1);
+}
+
+TEST(i2VersionedGraphTest, ErrorIsThrownWhenStagingInvalidLink)
+{
+    I2::VersionedGraph versions;
+
+    versions.addNode("Node1");
+
+    EXPECT_THROW(versions.addLink(0,1,1),std::runtime_error); // Node 1 does not exist
+    EXPECT_THROW(versions.addLink(0,0,1),std::runtime_error); // Self links are not allowed by default
+    EXPECT_EQ(versions.getPendingCount(),1);
+}
+
+TEST(i2VersionedGraphTest, ReadersSeeConsistentVersionsDuringWrites)
+{
+    constexpr I2::NodeId nodeCount = 200;
+    constexpr std::uint64_t publishCount = 50;
+
+    I2::VersionedGraph versions;
+
+    for(I2::NodeId i=0;i<nodeCount;++i)
+        versions.addNode("Node" + std::to_string(i));
+
+    versions.publish();
+
+    std::thread writer([&]() {
+        for(std::uint64_t epoch=2;epoch<=publishCount + 1;++epoch)
+        {
+            for(I2::NodeId i=0;i<nodeCount;++i) // Every version holds a ring of nodeCount links of weight 1, rotated each epoch
+            {
+                versions.removeLink(i,static_cast<I2::NodeId>((i + epoch - 1) % nodeCount));
+                versions.addLink(i,static_cast<I2::NodeId>((i + epoch) % nodeCount),1);
+            }
+
+            versions.publish();
+        }
+    });
+
+    std::uint64_t lastEpoch = 0;
+
+    while(lastEpoch < publishCount + 1)
+    {
+        const std::shared_ptr<const I2::VersionedGraph::Version> version = versions.pin();
+        const std::vector<double> pageRank = I2::NodeLoader::computePageRank(version->graph,I2::PageRankOptions{.tolerance = 1e-6});
+
+        ASSERT_GE(version->epoch,lastEpoch); // Versions only move forward
+        lastEpoch = version->epoch;
+
+        if(version->epoch > 1)
+        { // A whole ring: every node has two links, so the ranks are uniform
+            ASSERT_EQ(version->graph.getEntryCount(),nodeCount * 2);
+
+            for(I2::NodeId i=0;i<nodeCount;++i)
+                ASSERT_EQ(version->graph.getWeightedDegree(i),2);
+
+            EXPECT_NEAR(*std::max_element(pageRank.cbegin(),pageRank.cend()),*std::min_element(pageRank.cbegin(),pageRank.cend()),1e-9);
+        }
+    }
+
+    writer.join();
+    EXPECT_EQ(versions.getLiveVersionCount(),1);
+}